@@ -0,0 +1,54 @@
+#pragma once
+/*
+ *  ActivityController.h
+ *
+ *  Lowers the camera frame rate when nobody has been tracked for a
+ *  while and restores it as soon as a person shows up again. Keeps
+ *  track of how long the system has spent in each mode.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "BoxSource.h"
+#include <atomic>
+
+// Time without any tracked people before switching to idle mode
+#define IDLE_TIMEOUT_MS 30000
+
+// Minimum time to stay in active mode after waking up, so that a single
+// person walking through does not make the camera flip back and forth
+#define MIN_ACTIVE_MS   10000
+
+// Frame rate used while idle
+#define IDLE_FRAME_RATE 1.0
+
+// Activity modes
+#define MODE_ACTIVE 0
+#define MODE_IDLE   1
+#define NUM_MODES   2
+
+class ActivityController {
+    public:
+        ActivityController(BoxSource* cam);
+
+        void Update(int numTracks, long long nowMs);
+        int GetMode(void);
+        int GetPollInterval(void);
+        long long GetTimeInMode(int mode);
+        int GetModeSwitches(void);
+
+    private:
+        BoxSource* mCam;
+        std::atomic<int> mode;
+        std::atomic<int> modeSwitches;
+
+        // Total time spent in each mode in ms
+        std::atomic<long long> timeInMode[NUM_MODES];
+
+        long long lastUpdateMs;
+        long long lastActivityMs;
+        long long modeStartMs;
+
+        void SwitchMode(int newMode, long long nowMs);
+};
@@ -0,0 +1,143 @@
+#pragma once
+/*
+ *  BoxSource.h
+ *
+ *  Abstract class for anything that delivers inference bounding boxes
+ *  to the PeopleCounter. Implemented by the real camera (HikerCam) and
+ *  by the simulated camera (SimCam).
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include "ImageView.h"
+#include "ThreadControl.h"
+#include "FrameListener.h"
+#include "Clock.h"
+#include <atomic>
+#include <vector>
+
+class CameraEvents;
+
+class BoxSource {
+    public:
+        BoxSource() : frameListener(NULL), clock(GetSteadyClock()), frameTimeoutMs(0), lastFrameUs(-1),
+                      firstFrameUs(-1) {}
+        virtual ~BoxSource() {}
+
+        virtual int InitCamera(void) = 0;
+
+        /*
+         * Releases the camera so that InitCamera can set it up again from
+         * scratch, after acquisition stopped because of a fault.
+         */
+        virtual void CloseCamera(void) {}
+
+        /*
+         * Delivers frames until EndAcquisition is called, returning 0, or
+         * until the camera fails or no frame has come for the frame
+         * timeout, returning -1.
+         */
+        virtual int StartAcquisition(void) = 0;
+        virtual void EndAcquisition(void) = 0;
+        virtual void GetBoundingBoxData(std::vector<Spinnaker::InferenceBoundingBox>& buf) = 0;
+
+        /*
+         * Same as GetBoundingBoxData, but also returns the image the boxes
+         * were found in, which stays valid until the next call. Sources
+         * without images leave the image data NULL.
+         */
+        virtual void GetFrameData(std::vector<Spinnaker::InferenceBoundingBox>& buf, ImageView& img) {
+            GetBoundingBoxData(buf);
+            img.data = NULL;
+        }
+
+        /*
+         * Change the rate at which new frames (and therefore new inference
+         * results) are produced. Passing 0 restores the default behaviour
+         * of triggering a new frame as soon as each inference completes.
+         * The rate holds when the camera is closed and set up again.
+         */
+        virtual int SetFrameRate(double fps) = 0;
+
+        /*
+         * How late the acquisition thread woke up for each frame, or NULL
+         * if the source doesn't measure it.
+         */
+        virtual WakeupJitter* GetWakeupJitter(void) {
+            return NULL;
+        }
+
+        /*
+         * How long each frame spent on the camera before it arrived, from
+         * the events the camera sends, or NULL if the source has none.
+         */
+        virtual CameraEvents* GetCameraEvents(void) {
+            return NULL;
+        }
+
+        /*
+         * Tells the listener every time a new frame's boxes are published,
+         * for pipelines that wait for frames instead of polling for them.
+         * Must be set before StartAcquisition.
+         */
+        void SetFrameListener(FrameListener* listener) {
+            frameListener = listener;
+        }
+
+        /*
+         * Clock to pace frames by and to tell about the camera's frame
+         * timestamps. Must be set before StartAcquisition.
+         */
+        void SetClock(Clock* clk) {
+            clock = clk;
+        }
+
+        /*
+         * Longest to go without a frame before StartAcquisition gives up,
+         * 0 to wait forever. Must be set before StartAcquisition.
+         */
+        void SetFrameTimeout(long long ms) {
+            frameTimeoutMs = ms;
+        }
+
+        /*
+         * Clock time of the last frame published, and of the first one
+         * since ResetFirstFrame, or -1 if there hasn't been one.
+         */
+        long long GetLastFrameUs(void) {
+            return lastFrameUs;
+        }
+
+        long long GetFirstFrameUs(void) {
+            return firstFrameUs;
+        }
+
+        void ResetFirstFrame(void) {
+            firstFrameUs.store(-1);
+        }
+
+    protected:
+        FrameListener* frameListener;
+        Clock* clock;
+        long long frameTimeoutMs;
+
+        /*
+         * Called by the sources once a new frame's boxes are ready to be
+         * taken.
+         */
+        void PublishFrame(void) {
+            long long nowUs = clock->NowUs();
+            long long none = -1;
+            lastFrameUs.store(nowUs);
+            firstFrameUs.compare_exchange_strong(none, nowUs);
+
+            if (frameListener != NULL)
+                frameListener->OnFrame();
+        }
+
+    private:
+        std::atomic<long long> lastFrameUs;
+        std::atomic<long long> firstFrameUs;
+};
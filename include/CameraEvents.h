@@ -0,0 +1,112 @@
+#pragma once
+/*
+ *  CameraEvents.h
+ *
+ *  Timing of each frame on the camera, from the events the camera sends
+ *  as it works. The camera reports when each exposure ended and any
+ *  error, stamped with its own clock and the ID of the frame, and every
+ *  image carries the same frame ID in its chunk data. Matching the two
+ *  tells how long a frame spent on the camera, running the network and
+ *  being sent, against how long it then took on the host:
+ *
+ *      exposure end -> image arrives     inference and transfer, on the camera
+ *      image arrives -> boxes published  on the host
+ *
+ *  Events come in on Spinnaker's event thread. The handler only copies
+ *  out the event's data and hands it to the acquisition thread through a
+ *  lock-free queue, dropping it if the queue is full, so it never waits.
+ *  The acquisition thread matches events and images by frame ID, in
+ *  whichever order they arrive, and converts the camera's timestamps to
+ *  host time using the offset between the clocks, measured with
+ *  TimestampLatch every CAM_CLOCK_SYNC_MS.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+#include "SpscQueue.h"
+#include "ThreadControl.h"
+#include <atomic>
+
+#define CAM_EVENT_EXPOSURE_END 0
+#define CAM_EVENT_ERROR        1
+#define CAM_EVENT_ACQ_START    2
+#define CAM_EVENT_ACQ_END      3
+
+// Events waiting for the acquisition thread
+#define CAM_EVENT_QUEUE 256
+
+// Frames waiting for their other half, a power of two. A frame whose
+// event or image doesn't come within this many frames isn't matched.
+#define CAM_EVENT_PENDING 64
+
+// How often to measure the offset between the camera's clock and ours
+#define CAM_CLOCK_SYNC_MS 10000
+
+struct CameraEvent {
+    int type;
+    long long frameId;
+    long long cameraNs;
+    long long code;
+};
+
+class CameraEvents : public Spinnaker::DeviceEvent {
+    public:
+        CameraEvents();
+        ~CameraEvents();
+
+        int Enable(Spinnaker::GenApi::INodeMap& nodeMap);
+        void OnDeviceEvent(Spinnaker::GenICam::gcstring eventName);
+
+        void OnImage(long long frameId, long long arrivalUs, long long publishedUs);
+        void Reset(void);
+
+        WakeupJitter* GetCameraLatency(void);
+        WakeupJitter* GetHostLatency(void);
+        long long GetEvents(void);
+        long long GetDropped(void);
+        long long GetUnmatched(void);
+        long long GetErrors(void);
+        void PrintReport(void);
+
+    private:
+        // A frame's exposure end and image, whichever came first
+        struct PendingFrame {
+            long long frameId;
+            long long exposureEndNs;
+            long long arrivalUs;
+        };
+
+        SpscQueue<CameraEvent>* queue;
+        PendingFrame* pending;
+
+        // Nodes the handler reads the events' data from
+        Spinnaker::GenApi::CIntegerPtr exposureEndId;
+        Spinnaker::GenApi::CIntegerPtr exposureEndTime;
+        Spinnaker::GenApi::CIntegerPtr errorId;
+        Spinnaker::GenApi::CIntegerPtr errorTime;
+        Spinnaker::GenApi::CIntegerPtr errorCode;
+        Spinnaker::GenApi::CCommandPtr latch;
+        Spinnaker::GenApi::CIntegerPtr latchValue;
+
+        // Camera clock to ours, and how far off it might be. Only used by
+        // the acquisition thread.
+        long long offsetUs;
+        long long nextSyncUs;
+        bool synced;
+        std::atomic<long long> clockErrorUs;
+
+        WakeupJitter* cameraLatency;
+        WakeupJitter* hostLatency;
+        std::atomic<long long> events;
+        std::atomic<long long> unmatched;
+        std::atomic<long long> errors;
+        std::atomic<long long> lastErrorCode;
+
+        void SyncClock(long long nowUs);
+        void Drain(void);
+        PendingFrame& Slot(long long frameId);
+        void Match(PendingFrame& frame);
+};
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *  CameraWatchdog.h
+ *
+ *  Keeps the camera delivering frames. Runs acquisition on the thread
+ *  that would otherwise run it directly, with the camera's frame timeout
+ *  set to the watchdog's deadline, so a camera that stalls, only sends
+ *  incomplete images or throws makes acquisition return instead of
+ *  hanging or ending for good. The camera is then closed and set up
+ *  again, waiting WATCHDOG_BACKOFF_MS after the first failed attempt and
+ *  twice as long after each one after that, up to WATCHDOG_MAX_BACKOFF_MS,
+ *  and acquisition started again.
+ *
+ *  An outage lasts from the last frame before the camera stopped to the
+ *  first frame after it came back, which is the recovery time reported.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "BoxSource.h"
+#include "Clock.h"
+#include <atomic>
+#include <mutex>
+
+// Longest to go without a frame before reconnecting. Must be well over
+// the frame interval at the idle frame rate.
+#define WATCHDOG_DEADLINE_MS 3000
+
+#define WATCHDOG_BACKOFF_MS     250
+#define WATCHDOG_MAX_BACKOFF_MS 8000
+
+class CameraWatchdog {
+    public:
+        CameraWatchdog(BoxSource* cam, Clock* clock, long long deadlineMs = WATCHDOG_DEADLINE_MS);
+        ~CameraWatchdog();
+
+        void Run(void);
+        void Stop(void);
+
+        bool IsDown(void);
+        long long GetOutages(void);
+        long long GetFailedReconnects(void);
+        long long GetLastRecoveryMs(void);
+        long long GetMaxRecoveryMs(void);
+        long long GetDownMs(void);
+        void PrintReport(void);
+
+    private:
+        BoxSource* mCam;
+        Clock* clock;
+        long long deadlineMs;
+        std::atomic<bool> stopSignal;
+
+        // Guards everything below, which the acquisition thread writes and
+        // the tracking thread reads
+        std::mutex* mutex;
+        bool down;
+        long long downSinceUs;
+        long long outages;
+        long long failedReconnects;
+        long long lastRecoveryMs;
+        long long maxRecoveryMs;
+        long long totalDownMs;
+
+        void Update(void);
+        bool Reconnect(void);
+};
@@ -0,0 +1,241 @@
+#pragma once
+/*
+ *  CoPipeline.h
+ *
+ *  Runs a PeopleCounter's frames through coroutine stages on a shared
+ *  Executor, instead of a tracking thread that sleeps and polls the
+ *  camera for boxes. Each stage waits for its input and for room
+ *  downstream, so one executor thread can drive several cameras:
+ *
+ *      acquire     waits for the camera to publish a frame, copies out
+ *                  its boxes
+ *      filter      drops the boxes that aren't people
+ *      track       matches, updates and counts (PeopleCounter::ProcessFrame)
+ *      export      publishes the count and the latency of the frame
+ *
+ *  The camera still acquires on its own thread, since its API blocks.
+ *  Images aren't passed along, so re-identification only has the boxes
+ *  to go on.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "Executor.h"
+#include "Channel.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Frames that can wait between two stages
+#define COPIPE_DEPTH 2
+
+struct CoFrame {
+    vector<InferenceBoundingBox> boxes;
+    std::chrono::steady_clock::time_point arrived;
+};
+
+template <class T>
+class CoPipeline {
+    public:
+        CoPipeline(Executor* executor, PeopleCounter<T>* cntr);
+        ~CoPipeline();
+
+        void Start(void);
+        void Stop(void);
+
+        long long GetFrames(void);
+        long long GetSkipped(void);
+        double GetAvgLatencyUs(void);
+        double GetMaxLatencyUs(void);
+        int GetExportedCount(void);
+
+    private:
+        Executor* executor;
+        PeopleCounter<T>* cntr;
+        BoxSource* mCam;
+        thread* acqThread;
+
+        FrameSignal* frameSignal;
+        Channel<CoFrame>* toFilter;
+        Channel<CoFrame>* toTrack;
+        Channel<CoFrame>* toExport;
+        atomic<int> liveStages;
+
+        // Time from the camera publishing a frame to its count being out
+        atomic<long long> frames;
+        atomic<long long> totalLatencyNs;
+        atomic<long long> maxLatencyNs;
+        atomic<int> exportedCount;
+
+        CoTask Acquire(void);
+        CoTask Filter(void);
+        CoTask Track(void);
+        CoTask Export(void);
+};
+
+/******************* Function Definitions ******************/
+template <class T>
+CoPipeline<T>::CoPipeline(Executor* executor, PeopleCounter<T>* cntr)
+    : executor(executor), cntr(cntr), acqThread(NULL), liveStages(0), frames(0), totalLatencyNs(0),
+      maxLatencyNs(0), exportedCount(0) {
+    mCam = cntr->GetBoxSource();
+    frameSignal = new FrameSignal(executor);
+    toFilter = new Channel<CoFrame>(executor, COPIPE_DEPTH);
+    toTrack = new Channel<CoFrame>(executor, COPIPE_DEPTH);
+    toExport = new Channel<CoFrame>(executor, COPIPE_DEPTH);
+}
+
+/*
+ * Starts the camera and spawns the stages on the executor, which must
+ * be running.
+ */
+template <class T>
+void CoPipeline<T>::Start(void) {
+    if (acqThread != NULL)
+        return;
+
+    mCam->SetFrameListener(frameSignal);
+    acqThread = new thread(&PeopleCounter<T>::RunAcquisition, cntr);
+
+    liveStages = 4;
+    executor->Spawn(Acquire());
+    executor->Spawn(Filter());
+    executor->Spawn(Track());
+    executor->Spawn(Export());
+}
+
+/*
+ * Lets the frames already taken in finish, then stops the camera.
+ */
+template <class T>
+void CoPipeline<T>::Stop(void) {
+    if (acqThread == NULL)
+        return;
+
+    // Each stage closes its output once its input is closed
+    frameSignal->Close();
+    while (liveStages > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    cntr->EndAcquisition();
+    acqThread->join();
+    mCam->SetFrameListener(NULL);
+    delete acqThread;
+    acqThread = NULL;
+}
+
+template <class T>
+long long CoPipeline<T>::GetFrames(void) {
+    return frames;
+}
+
+/*
+ * Frames the camera published that were replaced by the next one before
+ * the acquire stage got to them.
+ */
+template <class T>
+long long CoPipeline<T>::GetSkipped(void) {
+    return frameSignal->GetMerged();
+}
+
+template <class T>
+double CoPipeline<T>::GetAvgLatencyUs(void) {
+    return (frames > 0) ? totalLatencyNs / 1000.0 / frames : 0;
+}
+
+template <class T>
+double CoPipeline<T>::GetMaxLatencyUs(void) {
+    return maxLatencyNs / 1000.0;
+}
+
+/*
+ * Count as of the last frame through the export stage.
+ */
+template <class T>
+int CoPipeline<T>::GetExportedCount(void) {
+    return exportedCount;
+}
+
+template <class T>
+CoTask CoPipeline<T>::Acquire(void) {
+    CoFrame frame;
+
+    while (co_await frameSignal->Wait()) {
+        frame.arrived = frameSignal->GetLastNotify();
+        mCam->GetBoundingBoxData(frame.boxes);
+        if (!co_await toFilter->Push(frame))
+            break;
+    }
+
+    toFilter->Close();
+    liveStages--;
+}
+
+template <class T>
+CoTask CoPipeline<T>::Filter(void) {
+    CoFrame frame;
+
+    while (co_await toFilter->Pop(frame)) {
+        // The confidence is checked by the tracker, with its current config
+        vector<InferenceBoundingBox>& boxes = frame.boxes;
+        boxes.erase(std::remove_if(boxes.begin(), boxes.end(),
+                                   [](const InferenceBoundingBox& b) { return b.classId != PERSON_ID; }),
+                    boxes.end());
+
+        if (!co_await toTrack->Push(frame))
+            break;
+    }
+
+    toTrack->Close();
+    liveStages--;
+}
+
+template <class T>
+CoTask CoPipeline<T>::Track(void) {
+    CoFrame frame;
+
+    while (co_await toTrack->Pop(frame)) {
+        // Frames only come while the camera is up, but the trackers may
+        // need bringing up to date after an outage
+        cntr->HoldForOutage();
+        cntr->ProcessFrame(frame.boxes);
+        cntr->AdjustFrameRate();
+
+        if (!co_await toExport->Push(frame))
+            break;
+    }
+
+    toExport->Close();
+    liveStages--;
+}
+
+template <class T>
+CoTask CoPipeline<T>::Export(void) {
+    CoFrame frame;
+
+    while (co_await toExport->Pop(frame)) {
+        exportedCount = cntr->GetPeopleCount();
+
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - frame.arrived).count();
+        totalLatencyNs += ns;
+        if (ns > maxLatencyNs)
+            maxLatencyNs.store(ns);
+        frames++;
+    }
+
+    liveStages--;
+}
+
+template <class T>
+CoPipeline<T>::~CoPipeline() {
+    Stop();
+
+    delete frameSignal;
+    delete toFilter;
+    delete toTrack;
+    delete toExport;
+}
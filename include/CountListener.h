@@ -0,0 +1,23 @@
+#pragma once
+/*
+ *  CountListener.h
+ *
+ *  Abstract class for anything that wants to know when the PeopleCounter
+ *  counts someone. Called on the tracking thread, so implementations must
+ *  return quickly and never wait on anything.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+class CountListener {
+    public:
+        virtual ~CountListener() {}
+
+        // A tracker expired and the person was counted in the given direction
+        virtual void OnCrossing(int trackId, int dir) = 0;
+
+        // Something happened that the count can't account for, such as more
+        // people leaving than have come in
+        virtual void OnAnomaly(int /* trackId */) {}
+};
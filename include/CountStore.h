@@ -0,0 +1,139 @@
+#pragma once
+/*
+ *  CountStore.h
+ *
+ *  Compact on disk time series of one camera's counts, usually one sample
+ *  a minute, kept for years and queried by date range.
+ *
+ *  Samples are grouped into blocks covering COUNT_BLOCK_MS each (an hour,
+ *  aligned to multiples of it). A block is stored column by column:
+ *  times as varint deltas of the deltas (a byte each at a steady sample
+ *  rate), in and out as varints, and the count as a varint delta. Each
+ *  block is preceded by a summary of the people in and out, the lowest
+ *  and highest count and its time span:
+ *
+ *      CountStoreHeader
+ *      CountBlockHead, column bytes
+ *      CountBlockHead, column bytes
+ *      ...
+ *
+ *  When the store is opened, the block summaries are read into a sparse
+ *  index in memory (under 3 MB for five years). A range query finds the
+ *  first block it touches with a binary search and adds up the summaries
+ *  of the blocks it covers; only the blocks at the two ends are read from
+ *  disk and decoded, and only if the range starts or ends inside them.
+ *
+ *  The open block is only in memory, so a crash loses at most the last
+ *  block. A block cut short by a crash is dropped when the store is opened.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <mutex>
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+
+#define COUNT_STORE_MAGIC   0x53434B48 // "HKCS"
+#define COUNT_STORE_VERSION 1
+#define COUNT_BLOCK_MAGIC   0x42434B48 // "HKCB"
+
+// Span of time covered by each block
+#define COUNT_BLOCK_MS (60 * 60 * 1000LL)
+
+// Most samples in a block, however short the sample period
+#define COUNT_BLOCK_SAMPLES 4096
+
+struct CountStoreHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t cameraId;
+    uint32_t reserved;
+    int64_t blockMs;
+};
+
+struct CountBlockHead {
+    uint32_t magic;
+    uint32_t numSamples;
+    int64_t firstMs;
+    int64_t lastMs;
+    int64_t sumIn;
+    int64_t sumOut;
+    int32_t minCount;
+    int32_t maxCount;
+
+    // Length of the columns that follow, and their FNV-1a hash
+    uint32_t dataBytes;
+    uint32_t checksum;
+};
+
+// People in and out since the last sample, and the count at tMs
+struct CountSample {
+    long long tMs;
+    int in;
+    int out;
+    int count;
+};
+
+struct CountTotals {
+    long long in;
+    long long out;
+    int minCount;
+    int maxCount;
+    long long samples;
+};
+
+class CountStore {
+    public:
+        CountStore(long long blockMs = COUNT_BLOCK_MS);
+
+        int Open(const char* path, int cameraId = 0);
+        int Close(void);
+
+        int Append(const CountSample& sample);
+        int Query(long long fromMs, long long toMs, CountTotals* totals);
+
+        int GetCameraId(void);
+        long long GetSamples(void);
+        int GetBlocks(void);
+        long long GetBytes(void);
+        long long GetBlocksDecoded(void);
+
+        ~CountStore();
+
+    private:
+        // A block on disk and where it starts
+        struct BlockIndex {
+            CountBlockHead head;
+            long long offset;
+        };
+
+        long long blockMs;
+        int cameraId;
+        FILE* file;
+
+        // End of the last whole block, where the next one is written
+        long long endOffset;
+
+        std::vector<BlockIndex>* index;
+
+        // Samples of the block being filled
+        std::vector<CountSample>* open;
+
+        // Scratch for encoding and decoding blocks
+        std::vector<uint8_t>* bytes;
+        std::vector<CountSample>* decoded;
+
+        long long samples;
+        long long blocksDecoded;
+
+        // Appends and queries can come from different threads
+        std::mutex* mutex;
+
+        int LoadIndex(void);
+        int WriteBlock(void);
+        int ReadBlock(const BlockIndex& block);
+        void AddSamples(const std::vector<CountSample>& s, long long fromMs, long long toMs,
+                        CountTotals* totals);
+};
@@ -0,0 +1,139 @@
+#pragma once
+/*
+ *  CrossingFusion.h
+ *
+ *  Merges the people counted by cameras whose views overlap, so that a
+ *  hiker seen by two of them is only counted once.
+ *
+ *  Each camera's PeopleCounter hands over the path of every person it
+ *  counts (see Trajectories). The path is moved onto the site's clock
+ *  with the camera's offset and onto a shared line along the trail with
+ *  the camera's geometry, and the time the person passed the reference
+ *  point in the middle of the overlap is read off it. Crossings that
+ *  passed the reference within FUSION_WINDOW_MS of each other, in the
+ *  same direction, from different cameras, are the same person.
+ *
+ *  Crossings wait in a buffer ordered by that time, so finding the ones
+ *  in the window is a lookup rather than a scan. A crossing is counted
+ *  once every camera's clock is far enough past it that no duplicate can
+ *  still turn up. People who never passed the reference point in view,
+ *  and so can't be matched, are counted straight away.
+ *
+ *  A camera that hasn't reported or advanced for FUSION_STALE_MS, e.g.
+ *  because it is down, is left out until it does again, so it doesn't
+ *  hold up counting for the others. People it reports from before that
+ *  once it is back may be counted twice.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include "Trajectories.h"
+#include "Clock.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Largest gap between two cameras' times at the reference point for
+// them to be the same person
+#define FUSION_WINDOW_MS 1000
+
+// How long after a person passed the reference point a camera can still
+// report them: walking out of view, coasting and re-identification
+#define FUSION_HOLD_MS 30000
+
+// How long a camera can go without reporting or advancing before it is
+// left out of deciding what can be counted
+#define FUSION_STALE_MS (2 * 60 * 1000)
+
+// Cameras a fusion can take
+#define FUSION_MAX_CAMERAS 32
+
+/*
+ * Where a camera sits on the trail. A column x of its image is at
+ * trailAtX0 + trailPerPx * x along the trail, so trailPerPx is negative
+ * for a camera facing the other way. offsetMs moves its clock onto the
+ * site's.
+ */
+struct FusionCamera {
+    long long offsetMs;
+    double trailAtX0;
+    double trailPerPx;
+
+    FusionCamera() : offsetMs(0), trailAtX0(0), trailPerPx(1) {}
+};
+
+class CrossingFusion {
+    public:
+        CrossingFusion(double refPos, long long windowMs = FUSION_WINDOW_MS, long long holdMs = FUSION_HOLD_MS,
+                       long long staleMs = FUSION_STALE_MS);
+        ~CrossingFusion();
+
+        void SetClock(Clock* clk);
+        int AddCamera(const FusionCamera& cam);
+        PathListener* GetFeed(int camera);
+
+        void AddPath(int camera, const TrajRecord& rec);
+        void Advance(int camera, long long cameraMs);
+
+        int GetPeopleCount(void);
+        int GetPeopleIn(void);
+        int GetPeopleOut(void);
+        long long GetCrossings(void);
+        long long GetMerged(void);
+        long long GetUnmatchable(void);
+        int GetPending(void);
+        int GetStaleCameras(void);
+
+    private:
+        // Passes a camera's paths on to the fusion
+        class Feed : public PathListener {
+            public:
+                Feed(CrossingFusion* fusion, int camera) : fusion(fusion), camera(camera) {}
+                void OnPathEnd(const TrajRecord& rec);
+
+            private:
+                CrossingFusion* fusion;
+                int camera;
+        };
+
+        struct Crossing {
+            int dir;
+
+            // Bit n is set once camera n has reported the person
+            unsigned cameras;
+        };
+
+        double refPos;
+        long long windowMs;
+        long long holdMs;
+        long long staleMs;
+        Clock* clock;
+
+        std::vector<FusionCamera>* cameras;
+        std::vector<Feed*>* feeds;
+
+        // Site time each camera's clock has reached
+        std::vector<long long>* progressMs;
+
+        // Time on the fusion's clock each camera was last heard from
+        std::vector<long long>* heardMs;
+
+        // Crossings not counted yet, by the time they passed the reference
+        std::multimap<long long, Crossing>* pending;
+        std::mutex* mutex;
+
+        std::atomic<int> peopleCount;
+        std::atomic<int> peopleIn;
+        std::atomic<int> peopleOut;
+        long long crossings;
+        long long merged;
+        long long unmatchable;
+
+        bool TimeAtRef(const FusionCamera& cam, const TrajRecord& rec, long long* refMs);
+        void Count(int dir);
+        bool IsStale(int camera, long long nowMs);
+        void Flush(void);
+};
@@ -0,0 +1,20 @@
+#pragma once
+/*
+ *  FrameListener.h
+ *
+ *  Abstract class for anything that wants to know as soon as a camera
+ *  publishes a new frame's boxes, instead of polling for them. Called on
+ *  the acquisition thread, so implementations must return quickly and
+ *  never wait on anything.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+class FrameListener {
+    public:
+        virtual ~FrameListener() {}
+
+        // The boxes of a new frame can be read from the camera
+        virtual void OnFrame(void) = 0;
+};
@@ -10,29 +10,104 @@
 
 #include "Spinnaker.h"
 #include "SpinGenApi/SpinnakerGenApi.h"
+#include "BoxSource.h"
+#include "ImagePipeline.h"
+#include "CameraEvents.h"
 #include <vector>
 #include <mutex>
 #include <atomic>
 
-class HikerCam {
+// Least severe of the Spinnaker library's own messages that are logged
+#define SPINNAKER_LOG_LEVEL Spinnaker::LOG_LEVEL_WARN
+
+/*
+ * Passes the Spinnaker library's own log messages on to the Logger.
+ */
+class SpinnakerLog : public Spinnaker::LoggingEvent {
+    public:
+        void OnLogEvent(Spinnaker::LoggingEventDataPtr data);
+};
+
+/*
+ * Camera image handed to the image pipeline, which gives it back to the
+ * camera once a worker has copied it out.
+ */
+class PipelineImage : public ImageHold {
+    public:
+        PipelineImage() : busy(false) {}
+
+        void Release(void) {
+            image = NULL;
+            busy.store(false);
+        }
+
+        Spinnaker::ImagePtr image;
+        std::atomic<bool> busy;
+};
+
+class HikerCam : public BoxSource {
     public:
         HikerCam();
         ~HikerCam();
 
         int InitCamera(void);
+        void CloseCamera(void);
         int StartAcquisition(void);
         void EndAcquisition(void);
         void GetBoundingBoxData(std::vector<Spinnaker::InferenceBoundingBox>& buf);
+        void GetFrameData(std::vector<Spinnaker::InferenceBoundingBox>& buf, ImageView& img);
+        int SetFrameRate(double fps);
+
+        void SetImagePipeline(ImagePipeline* pipeline);
+        double GetAvgBoxLatencyUs(void);
+        double GetMaxBoxLatencyUs(void);
+        WakeupJitter* GetWakeupJitter(void);
+        CameraEvents* GetCameraEvents(void);
+        long long GetIncompleteFrames(void);
 
     private:
         Spinnaker::SystemPtr mSystem;
         Spinnaker::CameraPtr mCamera;
+
+        // Held while mCamera is set up or released by the acquisition
+        // thread, and while another thread uses it
+        std::mutex* cameraMutex;
+
+        // Frame rate last asked for, set again whenever the camera is
+        // set up, since it comes back triggered on every inference
+        std::atomic<double> frameRate;
+        SpinnakerLog* sdkLog;
         std::atomic<bool> endAcquistionSignal;
 
         std::mutex* bufferMutex;
         std::vector<Spinnaker::InferenceBoundingBox>* boundingBoxBuffer;
+        Spinnaker::ImagePtr latestImage;
+
+        // Image handed out by GetFrameData
+        Spinnaker::ImagePtr heldImage;
+
+        ImagePipeline* imagePipeline;
+
+        // One more than the pipeline can hold, so one is always free
+        PipelineImage* pipelineImages;
+        int numPipelineImages;
+
+        // Time from an image arriving to its boxes being published
+        std::atomic<long long> framesDelivered;
+        std::atomic<long long> incompleteFrames;
+        std::atomic<long long> totalBoxLatencyNs;
+        std::atomic<long long> maxBoxLatencyNs;
+
+        // How late each image was picked up
+        WakeupJitter* jitter;
+
+        // Time each frame spent on the camera, if it reports its events
+        CameraEvents* events;
+        std::atomic<bool> eventsRegistered;
 
+        int ApplyFrameRate(double fps);
         int EnableInference(Spinnaker::GenApi::INodeMap& nodeMap);
+        int EnableChunks(Spinnaker::GenApi::INodeMap& nodeMap);
 };
 
 
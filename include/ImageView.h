@@ -0,0 +1,23 @@
+#pragma once
+/*
+ *  ImageView.h
+ *
+ *  Pixels of a frame handed out by a BoxSource, without tying the user
+ *  to the Spinnaker image classes. Only valid for as long as the source
+ *  holds on to the image, see BoxSource::GetFrameData.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include <stdint.h>
+
+struct ImageView {
+    // NULL if there is no image
+    const uint8_t* data;
+    int width;
+    int height;
+    int stride;
+    Spinnaker::PixelFormatEnums format;
+};
@@ -8,14 +8,30 @@
 
 #include "Tracker.h"
 #include "HikerCam.h"
+#include "BoxSource.h"
+#include "ActivityController.h"
+#include "ConfigStore.h"
+#include "ReIdentifier.h"
+#include "CountListener.h"
+#include "Heatmap.h"
+#include "Trajectories.h"
+#include "TrackStats.h"
+#include "TentativeTracks.h"
+#include "CameraWatchdog.h"
+#include "Arena.h"
+#include "ThreadControl.h"
+#include "FrameListener.h"
+#include "Clock.h"
 #include <vector>
 #include <atomic>
 #include <iostream>
 #include <thread>
+#include <chrono>
+#include <algorithm>
+#include <climits>
+#include <new>
 
 #define COUNT_THRESH 5
-#define PERSON_ID 15
-#define CONFIDENCE_THRESH 0.70
 
 using namespace Spinnaker;
 
@@ -28,28 +44,152 @@ template <class T>
 class PeopleCounter {
     public:
         PeopleCounter();
+        PeopleCounter(BoxSource* cam);
         ~PeopleCounter();
 
         int InitPeopleCounter();
         void StartPeopleCounter();
         void StopPeopleCounter();
         int GetPeopleCount();
+        int GetPeopleIn();
+        int GetPeopleOut();
+
+        void ProcessFrame(vector<InferenceBoundingBox>& boundingBoxes, vector<int>* trackIds = NULL,
+                          const ImageView* image = NULL);
+        void AdjustFrameRate(void);
+        BoxSource* GetBoxSource();
+
+        void SetClock(Clock* clk);
+        Clock* GetClock();
+        void Replay();
+
+        void RunAcquisition();
+        void EndAcquisition();
+        void EnableWatchdog(long long deadlineMs = WATCHDOG_DEADLINE_MS);
+        CameraWatchdog* GetWatchdog();
+        bool HoldForOutage();
+
+        void SetTrackerConfig(const TrackerConfig& cfg);
+        ConfigStore* GetConfigStore();
+
+        void EnableActivityControl();
+        ActivityController* GetActivityController();
+
+        void EnableReIdentification();
+        ReIdentifier* GetReIdentifier();
+
+        void AddCountListener(CountListener* listener);
+
+        void EnableHeatmap();
+        Heatmap* GetHeatmap();
+
+        void EnableTrajectories(int maxTracks = TRAJ_MAX_TRACKS);
+        Trajectories* GetTrajectories();
+
+        void EnableTrackStats(int cameraId = 0);
+        TrackStats* GetTrackStats();
+
+        void EnableTentativeTracks();
+        TentativeTracks* GetTentativeTracks();
+        long long GetTrackersCreated();
+        void GetTrackStates(int* numTentative, int* numConfirmed, int* numCoasting);
+
+        void UseArena(Arena* arena, const ArenaCaps& caps);
+
+        void SetThreadPlacement(const ThreadPlacement& acquisition, const ThreadPlacement& tracking);
+        WakeupJitter* GetTrackingJitter();
+        WakeupJitter* GetAcquisitionJitter();
 
     private:
         atomic<int> peopleCount;
+        atomic<int> peopleIn;
+        atomic<int> peopleOut;
+        int nextTrackId;
+        ConfigStore* configStore;
 
-        HikerCam* mCam;
+        BoxSource* mCam;
+        ActivityController* activity;
+        ReIdentifier* reid;
+        Heatmap* heatmap;
+        Trajectories* paths;
+        TrackStats* stats;
+        TentativeTracks* tentative;
+        CameraWatchdog* watchdog;
+        long long trackersCreated;
+
+        // Outages the trackers have been brought up to date after
+        long long outagesSeen;
         atomic<bool> endTrackingSignal;
         vector<T*>* tracker;
+        vector<int>* frameMatches;
+        vector<CountListener*>* listeners;
+
+        // Trackers come from the arena when there is one
+        ArenaPool* trackPool;
+        ArenaPool* boxPool;
+        int boxLimit;
+        size_t boxReserve;
+
+        ThreadPlacement acqPlacement;
+        ThreadPlacement trackPlacement;
+        WakeupJitter* trackJitter;
+        Clock* clock;
+
+        // Time of the frame being processed, for the paths
+        long long frameMs;
+
+        // Tracks each frame as soon as the source publishes it, for Replay
+        class ReplayListener : public FrameListener {
+            public:
+                ReplayListener(PeopleCounter* cntr) : cntr(cntr) {}
+                void OnFrame(void);
+
+            private:
+                PeopleCounter* cntr;
+                vector<InferenceBoundingBox> boundingBoxes;
+        };
+
+        T* NewTracker(InferenceBoundingBox& box, int id);
+        void MatchTracker(T* tr, InferenceBoundingBox& box);
+        void FreeTracker(T* tr);
+        T* StartTrack(InferenceBoundingBox& box, const TrackerConfig& config, int* id);
+        void CountTracker(T* tr);
 };
 
 /******************* Function Definitions ******************/
 template <class T>
-PeopleCounter<T>::PeopleCounter() : peopleCount(0), endTrackingSignal(false) {
+PeopleCounter<T>::PeopleCounter() : peopleCount(0), peopleIn(0), peopleOut(0), nextTrackId(0),
+                                    activity(NULL), reid(NULL), heatmap(NULL), paths(NULL), stats(NULL),
+                                    tentative(NULL), watchdog(NULL), trackersCreated(0), outagesSeen(0),
+                                    endTrackingSignal(false), trackPool(NULL),
+                                    boxPool(NULL), boxLimit(INT_MAX), boxReserve(0),
+                                    clock(GetSteadyClock()), frameMs(0) {
     tracker = new vector<T*>();
+    frameMatches = new vector<int>();
+    listeners = new vector<CountListener*>();
+    configStore = new ConfigStore();
+    trackJitter = new WakeupJitter();
     mCam = new HikerCam();
 }
 
+/*
+ * Count people using the given source of bounding boxes instead of the
+ * camera. The PeopleCounter takes ownership of the source.
+ */
+template <class T>
+PeopleCounter<T>::PeopleCounter(BoxSource* cam) : peopleCount(0), peopleIn(0), peopleOut(0), nextTrackId(0),
+                                                  mCam(cam), activity(NULL), reid(NULL), heatmap(NULL), paths(NULL),
+                                                  stats(NULL), tentative(NULL), watchdog(NULL), trackersCreated(0),
+                                                  outagesSeen(0), endTrackingSignal(false),
+                                                  trackPool(NULL), boxPool(NULL), boxLimit(INT_MAX), boxReserve(0),
+                                                  clock(GetSteadyClock()), frameMs(0) {
+    tracker = new vector<T*>();
+    frameMatches = new vector<int>();
+    listeners = new vector<CountListener*>();
+    configStore = new ConfigStore();
+    trackJitter = new WakeupJitter();
+}
+
 template <class T>
 int PeopleCounter<T>::InitPeopleCounter() {
     if (mCam->InitCamera())
@@ -61,77 +201,293 @@ int PeopleCounter<T>::InitPeopleCounter() {
 template <class T>
 void PeopleCounter<T>::StartPeopleCounter() {
     // Create acquisition thread
-    thread acqThread(&HikerCam::StartAcquisition, mCam);
+    thread acqThread(&PeopleCounter<T>::RunAcquisition, this);
+    PlaceThread(acqThread, acqPlacement);
+    PlaceThisThread(trackPlacement);
+
+    // Reused every frame, so it only grows past what was reserved
+    vector<InferenceBoundingBox> boundingBoxes;
+    boundingBoxes.reserve(boxReserve);
+
+    // Polls on a fixed schedule, however long each frame took
+    PeriodicTimer timer(clock, INFERENCE_TIME * 1000LL);
 
     while (!endTrackingSignal) {
-        Sleep(INFERENCE_TIME);
-        vector<InferenceBoundingBox> boundingBoxes;
-        mCam->GetBoundingBoxData(boundingBoxes);
-
-        if (tracker->size() == 0) {
-            // Make new boxes for each of them 
-            for (auto it = boundingBoxes.begin(); it != boundingBoxes.end(); ++it) {
-                InferenceBoundingBox box = *it;
-
-                // Create new centroid
-                if (box.classId == PERSON_ID && box.confidence > CONFIDENCE_THRESH) {
-                    T* tr = new T(box);
-                    tracker->push_back(tr);
-                }
-            }
+        timer.SetPeriodUs(((activity != NULL) ? activity->GetPollInterval() : INFERENCE_TIME) * 1000LL);
+        trackJitter->Record(timer.Wait());
+        if (HoldForOutage())
+            continue;
+        boundingBoxes.clear();
+
+        if (reid != NULL) {
+            ImageView image;
+            mCam->GetFrameData(boundingBoxes, image);
+            ProcessFrame(boundingBoxes, NULL, (image.data != NULL) ? &image : NULL);
         }
         else {
-            // Compare the distances with all existing objects
-            for (auto it = boundingBoxes.begin(); it != boundingBoxes.end(); ++it) {
-                InferenceBoundingBox box = *it;
+            mCam->GetBoundingBoxData(boundingBoxes);
+            ProcessFrame(boundingBoxes);
+        }
+
+        AdjustFrameRate();
+    }
 
-                if (box.classId == PERSON_ID && box.confidence > CONFIDENCE_THRESH) {
-                    bool match = false;
+    // Stop acquistion
+    EndAcquisition();
+
+    // Wait for acquistion thread to end
+    acqThread.join();
+}
+
+/*
+ * Runs one iteration of tracking on the bounding boxes of a single frame:
+ * matches boxes to existing trackers, creates trackers for new people and
+ * counts the people whose trackers have expired.
+ *
+ * If trackIds is not NULL, it is filled with the ID of the tracker each
+ * box was assigned to, or -1 if the box was ignored.
+ *
+ * The whole frame is processed with the config that was current when it
+ * started, even if a new one is published in the meantime.
+ *
+ * The image the boxes were found in is only used for re-identification,
+ * and can be NULL.
+ */
+template <class T>
+void PeopleCounter<T>::ProcessFrame(vector<InferenceBoundingBox>& boundingBoxes, vector<int>* trackIds,
+                                    const ImageView* image) {
+    const TrackerConfig& config = *configStore->Acquire();
+
+    if (trackIds != NULL)
+        trackIds->assign(boundingBoxes.size(), -1);
+
+    // People in the frame, for re-identification and the arena's box count
+    int people = 0;
+    if (reid != NULL || boxPool != NULL) {
+        for (size_t i = 0; i < boundingBoxes.size(); i++) {
+            if (boundingBoxes[i].classId == PERSON_ID && boundingBoxes[i].confidence > config.confidenceThresh)
+                people++;
+        }
+    }
+
+    // Signatures are only worth taking when people can be confused
+    bool crowded = (reid != NULL && people > 1);
+    if (reid != NULL)
+        reid->BeginFrame(image);
+
+    if (heatmap != NULL || paths != NULL)
+        frameMs = clock->NowMs();
+
+    if (heatmap != NULL) {
+        heatmap->BeginFrame(frameMs);
+    }
+
+    if (tentative != NULL)
+        tentative->BeginFrame(config);
+
+    // Boxes past the arena's capacity are ignored
+    if (boxPool != NULL)
+        boxPool->NoteUsed(people);
+    int taken = 0;
+
+    if (tracker->size() == 0) {
+        // Make new boxes for each of them 
+        for (size_t i = 0; i < boundingBoxes.size(); i++) {
+            InferenceBoundingBox box = boundingBoxes[i];
+
+            // Create new centroid
+            if (box.classId == PERSON_ID && box.confidence > config.confidenceThresh && taken++ < boxLimit) {
+                if (heatmap != NULL)
+                    heatmap->AddBox(box);
+
+                int id;
+                T* tr = StartTrack(box, config, &id);
+
+                if (tr != NULL && crowded)
+                    reid->UpdateSignature(tr, box);
+                if (trackIds != NULL)
+                    (*trackIds)[i] = id;
+            }
+        }
+    }
+    else {
+        // Trackers that match the whole frame at once do it up front
+        bool frameMatched = T::matchFrame(boundingBoxes, *tracker, config, *frameMatches);
+
+        // Compare the distances with all existing objects
+        for (size_t i = 0; i < boundingBoxes.size(); i++) {
+            InferenceBoundingBox box = boundingBoxes[i];
+
+            if (box.classId == PERSON_ID && box.confidence > config.confidenceThresh && taken++ < boxLimit) {
+                if (heatmap != NULL)
+                    heatmap->AddBox(box);
+
+                T* match = NULL;
+                if (frameMatched) {
+                    if ((*frameMatches)[i] >= 0) {
+                        match = (*tracker)[(*frameMatches)[i]];
+                        MatchTracker(match, box);
+                    }
+                }
+                else {
                     for (auto it_ctr = tracker->begin(); it_ctr != tracker->end(); ++it_ctr) {
-                        if ((*it_ctr)->isBoxMatch(box)) {
-                            match = true;
-                            (*it_ctr)->updateTracker(box);
+                        if ((*it_ctr)->isBoxMatch(box, config)) {
+                            match = *it_ctr;
+                            MatchTracker(match, box);
                             break;
                         }
                     }
-
-                    // Make a new tracker if the existing ones don't match
-                    if (!match) {
-                        T* tr = new T(box);
-                        tracker->push_back(tr);
-                    }
                 }
-            }
-        }
 
-        // Update all trackers for next round of comparison
-        for (auto it_ctr = tracker->begin(); it_ctr != tracker->end(); ++it_ctr) {
-            if ((*it_ctr)->updateTracker() == -1) {
-                // Update people counter
-                if ((*it_ctr)->getDir() == LEFT)
-                    peopleCount.store(peopleCount + 1);
-                else if (peopleCount != 0)
-                    peopleCount.store(peopleCount - 1);
-                delete (*it_ctr);
-                *it_ctr = NULL;
+                // Start a new track if the existing ones don't match
+                int id;
+                if (match == NULL)
+                    match = StartTrack(box, config, &id);
+                else
+                    id = match->getId();
+
+                if (match != NULL && crowded)
+                    reid->UpdateSignature(match, box);
+
+                if (trackIds != NULL)
+                    (*trackIds)[i] = id;
             }
         }
+    }
 
-        // Erase whatever trackers were deallocated in the previous step
-        int numTrackers = (int)tracker->size();
-        for (int i = 0; i < numTrackers; i++) {
-            if ((*tracker)[i] == NULL) {
-                tracker->erase(tracker->begin() + i);
-                numTrackers--;
-            }
+    // Update all trackers for next round of comparison
+    for (auto it_ctr = tracker->begin(); it_ctr != tracker->end(); ++it_ctr) {
+        if ((*it_ctr)->updateTracker(config) == -1) {
+            // Wait to count people who may only be hidden
+            if (reid == NULL || !reid->Bury(*it_ctr))
+                CountTracker(*it_ctr);
+            *it_ctr = NULL;
         }
     }
 
-    // Stop acquistion
-    mCam->EndAcquisition();
+    // Count the people that haven't come back
+    if (reid != NULL) {
+        Tracker* expired;
+        while ((expired = reid->Collect()) != NULL)
+            CountTracker((T*)expired);
+    }
 
-    // Wait for acquistion thread to end
-    acqThread.join();
+    // Erase whatever trackers were deallocated in the previous step
+    tracker->erase(std::remove(tracker->begin(), tracker->end(), (T*)NULL), tracker->end());
+
+    configStore->Release();
+}
+
+/*
+ * Adjusts the frame rate to how busy the scene is. Called after every
+ * frame by whatever runs ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::AdjustFrameRate(void) {
+    if (activity != NULL) {
+        int tracked = (int)tracker->size() + ((tentative != NULL) ? tentative->GetActive() : 0);
+        activity->Update(tracked, clock->NowMs());
+    }
+}
+
+/*
+ * Source of the bounding boxes, still owned by the PeopleCounter.
+ */
+template <class T>
+BoxSource* PeopleCounter<T>::GetBoxSource() {
+    return mCam;
+}
+
+/*
+ * Clock to time frames and sleep on, shared with the box source. Must be
+ * called before StartPeopleCounter or the first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::SetClock(Clock* clk) {
+    clock = clk;
+    mCam->SetClock(clk);
+}
+
+template <class T>
+Clock* PeopleCounter<T>::GetClock() {
+    return clock;
+}
+
+/*
+ * Plays the box source through to its end on the calling thread, tracking
+ * every frame as soon as it is published instead of polling for it, then
+ * runs empty frames until the last people have been counted. On a
+ * SimClock nothing ever waits, so a recording replays as fast as the CPU
+ * allows and counts the same every time. Only for sources that stop by
+ * themselves, like SimCam.
+ */
+template <class T>
+void PeopleCounter<T>::Replay() {
+    ReplayListener listener(this);
+
+    mCam->SetFrameListener(&listener);
+    RunAcquisition();
+    mCam->SetFrameListener(NULL);
+
+    // Enough empty frames for every tracker to expire under the config in
+    // use, and then leave re-identification
+    int missingThresh = configStore->Acquire()->missingThresh;
+    configStore->Release();
+
+    vector<InferenceBoundingBox> noBoxes;
+    for (int i = 0; i < missingThresh + REID_WINDOW + 2; i++) {
+        clock->SleepForUs(INFERENCE_TIME * 1000LL);
+        ProcessFrame(noBoxes);
+        AdjustFrameRate();
+    }
+}
+
+template <class T>
+void PeopleCounter<T>::ReplayListener::OnFrame(void) {
+    // A frame just came, so the camera is up, but the trackers may need
+    // bringing up to date after an outage
+    cntr->HoldForOutage();
+    cntr->mCam->GetBoundingBoxData(boundingBoxes);
+    cntr->ProcessFrame(boundingBoxes);
+    cntr->AdjustFrameRate();
+}
+
+/*
+ * Runs the box source's acquisition on the calling thread, under the
+ * watchdog if there is one, until EndAcquisition is called. For
+ * pipelines that run acquisition on a thread of their own.
+ */
+template <class T>
+void PeopleCounter<T>::RunAcquisition() {
+    if (watchdog != NULL)
+        watchdog->Run();
+    else
+        mCam->StartAcquisition();
+}
+
+template <class T>
+void PeopleCounter<T>::EndAcquisition() {
+    if (watchdog != NULL)
+        watchdog->Stop();
+    else
+        mCam->EndAcquisition();
+}
+
+/*
+ * Reconnect to the camera whenever it goes deadlineMs without a frame or
+ * fails, see CameraWatchdog. Tracking pauses while the camera is down,
+ * see HoldForOutage. Must be called after SetClock and before
+ * StartPeopleCounter or Replay.
+ */
+template <class T>
+void PeopleCounter<T>::EnableWatchdog(long long deadlineMs) {
+    if (watchdog == NULL)
+        watchdog = new CameraWatchdog(mCam, clock, deadlineMs);
+}
+
+template <class T>
+CameraWatchdog* PeopleCounter<T>::GetWatchdog() {
+    return watchdog;
 }
 
 template <class T>
@@ -144,7 +500,416 @@ int PeopleCounter<T>::GetPeopleCount() {
     return peopleCount;
 }
 
+/*
+ * Total number of people that have left the frame in the LEFT direction.
+ */
+template <class T>
+int PeopleCounter<T>::GetPeopleIn() {
+    return peopleIn;
+}
+
+/*
+ * Total number of people that have left the frame in the RIGHT direction.
+ */
+template <class T>
+int PeopleCounter<T>::GetPeopleOut() {
+    return peopleOut;
+}
+
+/*
+ * Change the matching thresholds. Can be called at any time, the new
+ * values are used from the next frame on.
+ */
+template <class T>
+void PeopleCounter<T>::SetTrackerConfig(const TrackerConfig& cfg) {
+    configStore->Publish(cfg);
+}
+
+/*
+ * Store holding the matching thresholds, used to load them from a file
+ * and to reload them while running.
+ */
+template <class T>
+ConfigStore* PeopleCounter<T>::GetConfigStore() {
+    return configStore;
+}
+
+/*
+ * Lower the frame rate while nobody is around. Must be called before
+ * StartPeopleCounter.
+ */
+template <class T>
+void PeopleCounter<T>::EnableActivityControl() {
+    if (activity == NULL)
+        activity = new ActivityController(mCam);
+}
+
+template <class T>
+ActivityController* PeopleCounter<T>::GetActivityController() {
+    return activity;
+}
+
+/*
+ * Keep trackers that expire in the middle of the frame for a while, so
+ * people who are hidden for a moment are not counted twice. Must be
+ * called before StartPeopleCounter or the first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::EnableReIdentification() {
+    if (reid == NULL)
+        reid = new ReIdentifier();
+}
+
+template <class T>
+ReIdentifier* PeopleCounter<T>::GetReIdentifier() {
+    return reid;
+}
+
+/*
+ * Build up a heatmap of where people walk in the frame.
+ */
+template <class T>
+void PeopleCounter<T>::EnableHeatmap() {
+    if (heatmap == NULL)
+        heatmap = new Heatmap();
+}
+
+template <class T>
+Heatmap* PeopleCounter<T>::GetHeatmap() {
+    return heatmap;
+}
+
+/*
+ * Keep the path each person took through the frame, with room for
+ * maxTracks of them at once. Must be called before StartPeopleCounter or
+ * the first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::EnableTrajectories(int maxTracks) {
+    if (paths == NULL)
+        paths = new Trajectories(maxTracks);
+}
+
+template <class T>
+Trajectories* PeopleCounter<T>::GetTrajectories() {
+    return paths;
+}
+
+/*
+ * Keep hourly distributions of how fast people walk and how long they
+ * are in view, from the path of every person counted. Turns on the
+ * trajectories if they aren't already. Must be called before
+ * StartPeopleCounter or the first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::EnableTrackStats(int cameraId) {
+    if (stats != NULL)
+        return;
+
+    EnableTrajectories();
+    stats = new TrackStats(cameraId);
+    paths->AddListener(stats);
+}
+
+template <class T>
+TrackStats* PeopleCounter<T>::GetTrackStats() {
+    return stats;
+}
+
+/*
+ * Only make a tracker for a box once it has been seen in CONFIRM_HITS of
+ * the last CONFIRM_FRAMES frames, so spurious detections are never
+ * tracked or counted. Must be called before StartPeopleCounter or the
+ * first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::EnableTentativeTracks() {
+    if (tentative == NULL)
+        tentative = new TentativeTracks();
+}
+
+template <class T>
+TentativeTracks* PeopleCounter<T>::GetTentativeTracks() {
+    return tentative;
+}
+
+/*
+ * Number of trackers made so far, not counting revived ones.
+ */
+template <class T>
+long long PeopleCounter<T>::GetTrackersCreated() {
+    return trackersCreated;
+}
+
+/*
+ * Number of tracks in each state after the last frame. Must be called
+ * from the tracking thread.
+ */
+template <class T>
+void PeopleCounter<T>::GetTrackStates(int* numTentative, int* numConfirmed, int* numCoasting) {
+    *numTentative = (tentative != NULL) ? tentative->GetActive() : 0;
+    *numConfirmed = 0;
+    *numCoasting = 0;
+
+    for (auto it = tracker->begin(); it != tracker->end(); ++it) {
+        if ((*it)->getState() == TRACK_CONFIRMED)
+            (*numConfirmed)++;
+        else
+            (*numCoasting)++;
+    }
+}
+
+/*
+ * Takes the trackers from the arena, with room for caps.tracksPerCamera
+ * of them including the ones held for re-identification, and reserves
+ * the per frame buffers for caps.boxesPerFrame boxes. When the trackers
+ * run out new people aren't tracked until one expires, and boxes past
+ * the cap are ignored; both are counted in the arena's report. Must be
+ * called before the arena is committed and before StartPeopleCounter or
+ * the first ProcessFrame.
+ */
+template <class T>
+void PeopleCounter<T>::UseArena(Arena* arena, const ArenaCaps& caps) {
+    if (trackPool != NULL)
+        return;
+
+    trackPool = arena->AddPool("tracks", sizeof(T), caps.tracksPerCamera);
+    boxPool = arena->AddPool("boxes", 0, caps.boxesPerFrame);
+    boxLimit = caps.boxesPerFrame;
+    boxReserve = caps.boxesPerFrame;
+
+    tracker->reserve(caps.tracksPerCamera);
+    frameMatches->reserve(caps.boxesPerFrame);
+}
+
+/*
+ * CPU and scheduling policy of the acquisition thread and of the thread
+ * that calls StartPeopleCounter, which does the tracking. Must be called
+ * before StartPeopleCounter.
+ */
+template <class T>
+void PeopleCounter<T>::SetThreadPlacement(const ThreadPlacement& acquisition, const ThreadPlacement& tracking) {
+    acqPlacement = acquisition;
+    trackPlacement = tracking;
+}
+
+/*
+ * How late the tracking thread woke up for each frame.
+ */
+template <class T>
+WakeupJitter* PeopleCounter<T>::GetTrackingJitter() {
+    return trackJitter;
+}
+
+/*
+ * How late the acquisition thread picked up each frame, or NULL if the
+ * source doesn't measure it.
+ */
+template <class T>
+WakeupJitter* PeopleCounter<T>::GetAcquisitionJitter() {
+    return mCam->GetWakeupJitter();
+}
+
+/*
+ * Tells the listener about every person counted from now on. The
+ * listener is not owned by the PeopleCounter.
+ */
+template <class T>
+void PeopleCounter<T>::AddCountListener(CountListener* listener) {
+    listeners->push_back(listener);
+}
+
+/*
+ * Creates a tracker for a new person with the given ID. Returns NULL if
+ * the arena has no room for another.
+ */
+template <class T>
+T* PeopleCounter<T>::NewTracker(InferenceBoundingBox& box, int id) {
+    T* tr;
+    if (trackPool != NULL) {
+        void* mem = trackPool->Take();
+        if (mem == NULL)
+            return NULL;
+        tr = new (mem) T(box);
+    }
+    else {
+        tr = new T(box);
+    }
+
+    tr->setId(id);
+    tr->setLastBox(box);
+    if (paths != NULL) {
+        tr->setPath(paths->Start(id, frameMs));
+        paths->Add(tr->getPath(), box, frameMs);
+    }
+
+    tracker->push_back(tr);
+    trackersCreated++;
+    return tr;
+}
+
+/*
+ * Moves a tracker on to the box it was matched to.
+ */
+template <class T>
+void PeopleCounter<T>::MatchTracker(T* tr, InferenceBoundingBox& box) {
+    tr->updateTracker(box);
+    tr->setLastBox(box);
+    if (paths != NULL)
+        paths->Add(tr->getPath(), box, frameMs);
+}
+
+template <class T>
+void PeopleCounter<T>::FreeTracker(T* tr) {
+    if (trackPool != NULL) {
+        tr->~T();
+        trackPool->Give(tr);
+    }
+    else {
+        delete tr;
+    }
+}
+
+/*
+ * Handles a box that no tracker matched: picks up a person that was
+ * hidden for a while, or starts a new track. Returns the tracker, or
+ * NULL if the box only belongs to a tentative track so far. id is set
+ * to the ID of the track, or -1 if the tentative buffer or the arena
+ * is full.
+ */
+template <class T>
+T* PeopleCounter<T>::StartTrack(InferenceBoundingBox& box, const TrackerConfig& config, int* id) {
+    // Pick up a person that was hidden for a while
+    if (reid != NULL) {
+        T* tr = (T*)reid->Revive(box);
+        if (tr != NULL) {
+            MatchTracker(tr, box);
+            tracker->push_back(tr);
+            *id = tr->getId();
+            return tr;
+        }
+    }
+
+    if (tentative == NULL) {
+        T* tr = NewTracker(box, nextTrackId);
+        *id = (tr != NULL) ? nextTrackId++ : -1;
+        return tr;
+    }
+
+    int slot = tentative->Match(box);
+    if (slot < 0) {
+        slot = tentative->Add(box, nextTrackId);
+        if (slot < 0) {
+            *id = -1;
+            return NULL;
+        }
+        nextTrackId++;
+    }
+
+    *id = tentative->GetId(slot);
+    if (!tentative->IsConfirmed(slot, config))
+        return NULL;
+
+    // Stays tentative until the arena has room for it
+    T* tr = NewTracker(box, *id);
+    if (tr != NULL)
+        tentative->Promote(slot);
+    return tr;
+}
+
+/*
+ * Counts the person an expired tracker was following and deletes it.
+ */
+template <class T>
+void PeopleCounter<T>::CountTracker(T* tr) {
+    // Update people counter
+    bool anomaly = false;
+    if (tr->getDir() == LEFT) {
+        peopleIn++;
+        peopleCount.store(peopleCount + 1);
+    }
+    else {
+        peopleOut++;
+        if (peopleCount != 0)
+            peopleCount.store(peopleCount - 1);
+        else
+            anomaly = true;
+    }
+
+    for (auto it = listeners->begin(); it != listeners->end(); ++it) {
+        (*it)->OnCrossing(tr->getId(), tr->getDir());
+        if (anomaly)
+            (*it)->OnAnomaly(tr->getId());
+    }
+
+    if (paths != NULL)
+        paths->End(tr->getPath(), tr->getDir());
+    if (reid != NULL)
+        reid->Forget(tr);
+    FreeTracker(tr);
+}
+
+/*
+ * Whether to skip tracking because the camera is down. The trackers are
+ * kept as they were until it comes back, then run through an empty frame
+ * for every frame it missed, so an outage they can coast through is
+ * bridged like any other gap. After a longer one they are out of date,
+ * and matching them, or the ones waiting to be re-identified, to where
+ * people are now would only split tracks, so all of them are run out and
+ * counted and tracking starts afresh. Must be called before each frame by
+ * whatever runs ProcessFrame.
+ */
+template <class T>
+bool PeopleCounter<T>::HoldForOutage() {
+    if (watchdog == NULL)
+        return false;
+    if (watchdog->IsDown())
+        return true;
+
+    long long outages = watchdog->GetOutages();
+    if (outages != outagesSeen) {
+        outagesSeen = outages;
+
+        // Frames the trackers would have seen at the current frame rate,
+        // under the config they will run with
+        int missingThresh = configStore->Acquire()->missingThresh;
+        configStore->Release();
+        long long periodMs = (activity != NULL) ? activity->GetPollInterval() : INFERENCE_TIME;
+
+        long long missed = watchdog->GetLastRecoveryMs() / periodMs;
+        if (missed > missingThresh)
+            missed = missingThresh + REID_WINDOW + 2;
+
+        vector<InferenceBoundingBox> noBoxes;
+        for (long long i = 0; i < missed; i++)
+            ProcessFrame(noBoxes);
+    }
+
+    return false;
+}
+
 template <class T>
 PeopleCounter<T>::~PeopleCounter() {
+    for (auto it_ctr = tracker->begin(); it_ctr != tracker->end(); ++it_ctr)
+        FreeTracker(*it_ctr);
+
+    if (reid != NULL) {
+        Tracker* expired;
+        while ((expired = reid->Drain()) != NULL)
+            FreeTracker((T*)expired);
+    }
+
     delete tracker;
-}
\ No newline at end of file
+    delete frameMatches;
+    delete listeners;
+    delete configStore;
+    delete trackJitter;
+    delete activity;
+    delete reid;
+    delete heatmap;
+    delete paths;
+    delete stats;
+    delete tentative;
+    delete watchdog;
+    delete mCam;
+}
@@ -0,0 +1,260 @@
+#pragma once
+/*
+ *  StagedPipeline.h
+ *
+ *  Runs a PeopleCounter's frames through stages on threads of their own,
+ *  joined by bounded lock-free queues, so that one frame is tracked while
+ *  the next is being filtered and the one before is being exported:
+ *
+ *      acquisition     the camera's thread copies out each frame's boxes
+ *                      as soon as they are published
+ *      filter          drops the boxes that aren't people
+ *      track           matches, updates and counts (PeopleCounter::ProcessFrame)
+ *      export          publishes the count and the latency of the frame
+ *
+ *  The camera never waits: a frame that doesn't fit in the first queue is
+ *  dropped. Every later stage waits for room instead, so the queues' wait
+ *  times show which stage holds the others back.
+ *
+ *  Images aren't passed along, so re-identification only has the boxes
+ *  to go on.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "FrameListener.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Frames that can wait between two stages
+#define STAGE_QUEUE_DEPTH 4
+
+struct StageFrame {
+    vector<InferenceBoundingBox> boxes;
+    std::chrono::steady_clock::time_point arrived;
+};
+
+template <class T>
+class StagedPipeline : public FrameListener {
+    public:
+        StagedPipeline(PeopleCounter<T>* cntr, int depth = STAGE_QUEUE_DEPTH);
+        ~StagedPipeline();
+
+        void Start(void);
+        void Stop(void);
+        void OnFrame(void);
+
+        SpscQueue<StageFrame>* GetFilterQueue(void);
+        SpscQueue<StageFrame>* GetTrackQueue(void);
+        SpscQueue<StageFrame>* GetExportQueue(void);
+
+        long long GetFrames(void);
+        double GetAvgLatencyUs(void);
+        double GetMaxLatencyUs(void);
+        int GetExportedCount(void);
+        void PrintReport(void);
+
+    private:
+        PeopleCounter<T>* cntr;
+        BoxSource* mCam;
+        thread* acqThread;
+        thread* filterThread;
+        thread* trackThread;
+        thread* exportThread;
+
+        // Only touched on the acquisition thread
+        StageFrame acquired;
+
+        SpscQueue<StageFrame>* toFilter;
+        SpscQueue<StageFrame>* toTrack;
+        SpscQueue<StageFrame>* toExport;
+
+        // Time from the camera publishing a frame to its count being out
+        atomic<long long> frames;
+        atomic<long long> totalLatencyNs;
+        atomic<long long> maxLatencyNs;
+        atomic<int> exportedCount;
+
+        void Filter(void);
+        void Track(void);
+        void Export(void);
+};
+
+/******************* Function Definitions ******************/
+template <class T>
+StagedPipeline<T>::StagedPipeline(PeopleCounter<T>* cntr, int depth)
+    : cntr(cntr), acqThread(NULL), filterThread(NULL), trackThread(NULL), exportThread(NULL), frames(0),
+      totalLatencyNs(0), maxLatencyNs(0), exportedCount(0) {
+    mCam = cntr->GetBoxSource();
+    toFilter = new SpscQueue<StageFrame>(depth);
+    toTrack = new SpscQueue<StageFrame>(depth);
+    toExport = new SpscQueue<StageFrame>(depth);
+}
+
+/*
+ * Starts the stages and then the camera.
+ */
+template <class T>
+void StagedPipeline<T>::Start(void) {
+    if (acqThread != NULL)
+        return;
+
+    filterThread = new thread(&StagedPipeline<T>::Filter, this);
+    trackThread = new thread(&StagedPipeline<T>::Track, this);
+    exportThread = new thread(&StagedPipeline<T>::Export, this);
+
+    mCam->SetFrameListener(this);
+    acqThread = new thread(&PeopleCounter<T>::RunAcquisition, cntr);
+}
+
+/*
+ * Stops the camera, then lets the frames already taken in finish.
+ */
+template <class T>
+void StagedPipeline<T>::Stop(void) {
+    if (acqThread == NULL)
+        return;
+
+    cntr->EndAcquisition();
+    acqThread->join();
+    mCam->SetFrameListener(NULL);
+
+    // Each stage closes its output once its input is closed
+    toFilter->Close();
+    filterThread->join();
+    trackThread->join();
+    exportThread->join();
+
+    delete acqThread;
+    delete filterThread;
+    delete trackThread;
+    delete exportThread;
+    acqThread = NULL;
+}
+
+/*
+ * Called on the acquisition thread for every frame the camera publishes.
+ */
+template <class T>
+void StagedPipeline<T>::OnFrame(void) {
+    acquired.arrived = std::chrono::steady_clock::now();
+    mCam->GetBoundingBoxData(acquired.boxes);
+    toFilter->TryPush(acquired);
+}
+
+/*
+ * Queue in front of each stage, for its depth, drops and wait times.
+ */
+template <class T>
+SpscQueue<StageFrame>* StagedPipeline<T>::GetFilterQueue(void) {
+    return toFilter;
+}
+
+template <class T>
+SpscQueue<StageFrame>* StagedPipeline<T>::GetTrackQueue(void) {
+    return toTrack;
+}
+
+template <class T>
+SpscQueue<StageFrame>* StagedPipeline<T>::GetExportQueue(void) {
+    return toExport;
+}
+
+template <class T>
+long long StagedPipeline<T>::GetFrames(void) {
+    return frames;
+}
+
+template <class T>
+double StagedPipeline<T>::GetAvgLatencyUs(void) {
+    return (frames > 0) ? totalLatencyNs / 1000.0 / frames : 0;
+}
+
+template <class T>
+double StagedPipeline<T>::GetMaxLatencyUs(void) {
+    return maxLatencyNs / 1000.0;
+}
+
+/*
+ * Count as of the last frame through the export stage.
+ */
+template <class T>
+int StagedPipeline<T>::GetExportedCount(void) {
+    return exportedCount;
+}
+
+template <class T>
+void StagedPipeline<T>::PrintReport(void) {
+    toFilter->PrintReport("Filter");
+    toTrack->PrintReport("Track");
+    toExport->PrintReport("Export");
+    cout << "Pipeline frames: " << GetFrames() << ", " << GetAvgLatencyUs() << " us on average from the camera, "
+         << GetMaxLatencyUs() << " us max\n";
+}
+
+template <class T>
+void StagedPipeline<T>::Filter(void) {
+    StageFrame frame;
+
+    while (toFilter->Pop(frame)) {
+        // The confidence is checked by the tracker, with its current config
+        vector<InferenceBoundingBox>& boxes = frame.boxes;
+        boxes.erase(std::remove_if(boxes.begin(), boxes.end(),
+                                   [](const InferenceBoundingBox& b) { return b.classId != PERSON_ID; }),
+                    boxes.end());
+
+        if (!toTrack->Push(frame))
+            break;
+    }
+
+    toTrack->Close();
+}
+
+template <class T>
+void StagedPipeline<T>::Track(void) {
+    StageFrame frame;
+
+    while (toTrack->Pop(frame)) {
+        // Frames only come while the camera is up, but the trackers may
+        // need bringing up to date after an outage
+        cntr->HoldForOutage();
+        cntr->ProcessFrame(frame.boxes);
+        cntr->AdjustFrameRate();
+
+        if (!toExport->Push(frame))
+            break;
+    }
+
+    toExport->Close();
+}
+
+template <class T>
+void StagedPipeline<T>::Export(void) {
+    StageFrame frame;
+
+    while (toExport->Pop(frame)) {
+        exportedCount = cntr->GetPeopleCount();
+
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - frame.arrived).count();
+        totalLatencyNs += ns;
+        if (ns > maxLatencyNs)
+            maxLatencyNs.store(ns);
+        frames++;
+    }
+}
+
+template <class T>
+StagedPipeline<T>::~StagedPipeline() {
+    Stop();
+
+    delete toFilter;
+    delete toTrack;
+    delete toExport;
+}
@@ -0,0 +1,106 @@
+#pragma once
+/*
+ *  ClipRecorder.h
+ *
+ *  Keeps the last few seconds of frames, downscaled, in a ring of
+ *  buffers allocated up front, and writes a short clip around every
+ *  crossing so that counts can be audited later.
+ *
+ *  Frames come in from the image pipeline workers and crossings from the
+ *  tracking thread. Neither ever waits: each slot of the ring is guarded
+ *  by a sequence number that the writer makes odd while it is filling the
+ *  slot, so the encoder thread can tell when a frame it copied was
+ *  overwritten under it and skip it. Crossings only set the trigger time,
+ *  which the encoder thread polls for.
+ *
+ *  On Windows clips are written as AVI files with SpinVideo. Elsewhere
+ *  each frame is dumped as a PPM file.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ImagePipeline.h"
+#include "CountListener.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+// Frames held in the ring, about 10 s at the inference rate
+#define CLIP_RING_FRAMES 64
+
+// Downscaling factor of the stored frames, and their largest size
+#define CLIP_SCALE      4
+#define CLIP_MAX_WIDTH  (1440 / CLIP_SCALE)
+#define CLIP_MAX_HEIGHT (1080 / CLIP_SCALE)
+
+// Time recorded before and after a crossing, and the longest clip
+// written when crossings keep extending it
+#define CLIP_PRE_MS  5000
+#define CLIP_POST_MS 2000
+#define CLIP_MAX_MS  20000
+
+// How often the encoder thread checks for a new crossing
+#define CLIP_POLL_MS 100
+
+struct ClipFrame {
+    // Odd while the frame is being written
+    std::atomic<unsigned> seq;
+    long long timeMs;
+    uint64_t frameId;
+    int width;
+    int height;
+
+    // RGB8, CLIP_MAX_WIDTH x CLIP_MAX_HEIGHT
+    uint8_t* pixels;
+};
+
+// Where and when a frame in the ring was taken, read under its sequence
+// number so the clip's frames can be picked and ordered
+struct ClipStamp {
+    long long timeMs;
+    uint64_t frameId;
+    int slot;
+};
+
+class ClipRecorder : public ImageConsumer, public CountListener {
+    public:
+        ClipRecorder(const char* dir);
+        ~ClipRecorder();
+
+        void Start(void);
+        void Stop(void);
+
+        void ProcessImage(const ImageView& img, uint64_t frameId, int worker);
+        void OnCrossing(int trackId, int dir);
+        void OnAnomaly(int trackId);
+
+        int GetClipsWritten(void);
+        long long GetFramesSkipped(void);
+
+    private:
+        std::string dir;
+        ClipFrame* ring;
+        uint8_t* ringPixels;
+        std::atomic<unsigned long long> nextSlot;
+
+        // Time of the latest crossing not yet recorded, -1 if none
+        std::atomic<long long> triggerMs;
+
+        std::thread* encoder;
+        std::atomic<bool> endSignal;
+
+        // Only used by the encoder thread
+        uint8_t* scratch;
+        std::vector<ClipStamp>* clipSlots;
+
+        std::atomic<int> clipsWritten;
+        std::atomic<long long> framesSkipped;
+
+        void RunEncoder(void);
+        void WriteClip(long long startMs, long long endMs);
+        bool ReadStamp(int slot, ClipStamp* stamp);
+        bool CopyFrame(int slot, uint64_t* frameId, int* width, int* height);
+};
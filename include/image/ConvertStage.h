@@ -0,0 +1,36 @@
+#pragma once
+/*
+ *  ConvertStage.h
+ *
+ *  Image pipeline stage that converts each image to another pixel format
+ *  with Image::Convert and passes the result on to its own consumers.
+ *  Every worker converts into its own buffer, which is reused for every
+ *  frame.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include "ImagePipeline.h"
+#include <vector>
+
+struct ConvertBuffer {
+    Spinnaker::ImagePtr src;
+    Spinnaker::ImagePtr dst;
+    std::vector<uint8_t>* pixels;
+};
+
+class ConvertStage : public ImageConsumer {
+    public:
+        ConvertStage(Spinnaker::PixelFormatEnums format, int numWorkers);
+        ~ConvertStage();
+
+        void AddConsumer(ImageConsumer* consumer);
+        void ProcessImage(const ImageView& img, uint64_t frameId, int worker);
+
+    private:
+        Spinnaker::PixelFormatEnums format;
+        std::vector<ConvertBuffer>* buffers;
+        std::vector<ImageConsumer*>* consumers;
+};
@@ -0,0 +1,73 @@
+#pragma once
+/*
+ *  Heatmap.h
+ *
+ *  Occupancy heatmap of where people walk in the frame, built up from the
+ *  footprints (bottom of the bounding box) of every person box on a grid
+ *  of HEATMAP_CELL pixel cells.
+ *
+ *  Old footprints fade with a half life. Rather than scaling the whole
+ *  grid down every frame, new footprints are added with a weight that
+ *  grows over time and the grid is divided by the weight when read, so
+ *  the cost of a frame only depends on the boxes in it. The grid is
+ *  rescaled in one pass on the rare occasion the weight gets too large.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include <vector>
+#include <mutex>
+
+// Size of a cell in pixels, and of the grid
+#define HEATMAP_CELL   16
+#define HEATMAP_COLS   ((CAM_X + HEATMAP_CELL - 1) / HEATMAP_CELL)
+#define HEATMAP_ROWS   ((CAM_Y + HEATMAP_CELL - 1) / HEATMAP_CELL)
+
+// Rows are padded to a multiple of 4 cells for the vector kernels
+#define HEATMAP_STRIDE ((HEATMAP_COLS + 3) & ~3)
+
+// Time for a footprint to fade to half
+#define HEATMAP_HALF_LIFE_MS (60.0 * 60 * 1000)
+
+// How often a snapshot of the grid is taken for readers
+#define HEATMAP_SNAPSHOT_MS 60000
+
+// Part of the box height at the bottom counted as the footprint
+#define HEATMAP_FOOT_FRACTION 8
+
+// Weight at which the grid is rescaled
+#define HEATMAP_MAX_WEIGHT 1e18f
+
+class Heatmap {
+    public:
+        Heatmap(double halfLifeMs = HEATMAP_HALF_LIFE_MS);
+        ~Heatmap();
+
+        void BeginFrame(long long nowMs);
+        void AddBox(const Spinnaker::InferenceBoundingBox& box);
+
+        void TakeSnapshot(void);
+        long long GetSnapshot(std::vector<float>& cells);
+        int WritePGM(const char* path);
+
+    private:
+        double halfLifeMs;
+
+        // HEATMAP_ROWS x HEATMAP_STRIDE, in units of the current weight
+        float* grid;
+        float weight;
+
+        long long lastFrameMs;
+        long long lastSnapshotMs;
+
+        // Latest snapshot, HEATMAP_ROWS x HEATMAP_COLS, guarded by the mutex
+        std::vector<float>* snapshot;
+        long long snapshotMs;
+        std::mutex* snapshotMutex;
+
+        void Rescale(void);
+};
+
+int SaveHeatmapImage(Heatmap& heatmap, const char* path);
@@ -0,0 +1,126 @@
+#pragma once
+/*
+ *  ImagePipeline.h
+ *
+ *  Runs image work (conversion, crops, statistics) on a pool of worker
+ *  threads so that it never holds up the acquisition loop. Each image is
+ *  copied into one of a fixed set of buffers that are recycled, so
+ *  nothing is allocated per frame once the buffers have grown to the
+ *  image size. An image handed over with an ImageHold is copied by the
+ *  worker that picks it up, which then releases it, so the acquisition
+ *  thread doesn't pay for the copy. Without one it is copied before
+ *  Submit returns.
+ *
+ *  When the workers can't keep up the image work is dropped, never the
+ *  bounding boxes, which are published before the image is handed over.
+ *
+ *  With UseArena the buffers are slots of the arena instead, sized for
+ *  the largest image up front, and images that don't fit are dropped.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ImageView.h"
+#include "Arena.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <stdint.h>
+
+// What to do with a new image when every buffer is in use
+#define DROP_NEWEST 0   // Drop the new image
+#define DROP_OLDEST 1   // Drop the oldest image still waiting for a worker
+
+#define DEFAULT_IMAGE_WORKERS 2
+#define DEFAULT_IMAGE_BUFFERS 4
+
+class ImageConsumer {
+    public:
+        virtual ~ImageConsumer() {}
+
+        /*
+         * Called on one of the worker threads, with the index of the worker
+         * so per worker scratch space can be used. Several frames may be
+         * processed at once, and the image is only valid until this returns.
+         */
+        virtual void ProcessImage(const ImageView& img, uint64_t frameId, int worker) = 0;
+};
+
+/*
+ * Keeps the pixels of a submitted image valid until the pipeline has
+ * copied them. Released on whichever thread is done with the image,
+ * including when it is dropped.
+ */
+class ImageHold {
+    public:
+        virtual ~ImageHold() {}
+
+        virtual void Release(void) = 0;
+};
+
+struct ImageSlot {
+    std::vector<uint8_t>* pixels;
+    ImageView view;
+    uint64_t frameId;
+
+    // Image still to be copied into pixels, if it was submitted held
+    ImageView source;
+    ImageHold* hold;
+};
+
+class ImagePipeline {
+    public:
+        ImagePipeline(int numWorkers = DEFAULT_IMAGE_WORKERS, int numBuffers = DEFAULT_IMAGE_BUFFERS);
+        ~ImagePipeline();
+
+        void AddConsumer(ImageConsumer* consumer);
+        void SetDropPolicy(int policy);
+        int GetNumWorkers(void);
+        int GetNumBuffers(void);
+        void UseArena(Arena* arena, size_t maxImageBytes);
+
+        void Start(void);
+        void Stop(void);
+        bool Submit(const ImageView& img, uint64_t frameId, ImageHold* hold = NULL);
+
+        long long GetSubmitted(void);
+        long long GetDropped(void);
+        long long GetProcessed(void);
+        double GetAvgSubmitUs(void);
+        double GetMaxSubmitUs(void);
+
+    private:
+        int numWorkers;
+        int dropPolicy;
+        bool running;
+
+        std::vector<ImageConsumer*>* consumers;
+        std::vector<std::thread>* workers;
+
+        // Every slot is either free, queued or being worked on
+        std::vector<ImageSlot>* slots;
+        std::vector<ImageSlot*>* freeSlots;
+        ArenaPool* framePool;
+        std::deque<ImageSlot*>* queue;
+        std::mutex* queueMutex;
+        std::condition_variable* queueReady;
+        bool endSignal;
+
+        std::atomic<long long> submitted;
+        std::atomic<long long> dropped;
+        std::atomic<long long> processed;
+        std::atomic<long long> queued;
+
+        // Time the acquisition thread spends handing over each image
+        std::atomic<long long> totalSubmitNs;
+        std::atomic<long long> maxSubmitNs;
+
+        void RunWorker(int worker);
+        ImageSlot* TakeSlot(void);
+        int CopyIn(ImageSlot* slot, const ImageView& img);
+        void FreeSlot(ImageSlot* slot);
+};
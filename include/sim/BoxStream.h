@@ -0,0 +1,104 @@
+#pragma once
+/*
+ *  BoxStream.h
+ *
+ *  Binary file of recorded inference results, optionally annotated with
+ *  ground truth identities and crossings, used to replay the exact same
+ *  input to the PeopleCounter. The file is laid out so that it can be
+ *  used in place, without parsing:
+ *
+ *      StreamHeader
+ *      StreamFrame[numFrames]
+ *      StreamBox[numBoxes]
+ *      StreamCrossing[numCrossings]
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include <vector>
+#include <stdint.h>
+
+#define BOX_STREAM_MAGIC   0x58424B48 // "HKBX"
+#define BOX_STREAM_VERSION 1
+
+// Ground truth ID of boxes that do not belong to anyone, and the largest
+// ID a box can carry
+#define NO_GT_ID  -1
+#define MAX_GT_ID INT16_MAX
+
+struct StreamHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numFrames;
+    uint32_t numBoxes;
+    uint32_t numCrossings;
+    uint32_t reserved;
+};
+
+struct StreamFrame {
+    double tMs;
+    uint32_t firstBox;
+    uint32_t numBoxes;
+};
+
+struct StreamBox {
+    int16_t topLeftXCoord;
+    int16_t topLeftYCoord;
+    int16_t bottomRightXCoord;
+    int16_t bottomRightYCoord;
+    int16_t classId;
+    int16_t gtId;
+    float confidence;
+};
+
+// A ground truth person leaving the frame in direction dir (LEFT/RIGHT)
+struct StreamCrossing {
+    int32_t gtId;
+    int32_t dir;
+    double tMs;
+};
+
+class BoxStream {
+    public:
+        BoxStream();
+
+        int Load(const char* path);
+        int Attach(const uint8_t* data, size_t size);
+
+        int GetNumFrames(void) const;
+        double GetFrameTime(int frame) const;
+        void GetFrame(int frame, std::vector<Spinnaker::InferenceBoundingBox>& boxes,
+                      std::vector<int>* ids) const;
+
+        int GetNumCrossings(void) const;
+        const StreamCrossing& GetCrossing(int i) const;
+
+        ~BoxStream();
+
+    private:
+        std::vector<uint8_t>* buffer;
+
+        const StreamHeader* header;
+        const StreamFrame* frames;
+        const StreamBox* boxes;
+        const StreamCrossing* crossings;
+};
+
+class BoxStreamWriter {
+    public:
+        BoxStreamWriter();
+
+        int AddFrame(double tMs, const std::vector<Spinnaker::InferenceBoundingBox>& boxes,
+                      const std::vector<int>* ids);
+        void AddCrossing(int gtId, int dir, double tMs);
+        int Save(const char* path);
+
+        ~BoxStreamWriter();
+
+    private:
+        std::vector<StreamFrame>* frames;
+        std::vector<StreamBox>* boxes;
+        std::vector<StreamCrossing>* crossings;
+};
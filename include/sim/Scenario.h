@@ -0,0 +1,77 @@
+#pragma once
+/*
+ *  Scenario.h
+ *
+ *  Synthetic stream of people walking through the frame, used to drive
+ *  the PeopleCounter without a camera. Every person has a ground truth
+ *  identity and crosses the whole frame in a straight line, so the
+ *  count the PeopleCounter should arrive at is known.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include "BoxStream.h"
+#include <vector>
+#include <stdint.h>
+
+struct SimPerson {
+    int id;
+
+    // Time in ms at which the person starts entering the frame
+    double startMs;
+
+    // Horizontal speed in pixels/ms, positive means moving left to right
+    double speed;
+
+    // Center y position and size of the bounding box in pixels
+    int y;
+    int width;
+    int height;
+};
+
+class Scenario {
+    public:
+        Scenario();
+
+        void GenerateSynthetic(double durationMs, double peoplePerHour, unsigned seed);
+        void AddPerson(SimPerson person);
+        void SetNoise(double dropRate, double jitterPx, double falsePositiveRate);
+        void SetOccluder(int x1, int x2);
+        void SetView(int x, int length);
+        int Record(BoxStreamWriter& writer, double frameMs) const;
+
+        void GetBoxes(double tMs, std::vector<Spinnaker::InferenceBoundingBox>& boxes,
+                      std::vector<int>* ids) const;
+        int GetExpectedCount(double tMs) const;
+
+        double GetDuration(void) const;
+        int GetNumPeople(void) const;
+        const SimPerson& GetPerson(int i) const;
+
+        ~Scenario();
+
+    private:
+        double durationMs;
+        unsigned seed;
+
+        // Detector noise, see SetNoise
+        double dropRate;
+        double jitter;
+        double falsePositiveRate;
+
+        // Columns of the frame hidden behind something, see SetOccluder
+        int occluderX1;
+        int occluderX2;
+
+        // Part of the trail in view, see SetView
+        int viewX;
+        int trailLength;
+
+        // Sorted by start time
+        std::vector<SimPerson>* people;
+
+        double GetEndTime(const SimPerson& person) const;
+        double Random(uint64_t a, uint64_t b, uint64_t c) const;
+};
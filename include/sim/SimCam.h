@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *  SimCam.h
+ *
+ *  Simulated camera that plays back a Scenario in real time and
+ *  delivers its bounding boxes in the same way as HikerCam. Keeps
+ *  track of how many frames were produced and how many frames each
+ *  person was visible in, so the effect of frame rate changes on
+ *  detection can be measured.
+ *
+ *  Faults can be injected at given points of the scenario, to test how
+ *  the PeopleCounter recovers from a camera that hangs or drops out.
+ *  The scenario carries on while the camera is down, so people walk by
+ *  unseen, and a restarted acquisition picks up wherever it has got to.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "BoxSource.h"
+#include "Scenario.h"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+// Stops delivering frames, leaving acquisition waiting for them
+#define SIM_FAULT_STALL 0
+
+// Acquisition fails straight away, like on a Spinnaker exception
+#define SIM_FAULT_DROP  1
+
+// How often a stalled acquisition checks whether it should give up
+#define SIM_STALL_POLL_MS 10
+
+struct SimFault {
+    int type;
+
+    // Scenario time in ms at which the fault happens, and how long after
+    // that the camera can't be set up again
+    double atMs;
+    double downMs;
+};
+
+class SimCam : public BoxSource {
+    public:
+        SimCam(Scenario* scenario);
+        ~SimCam();
+
+        int InitCamera(void);
+        void AddFault(const SimFault& fault);
+        int StartAcquisition(void);
+        void EndAcquisition(void);
+        void GetBoundingBoxData(std::vector<Spinnaker::InferenceBoundingBox>& buf);
+        int SetFrameRate(double fps);
+        WakeupJitter* GetWakeupJitter(void);
+
+        bool IsFinished(void);
+        long long GetFramesDelivered(void);
+        int GetFramesSeen(int personIdx);
+
+    private:
+        Scenario* mScenario;
+        std::atomic<bool> endAcquistionSignal;
+        std::atomic<bool> finished;
+
+        // Requested frame rate, 0 means one frame per inference
+        std::atomic<double> frameRate;
+        std::atomic<long long> framesDelivered;
+
+        std::mutex* bufferMutex;
+        std::vector<Spinnaker::InferenceBoundingBox>* boundingBoxBuffer;
+
+        // Number of delivered frames each person appeared in
+        std::vector<int>* framesSeen;
+
+        // How late each frame was produced
+        WakeupJitter* jitter;
+
+        // Clock time the scenario started at, or -1 before the first
+        // acquisition, and scenario time of the last frame
+        long long startUs;
+        double frameTime;
+
+        // Sorted by time, see AddFault
+        std::vector<SimFault>* faults;
+        size_t nextFault;
+
+        // Scenario time until which InitCamera fails
+        double downUntilMs;
+
+        double GetScenarioMs(void);
+        int Fail(const SimFault& fault);
+};
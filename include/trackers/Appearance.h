@@ -0,0 +1,38 @@
+#pragma once
+/*
+ *  Appearance.h
+ *
+ *  Cheap colour signature of the person inside a bounding box, used to
+ *  tell people apart when their boxes alone are not enough.
+ *
+ *  The middle of the box is sampled on a coarse grid and every sample is
+ *  quantized to 2 bits per channel, giving a 64 bin histogram with one
+ *  byte per bin. Two signatures are compared with the sum of absolute
+ *  differences of their bins.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include "ImageView.h"
+#include <stdint.h>
+
+// Histogram bins, 4 levels for each of R, G and B
+#define SIG_BINS 64
+
+// Samples taken across and down the box
+#define SIG_SAMPLES_X 16
+#define SIG_SAMPLES_Y 32
+
+// Distance between two signatures with no colours in common
+#define SIG_MAX_DIST 510
+
+struct Signature {
+    uint8_t bins[SIG_BINS];
+    bool valid;
+};
+
+int ComputeSignature(const ImageView& img, const Spinnaker::InferenceBoundingBox& box, Signature& sig);
+int SignatureDistance(const Signature& a, const Signature& b);
+void BlendSignature(Signature& sig, const Signature& latest);
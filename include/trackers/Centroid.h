@@ -10,15 +10,14 @@
  */
 
 #include "Tracker.h"
-#include <vector>
 
 class Centroid : public Tracker {
 public:
     Centroid(Spinnaker::InferenceBoundingBox box);
 
-    bool isBoxMatch(Spinnaker::InferenceBoundingBox box);
+    bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg);
     void updateTracker(Spinnaker::InferenceBoundingBox box);
-    int updateTracker(void);
+    int updateTracker(const TrackerConfig& cfg);
     bool getDir(void);
 
     ~Centroid();
@@ -28,5 +27,5 @@ private:
     bool dir;
 
     // Previous bounding box center
-    std:: vector<int>* centerPrev;
+    int centerPrev[2];
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+/*
+ *  FixedStateCentroid.h
+ *
+ *  StateCentroid with its state held in Q16.16 fixed point, for boards
+ *  without a fast FPU. It makes the same decisions as StateCentroid, but
+ *  the matching is done on integers: distances are compared squared, and
+ *  the box diagonals are compared without taking square roots.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include <stdint.h>
+
+// Fractional bits of the fixed point state
+#define FIXED_SHIFT 16
+#define FIXED_ONE   (1 << FIXED_SHIFT)
+
+class FixedStateCentroid : public Tracker {
+    public:
+        FixedStateCentroid(Spinnaker::InferenceBoundingBox box);
+
+        bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg);
+        void updateTracker(Spinnaker::InferenceBoundingBox box);
+        int updateTracker(const TrackerConfig& cfg);
+        bool getDir(void);
+
+        ~FixedStateCentroid();
+
+    private:
+        // Lets the benchmarks time the private hot paths
+        friend class TrackerBench;
+
+        /*
+         * Same state as StateCentroid:
+         *      state[0] = x position in pixels, Q16.16
+         *      state[1] = y position in pixels, Q16.16
+         *      state[2] = x velocity in pixels/ms, Q16.16
+         *      state[3] = square of the length of the box diagonal
+         */
+        int32_t state[4];
+
+        void MakeStateVector(Spinnaker::InferenceBoundingBox box, int32_t* out);
+};
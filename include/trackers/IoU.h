@@ -0,0 +1,74 @@
+#pragma once
+/*
+ *  IoU.h
+ *
+ *  Class for tracking an InferenceBoundingBox by how much it overlaps the
+ *  box the tracker predicts for this frame, from the last box it matched
+ *  and its velocity.
+ *
+ *  Rather than comparing each box against each tracker in turn, the
+ *  PeopleCounter hands the whole frame to matchFrame, which computes the
+ *  intersection over union of every box with every predicted box in one
+ *  pass of a vector kernel and then assigns the pairs with the most
+ *  overlap first.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include <vector>
+#include <stdint.h>
+
+// Number of track boxes handled by one pass of the kernel. Track arrays
+// are padded to a multiple of this with empty boxes.
+#define IOU_LANES 8
+#define IOU_PAD(n) (((n) + IOU_LANES - 1) & ~(IOU_LANES - 1))
+
+// Weight of the newest movement in the smoothed velocity
+#define IOU_VEL_SMOOTHING 0.5
+
+// Walking speed in pixels/ms assumed for a new box, towards the far side
+// of the frame, until it has been seen twice
+#define IOU_INIT_SPEED 0.25
+
+class IoU : public Tracker {
+    public:
+        IoU(Spinnaker::InferenceBoundingBox box);
+
+        bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg);
+        void updateTracker(Spinnaker::InferenceBoundingBox box);
+        int updateTracker(const TrackerConfig& cfg);
+        bool getDir(void);
+
+        void getPredictedBox(int16_t* out);
+
+        static bool matchFrame(const std::vector<Spinnaker::InferenceBoundingBox>& boxes,
+                               const std::vector<IoU*>& trackers, const TrackerConfig& cfg,
+                               std::vector<int>& matches);
+
+        ~IoU();
+
+    private:
+        // Box last matched: top left x, y and bottom right x, y
+        int16_t box[4];
+
+        // Smoothed velocity of the box center in pixels per frame
+        double velX;
+        double velY;
+
+        // Center x of the first box, to tell the direction of travel
+        int startX;
+};
+
+/*
+ * Fills iou with the intersection over union of every box against every
+ * track box, one row of trackStride values per box.
+ *
+ * boxes holds x1, y1, x2, y2 of each box one after the other. tracks
+ * holds four rows of trackStride values (all the x1, then all the y1,
+ * x2 and y2) and trackAreas the area of each track box. trackStride must
+ * be a multiple of IOU_LANES, with empty boxes in the padding.
+ */
+void IoUMatrix(const int16_t* boxes, int numBoxes, const int16_t* tracks, const int32_t* trackAreas,
+               int trackStride, float* iou);
@@ -17,28 +17,31 @@ class Kalman : public Tracker {
     public:
         Kalman(Spinnaker::InferenceBoundingBox box);
 
-        bool isBoxMatch(Spinnaker::InferenceBoundingBox box);
+        bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg);
         void updateTracker(Spinnaker::InferenceBoundingBox box);
-        int updateTracker(void);
+        int updateTracker(const TrackerConfig& cfg);
         bool getDir(void);
 
         ~Kalman();
 
     private:
+        // Lets the benchmarks time the private hot paths
+        friend class TrackerBench;
+
         /* 
          * This is a 4-element vector containing the current
          * estimate of :
-         *      (*x)[0] = x position in pixels
-         *      (*x)[1] = y position in pixels
-         *      (*x)[2] = x velocity in pixels/ms 
-         *      (*x)[3] = length of box diagonal
+         *      x[0] = x position in pixels
+         *      x[1] = y position in pixels
+         *      x[2] = x velocity in pixels/ms 
+         *      x[3] = length of box diagonal
          *
          * Note that the velocity is relative to the point (0,0), so a 
          * positive velocity means that the box is moving from right to left
          * in the frame. And if there is a negative velocity, the box is moving
          * from left to right.
          */
-        std::vector<double>* x;
+        double x[4];
 
         // Covariance matrix (P)
         double cov[4][4];
@@ -55,9 +58,9 @@ class Kalman : public Tracker {
                                       {0, 0, 0, 1}};
 
         // Filter function
-        std::vector<double> Predict(void);
-        void Update(std::vector<double> obsState, double obsCov[][4]);
-        std::vector<double> MakeStateVector(Spinnaker::InferenceBoundingBox box);
+        void Predict(double* out);
+        void Update(const double* obs, double obsCov[][4]);
+        void MakeStateVector(Spinnaker::InferenceBoundingBox box, double* out);
 
         // Matrix utility functions
         void matMultiply(const double mat1[][4], const double mat2[][4], double res[][4]);
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ *  ReIdentifier.h
+ *
+ *  Holds on to trackers that expired in the middle of the frame for a
+ *  short time, so that a person who walks behind a signpost or another
+ *  hiker and comes out on the other side keeps their tracker instead of
+ *  being counted twice.
+ *
+ *  Appearance signatures are only taken when the boxes alone can't tell
+ *  people apart: while more than one person is in view, and when a new
+ *  box could belong to one of the expired trackers. A frame with a
+ *  single person in it costs nothing extra.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include "Appearance.h"
+#include <unordered_map>
+
+// Frames an expired tracker can still be matched for
+#define REID_WINDOW 25
+
+// Expired trackers held at once, the oldest are counted first
+#define REID_MAX_EXPIRED 16
+
+// Trackers last seen this close to the edge have left the frame
+#define REID_EDGE_MARGIN 50
+
+// How far a hidden person can get before reappearing, in pixels
+#define REID_MAX_DIST_X 400
+#define REID_MAX_DIST_Y 100
+
+// Largest signature distance still taken to be the same person
+#define REID_SIG_THRESH 120
+
+// Frames between signature updates of each track while crowded
+#define REID_REFRESH 8
+
+struct ExpiredTracker {
+    Tracker* tr;
+    int frame;
+    Signature sig;
+};
+
+class ReIdentifier {
+    public:
+        ReIdentifier();
+        ~ReIdentifier();
+
+        void BeginFrame(const ImageView* img);
+        void UpdateSignature(Tracker* tr, const Spinnaker::InferenceBoundingBox& box);
+        bool Bury(Tracker* tr);
+        Tracker* Revive(const Spinnaker::InferenceBoundingBox& box);
+        Tracker* Collect(void);
+        Tracker* Drain(void);
+        void Forget(Tracker* tr);
+
+        int GetRevived(void);
+        int GetSignaturesTaken(void);
+
+    private:
+        const ImageView* image;
+        int frame;
+
+        ExpiredTracker expired[REID_MAX_EXPIRED];
+        int numExpired;
+
+        // Signatures of the live trackers, by tracker ID
+        std::unordered_map<int, Signature>* signatures;
+
+        int revived;
+        int signaturesTaken;
+
+        bool IsPlausible(const ExpiredTracker& e, const Spinnaker::InferenceBoundingBox& box);
+        void RemoveExpired(int i);
+};
@@ -15,28 +15,31 @@ class StateCentroid : public Tracker {
 	public:
 		StateCentroid(Spinnaker::InferenceBoundingBox box);
 
-        bool isBoxMatch(Spinnaker::InferenceBoundingBox box);
+        bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg);
         void updateTracker(Spinnaker::InferenceBoundingBox box);
-        int updateTracker(void);;
+        int updateTracker(const TrackerConfig& cfg);
         bool getDir(void);
 
         ~StateCentroid();
 
     private:
+        // Lets the benchmarks time the private hot paths
+        friend class TrackerBench;
+
         /*
          * This is a 4-element vector containing the current
          * estimate of :
-         *      (*x)[0] = x position in pixels
-         *      (*x)[1] = y position in pixels
-         *      (*x)[2] = x velocity in pixels/ms
-         *      (*x)[3] = length of box diagonal
+         *      state[0] = x position in pixels
+         *      state[1] = y position in pixels
+         *      state[2] = x velocity in pixels/ms
+         *      state[3] = length of box diagonal
          *
          * Note that the velocity is relative to the point (0,0), so a
          * positive velocity means that the box is moving from right to left
          * in the frame. And if there is a negative velocity, the box is moving
          * from left to right.
          */
-        std::vector<double>* state;
+        double state[4];
 
-        std::vector<double> MakeStateVector(Spinnaker::InferenceBoundingBox box);
+        void MakeStateVector(Spinnaker::InferenceBoundingBox box, double* out);
 };
\ No newline at end of file
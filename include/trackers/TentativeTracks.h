@@ -0,0 +1,65 @@
+#pragma once
+/*
+ *  TentativeTracks.h
+ *
+ *  Boxes that no tracker matched start out as tentative tracks in a fixed
+ *  buffer, and a real tracker is only made for them once they have been
+ *  seen in confirmHits of the last confirmFrames frames. A spurious
+ *  detection that shows up for a frame or two never gets a tracker, so it
+ *  costs no allocation and is never counted.
+ *
+ *  A track goes from tentative to confirmed when it is promoted, and from
+ *  confirmed to coasting while its tracker is missing boxes (see
+ *  Tracker::getState).
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Tracker.h"
+#include <stdint.h>
+
+// Tentative tracks held at once. When the buffer is full, new boxes are
+// ignored until a slot frees up.
+#define TENTATIVE_MAX 64
+
+// How far a tentative box can move per frame and still match, in pixels
+#define TENTATIVE_GATE_X 120
+#define TENTATIVE_GATE_Y 40
+
+struct TentativeTrack {
+    Spinnaker::InferenceBoundingBox lastBox;
+
+    // Bit n is set if the track was seen n frames ago
+    uint32_t history;
+
+    // ID the tracker gets if the track is promoted
+    int id;
+
+    bool active;
+};
+
+class TentativeTracks {
+    public:
+        TentativeTracks();
+
+        void BeginFrame(const TrackerConfig& cfg);
+        int Match(const Spinnaker::InferenceBoundingBox& box);
+        int Add(const Spinnaker::InferenceBoundingBox& box, int id);
+        bool IsConfirmed(int slot, const TrackerConfig& cfg);
+        int GetId(int slot);
+        void Promote(int slot);
+
+        int GetActive(void);
+        long long GetCreated(void);
+        long long GetPromoted(void);
+        long long GetRejected(void);
+
+    private:
+        TentativeTrack slots[TENTATIVE_MAX];
+        int numActive;
+
+        long long created;
+        long long promoted;
+        long long rejected;
+};
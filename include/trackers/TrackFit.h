@@ -0,0 +1,56 @@
+#pragma once
+/*
+ *  TrackFit.h
+ *
+ *  Least squares fit of a track's x position against time, kept as
+ *  running sums so each frame costs a few additions and no history is
+ *  stored. Each box is weighted by the detector's confidence in it.
+ *
+ *  The direction a person walked is the sign of the fitted slope, which
+ *  a few jittery boxes at the end of the track can't flip the way they
+ *  can the last velocity estimate. It is only trusted once the slope is
+ *  FIT_MIN_T standard errors away from zero, otherwise the tracker falls
+ *  back to its own guess. Short tracks are where this matters most, so
+ *  the bar is low.
+ *
+ *  The sums are integers, so every tracker (fixed point or not) fits the
+ *  same boxes the same way. Floating point is only used when the
+ *  direction is asked for.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <stdint.h>
+
+// Boxes a track needs before the fit is trusted
+#define FIT_MIN_POINTS 3
+
+// Standard errors the slope must be from zero to be trusted
+#define FIT_MIN_T 1.0
+
+class TrackFit {
+    public:
+        TrackFit();
+
+        void Add(int x, float confidence);
+        void Tick(void);
+
+        int GetDir(void) const;
+        double GetSlope(void) const;
+        double GetSlopeT(void) const;
+        int GetPoints(void) const;
+
+    private:
+        // Frames since the track started
+        int64_t t;
+        int points;
+
+        // Weighted sums of 1, t, x, t^2, t*x and x^2
+        int64_t sw;
+        int64_t swt;
+        int64_t swx;
+        int64_t swtt;
+        int64_t swtx;
+        int64_t swxx;
+};
@@ -0,0 +1,64 @@
+#pragma once
+/*
+ *  TrackStats.h
+ *
+ *  Distributions of how fast people walked and how long they were in
+ *  view, for one camera, in buckets of time (an hour by default). Each
+ *  path that ends is summarised and added to the TDigests of the bucket
+ *  it ended in. The buckets are allocated up front and reused in a ring,
+ *  so the memory doesn't grow however long the camera runs; the oldest
+ *  bucket is cleared when time moves past the end of the ring.
+ *
+ *  Any range of buckets, from any number of cameras, can be rolled up
+ *  into one pair of digests, e.g. a day for the whole site.
+ *
+ *  Speeds are in pixels per second from where a person was first seen to
+ *  where they were last seen, since the camera isn't calibrated to the
+ *  ground. Buckets start at multiples of the bucket length on the
+ *  PeopleCounter's clock.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Trajectories.h"
+#include "TDigest.h"
+#include <mutex>
+
+#define STATS_BUCKET_MS (60 * 60 * 1000LL)
+
+// Buckets kept, two days of hours
+#define STATS_BUCKETS 48
+
+struct StatsBucket {
+    // -1 while the bucket is unused
+    long long startMs;
+    long long tracks;
+
+    TDigest speed;
+    TDigest inView;
+};
+
+class TrackStats : public PathListener {
+    public:
+        TrackStats(int cameraId = 0, long long bucketMs = STATS_BUCKET_MS, int numBuckets = STATS_BUCKETS);
+        ~TrackStats();
+
+        void OnPathEnd(const TrajRecord& rec);
+        long long Rollup(long long fromMs, long long toMs, TDigest* speed, TDigest* inView);
+
+        int GetCameraId(void);
+        long long GetBucketMs(void);
+        size_t GetMemory(void);
+        void PrintReport(long long nowMs);
+
+    private:
+        int cameraId;
+        long long bucketMs;
+        int numBuckets;
+
+        // Guarded by the mutex, since tracks are added on the tracking
+        // thread and rolled up on another
+        StatsBucket* buckets;
+        std::mutex* mutex;
+};
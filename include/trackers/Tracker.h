@@ -10,9 +10,9 @@
 
 #include "Spinnaker.h"
 #include "SpinGenApi/SpinnakerGenApi.h"
-
-// Number of frames that a bounding box is missing from before it is deleted
-#define MISSING_THRESH 5
+#include "TrackerConfig.h"
+#include "TrackFit.h"
+#include <vector>
 
 // Camera resolution
 #define CAM_X            1440
@@ -22,25 +22,111 @@
 #define CAM_MS_PER_FRAME 40
 #define INFERENCE_TIME   160
 
+// Class ID of a person in the network output
+#define PERSON_ID 15
+
 // Directions into/out of frame
 #define LEFT  0
 #define RIGHT 1
 
+// Track lifecycle. Tentative tracks have no tracker yet (see
+// TentativeTracks.h), confirmed ones were matched in the last frame and
+// coasting ones are missing boxes but haven't expired.
+#define TRACK_TENTATIVE 0
+#define TRACK_CONFIRMED 1
+#define TRACK_COASTING  2
+
 class Tracker {
     public:
-        virtual bool isBoxMatch(Spinnaker::InferenceBoundingBox box) = 0;
+        Tracker() : path(-1) {}
+        virtual ~Tracker() {}
+
+        virtual bool isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg) = 0;
         virtual void updateTracker(Spinnaker::InferenceBoundingBox box) = 0;
         virtual bool getDir(void) = 0;
 
-        int updateTracker(void) {
+        int updateTracker(const TrackerConfig& cfg) {
+            fit.Tick();
             count++;
-            if (count > MISSING_THRESH)
+            if (count > cfg.missingThresh)
                 return -1;
             else
                 return 0;
         }
 
+        /*
+         * The missing counter goes up at the end of every frame, so a
+         * tracker matched in the last frame has a count of one.
+         */
+        int getState(void) {
+            return (count <= 1) ? TRACK_CONFIRMED : TRACK_COASTING;
+        }
+
+        int getId(void) {
+            return id;
+        }
+
+        void setId(int newId) {
+            id = newId;
+        }
+
+        const Spinnaker::InferenceBoundingBox& getLastBox(void) {
+            return lastBox;
+        }
+
+        /*
+         * Called with every box the tracker is matched to, including the
+         * one it was made for.
+         */
+        void setLastBox(const Spinnaker::InferenceBoundingBox& box) {
+            lastBox = box;
+            fit.Add((box.rect.topLeftXCoord + box.rect.bottomRightXCoord) / 2, box.confidence);
+        }
+
+        /*
+         * Slot of the tracker's path in the PeopleCounter's Trajectories,
+         * or -1 if it has none.
+         */
+        int getPath(void) {
+            return path;
+        }
+
+        void setPath(int slot) {
+            path = slot;
+        }
+
+        /*
+         * Fit of the x positions of every box the tracker was matched to.
+         * getDir goes by its slope once it is sure of it.
+         */
+        const TrackFit& getFit(void) {
+            return fit;
+        }
+
+        /*
+         * Trackers that match a whole frame of boxes at once hide this with
+         * their own version, which fills matches with the index of the
+         * tracker for each box (-1 for none) and returns true. Otherwise
+         * the PeopleCounter tries isBoxMatch on each tracker in turn.
+         */
+        template <class T>
+        static bool matchFrame(const std::vector<Spinnaker::InferenceBoundingBox>& /* boxes */,
+                               const std::vector<T*>& /* trackers */, const TrackerConfig& /* cfg */,
+                               std::vector<int>& /* matches */) {
+            return false;
+        }
+
     protected:
         // Counter for how many frames this has not appeared in
         int count;
+
+        // Unique ID assigned by the PeopleCounter
+        int id;
+
+        // Box this tracker was last matched to
+        Spinnaker::InferenceBoundingBox lastBox;
+
+        TrackFit fit;
+
+        int path;
 };
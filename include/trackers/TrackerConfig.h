@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *  TrackerConfig.h
+ *
+ *  Thresholds used to match bounding boxes to trackers and to decide when
+ *  a person has left the frame. The defines are the values the trackers
+ *  were tuned with and are used as the defaults; the PeopleCounter passes
+ *  a TrackerConfig to the trackers so they can be changed without
+ *  recompiling.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+// Number of frames that a bounding box is missing from before it is deleted
+#define MISSING_THRESH 5
+
+// Minimum confidence for a box to be tracked
+#define CONFIDENCE_THRESH 0.70
+
+// Centroid: maximum x distance in pixels between matching box centers
+#define DIST_TOLERANCE 300
+
+// Kalman: maximum distance between the predicted and observed state
+#define DIST_THRESH 200
+
+// StateCentroid: differences in state above which boxes don't match
+#define DIST_X_THRESH   200
+#define DIST_Y_THRESH   20
+#define VEL_X_THRESH    2
+#define BOX_SIZE_THRESH 100
+
+// IoU: minimum overlap between a box and the box predicted by a tracker
+#define IOU_THRESH 0.3
+
+// Tentative tracks: a tracker is made once a box has been seen in
+// CONFIRM_HITS of the last CONFIRM_FRAMES frames
+#define CONFIRM_HITS   3
+#define CONFIRM_FRAMES 5
+
+// Most frames the history of a tentative track can hold
+#define CONFIRM_FRAMES_MAX 32
+
+struct TrackerConfig {
+    int missingThresh;
+    double confidenceThresh;
+    double distTolerance;
+    double distThresh;
+    double distXThresh;
+    double distYThresh;
+    double velXThresh;
+    double boxSizeThresh;
+    double iouThresh;
+    int confirmHits;
+    int confirmFrames;
+
+    TrackerConfig() : missingThresh(MISSING_THRESH),
+                      confidenceThresh(CONFIDENCE_THRESH),
+                      distTolerance(DIST_TOLERANCE),
+                      distThresh(DIST_THRESH),
+                      distXThresh(DIST_X_THRESH),
+                      distYThresh(DIST_Y_THRESH),
+                      velXThresh(VEL_X_THRESH),
+                      boxSizeThresh(BOX_SIZE_THRESH),
+                      iouThresh(IOU_THRESH),
+                      confirmHits(CONFIRM_HITS),
+                      confirmFrames(CONFIRM_FRAMES) {}
+};
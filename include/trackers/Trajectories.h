@@ -0,0 +1,148 @@
+#pragma once
+/*
+ *  Trajectories.h
+ *
+ *  The path each person took through the frame, for analytics like dwell
+ *  time, walking speed and routes. Every track gets a slot in a table
+ *  allocated up front, holding up to TRAJ_POINTS timestamped footprints
+ *  next to each other, so the memory a track can use is fixed and known
+ *  before the first frame.
+ *
+ *  Points are added as they come. When a slot is full, the point that
+ *  can best be rebuilt from its neighbours is dropped: the one closest
+ *  to where the person would have been had they walked straight and at
+ *  a steady pace from the point before to the point after. Straight walks
+ *  end up as a few points, while stops keep the time they started and
+ *  ended, so someone standing around for an hour never overflows. The
+ *  first and last points are always kept.
+ *
+ *  When a track is counted its path is handed to every PathListener, like
+ *  the TrackStats, and to a TrajectoryLog, which appends it to a binary
+ *  file from a thread of its own:
+ *
+ *      TrajLogHeader
+ *      for every track: TrajRecordHead, TrajPoint[numPoints]
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Spinnaker.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+
+#define TRAJ_LOG_MAGIC   0x4A544B48 // "HKTJ"
+#define TRAJ_LOG_VERSION 1
+
+// Points kept per track
+#define TRAJ_POINTS 32
+
+// Tracks that can have a path at once. Tracks started while the table is
+// full go without one.
+#define TRAJ_MAX_TRACKS 256
+
+// Ended paths waiting to be written. More than that are dropped.
+#define TRAJ_LOG_DEPTH 64
+
+struct TrajLogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t maxPoints;
+    uint32_t reserved;
+};
+
+// Footprint (bottom middle of the box) at a time since the track started
+struct TrajPoint {
+    int32_t tMs;
+    int16_t x;
+    int16_t y;
+};
+
+struct TrajRecordHead {
+    int32_t trackId;
+    int16_t dir;
+    int16_t numPoints;
+    int64_t startMs;
+};
+
+struct TrajRecord {
+    TrajRecordHead head;
+    TrajPoint points[TRAJ_POINTS];
+};
+
+/*
+ * Anything that wants the path of every track that ends. Called on the
+ * tracking thread, so implementations must return quickly.
+ */
+class PathListener {
+    public:
+        virtual ~PathListener() {}
+
+        virtual void OnPathEnd(const TrajRecord& rec) = 0;
+};
+
+class TrajectoryLog {
+    public:
+        TrajectoryLog(int depth = TRAJ_LOG_DEPTH);
+        ~TrajectoryLog();
+
+        int Open(const char* path);
+        void Close(void);
+        void Write(TrajRecord& rec);
+
+        long long GetWritten(void);
+        long long GetDropped(void);
+
+    private:
+        FILE* file;
+        SpscQueue<TrajRecord>* queue;
+        std::thread* writer;
+        std::atomic<long long> written;
+
+        void RunWriter(void);
+};
+
+class Trajectories {
+    public:
+        Trajectories(int maxTracks = TRAJ_MAX_TRACKS);
+        ~Trajectories();
+
+        int Start(int trackId, long long nowMs);
+        void Add(int slot, const Spinnaker::InferenceBoundingBox& box, long long nowMs);
+        void End(int slot, int dir);
+        const TrajRecord* Get(int slot);
+
+        int OpenLog(const char* path);
+        TrajectoryLog* GetLog(void);
+        void AddListener(PathListener* listener);
+
+        int GetActive(void);
+        size_t GetMemory(void);
+        long long GetEnded(void);
+        long long GetUntracked(void);
+        long long GetSimplified(void);
+        void PrintReport(void);
+
+    private:
+        int maxTracks;
+
+        // maxTracks slots in one block, and the ones not in use
+        TrajRecord* table;
+        int* freeSlots;
+        int numFree;
+
+        TrajectoryLog* log;
+        std::vector<PathListener*>* listeners;
+
+        long long ended;
+        long long untracked;
+        long long simplified;
+
+        void Simplify(TrajRecord& rec);
+};
+
+int LoadTrajectories(const char* path, std::vector<TrajRecord>& records);
@@ -0,0 +1,101 @@
+#pragma once
+/*
+ *  Arena.h
+ *
+ *  Memory for the structures whose size depends on the traffic (trackers,
+ *  boxes, images in flight), taken in a single allocation at startup so
+ *  that memory use is known up front and nothing is allocated while
+ *  counting.
+ *
+ *  Each structure adds a pool of fixed size slots before the arena is
+ *  committed. A pool can be used as a free list (Take/Give) or as a plain
+ *  array (GetSlot/NoteUsed). Pools keep a high water mark of the slots in
+ *  use and count the times they were full, so the capacities can be
+ *  checked against real traffic with PrintReport. A pool with a slot size
+ *  of 0 takes no memory and only keeps the counts, for structures that
+ *  reserve their own storage at startup.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Default capacities of each structure
+#define ARENA_FRAMES_IN_FLIGHT  4
+#define ARENA_BOXES_PER_FRAME   64
+#define ARENA_TRACKS_PER_CAMERA 64
+#define ARENA_MAX_IMAGE_BYTES   (1440 * 1080 * 3)
+
+// Most pools an arena can hold
+#define ARENA_MAX_POOLS 16
+
+// Every slot starts on a multiple of this
+#define ARENA_ALIGN 64
+
+struct ArenaCaps {
+    int framesInFlight;
+    int boxesPerFrame;
+    int tracksPerCamera;
+    size_t maxImageBytes;
+
+    ArenaCaps() : framesInFlight(ARENA_FRAMES_IN_FLIGHT),
+                  boxesPerFrame(ARENA_BOXES_PER_FRAME),
+                  tracksPerCamera(ARENA_TRACKS_PER_CAMERA),
+                  maxImageBytes(ARENA_MAX_IMAGE_BYTES) {}
+};
+
+class ArenaPool {
+    public:
+        ArenaPool();
+
+        void* Take(void);
+        void Give(void* p);
+
+        void* GetSlot(int i);
+        bool NoteUsed(int used);
+        void NoteRefused(void);
+
+        const char* GetName(void);
+        size_t GetSlotSize(void);
+        int GetSlots(void);
+        int GetHighWater(void);
+        long long GetRefused(void);
+
+    private:
+        friend class Arena;
+
+        const char* name;
+        size_t slotSize;
+        int slots;
+        uint8_t* base;
+
+        // Free slots are linked through their first bytes
+        void* freeList;
+        int inUse;
+
+        std::atomic<int> highWater;
+        std::atomic<long long> refused;
+};
+
+class Arena {
+    public:
+        Arena();
+        ~Arena();
+
+        ArenaPool* AddPool(const char* name, size_t slotSize, int slots);
+        int Commit(void);
+        bool IsCommitted(void);
+
+        size_t GetSize(void);
+        void PrintReport(void);
+
+    private:
+        ArenaPool pools[ARENA_MAX_POOLS];
+        int numPools;
+
+        uint8_t* block;
+        size_t size;
+};
@@ -0,0 +1,226 @@
+#pragma once
+/*
+ *  Channel.h
+ *
+ *  Bounded queue between two coroutine stages running on an Executor.
+ *  Push waits for room and Pop waits for an item, so a slow stage holds
+ *  the stages before it back instead of letting frames pile up. Items
+ *  are swapped in and out of a fixed ring, so items that own buffers
+ *  (like vectors of boxes) are recycled rather than reallocated.
+ *
+ *  One coroutine may push and one may pop at a time.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Executor.h"
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template <class T>
+class Channel {
+    public:
+        Channel(Executor* executor, int capacity);
+
+        /*
+         * The flags are only written with the channel locked, before the
+         * coroutine can be woken up, since it may be resumed on another
+         * thread as soon as the lock is released.
+         */
+        struct PushAwaiter {
+            Channel* ch;
+            T* item;
+            bool ok;
+            bool waited;
+
+            bool await_ready(void) {
+                return false;
+            }
+            bool await_suspend(std::coroutine_handle<> h) {
+                return ch->PushOrWait(*item, h, &ok, &waited);
+            }
+            bool await_resume(void) {
+                if (waited)
+                    ch->PushOrWait(*item, std::coroutine_handle<>(), &ok, &waited);
+                return ok;
+            }
+        };
+
+        struct PopAwaiter {
+            Channel* ch;
+            T* item;
+            bool ok;
+            bool waited;
+
+            bool await_ready(void) {
+                return false;
+            }
+            bool await_suspend(std::coroutine_handle<> h) {
+                return ch->PopOrWait(*item, h, &ok, &waited);
+            }
+            bool await_resume(void) {
+                if (waited)
+                    ch->PopOrWait(*item, std::coroutine_handle<>(), &ok, &waited);
+                return ok;
+            }
+        };
+
+        PushAwaiter Push(T& item);
+        PopAwaiter Pop(T& item);
+        void Close(void);
+
+        int GetSize(void);
+        int GetHighWater(void);
+
+    private:
+        Executor* executor;
+        std::mutex lock;
+
+        std::vector<T> ring;
+        int head;
+        int size;
+        int highWater;
+        bool closed;
+
+        // Coroutines waiting for room and for an item
+        std::coroutine_handle<> pusher;
+        std::coroutine_handle<> popper;
+
+        bool PushOrWait(T& item, std::coroutine_handle<> h, bool* ok, bool* waited);
+        bool PopOrWait(T& item, std::coroutine_handle<> h, bool* ok, bool* waited);
+};
+
+/******************* Function Definitions ******************/
+template <class T>
+Channel<T>::Channel(Executor* executor, int capacity) : executor(executor), ring(capacity), head(0), size(0),
+                                                         highWater(0), closed(false) {
+}
+
+/*
+ * Swaps the item into the channel, waiting for room if it is full. The
+ * item is left with whatever the slot held before. Resumes with false,
+ * and the item untouched, if the channel was closed.
+ */
+template <class T>
+typename Channel<T>::PushAwaiter Channel<T>::Push(T& item) {
+    return PushAwaiter{ this, &item, false, false };
+}
+
+/*
+ * Swaps the oldest item out of the channel, waiting for one if it is
+ * empty. Resumes with false once the channel is closed and empty.
+ */
+template <class T>
+typename Channel<T>::PopAwaiter Channel<T>::Pop(T& item) {
+    return PopAwaiter{ this, &item, false, false };
+}
+
+/*
+ * Wakes up both sides. Items already in the channel can still be popped.
+ */
+template <class T>
+void Channel<T>::Close(void) {
+    std::coroutine_handle<> wakePusher;
+    std::coroutine_handle<> wakePopper;
+
+    lock.lock();
+    closed = true;
+    std::swap(wakePusher, pusher);
+    std::swap(wakePopper, popper);
+    lock.unlock();
+
+    if (wakePusher)
+        executor->Schedule(wakePusher);
+    if (wakePopper)
+        executor->Schedule(wakePopper);
+}
+
+template <class T>
+int Channel<T>::GetSize(void) {
+    std::lock_guard<std::mutex> guard(lock);
+    return size;
+}
+
+/*
+ * Most items the channel has held at once.
+ */
+template <class T>
+int Channel<T>::GetHighWater(void) {
+    std::lock_guard<std::mutex> guard(lock);
+    return highWater;
+}
+
+/*
+ * Pushes the item if there is room, waking the popper. Otherwise h is
+ * kept to be woken up once there is, and true is returned so the
+ * coroutine suspends.
+ */
+template <class T>
+bool Channel<T>::PushOrWait(T& item, std::coroutine_handle<> h, bool* ok, bool* waited) {
+    std::coroutine_handle<> wake;
+
+    lock.lock();
+    if (closed) {
+        *ok = false;
+        *waited = false;
+    }
+    else if (size == (int)ring.size()) {
+        *waited = true;
+        pusher = h;
+        lock.unlock();
+        return true;
+    }
+    else {
+        std::swap(ring[(head + size) % ring.size()], item);
+        size++;
+        if (size > highWater)
+            highWater = size;
+
+        *ok = true;
+        *waited = false;
+        std::swap(wake, popper);
+    }
+    lock.unlock();
+
+    if (wake)
+        executor->Schedule(wake);
+    return false;
+}
+
+/*
+ * Pops the oldest item if there is one, waking the pusher. Otherwise h
+ * is kept to be woken up once there is, and true is returned so the
+ * coroutine suspends.
+ */
+template <class T>
+bool Channel<T>::PopOrWait(T& item, std::coroutine_handle<> h, bool* ok, bool* waited) {
+    std::coroutine_handle<> wake;
+
+    lock.lock();
+    if (size > 0) {
+        std::swap(ring[head], item);
+        head = (head + 1) % ring.size();
+        size--;
+
+        *ok = true;
+        *waited = false;
+        std::swap(wake, pusher);
+    }
+    else if (closed) {
+        *ok = false;
+        *waited = false;
+    }
+    else {
+        *waited = true;
+        popper = h;
+        lock.unlock();
+        return true;
+    }
+    lock.unlock();
+
+    if (wake)
+        executor->Schedule(wake);
+    return false;
+}
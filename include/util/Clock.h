@@ -0,0 +1,93 @@
+#pragma once
+/*
+ *  Clock.h
+ *
+ *  Where the cameras and the PeopleCounter get the time from and sleep
+ *  on, so a recording can be replayed on a simulated clock instead of in
+ *  real time:
+ *
+ *      SteadyClock     the real, monotonic clock, used unless told otherwise
+ *      SimClock        only moves when someone sleeps on it or a frame's
+ *                      timestamp says so, so sleeping costs nothing and
+ *                      every run sees the same times
+ *
+ *  The trackers step their state per frame rather than per millisecond,
+ *  so they don't need a clock.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+
+class Clock {
+    public:
+        virtual ~Clock() {}
+
+        // Microseconds since some fixed point
+        virtual long long NowUs(void) = 0;
+        virtual void SleepUntilUs(long long wakeupUs) = 0;
+
+        // A camera received a frame stamped with the camera's own clock
+        virtual void OnFrameStamp(long long /* stampUs */) {}
+
+        long long NowMs(void) {
+            return NowUs() / 1000;
+        }
+
+        void SleepForUs(long long us) {
+            SleepUntilUs(NowUs() + us);
+        }
+};
+
+class SteadyClock : public Clock {
+    public:
+        long long NowUs(void);
+        void SleepUntilUs(long long wakeupUs);
+};
+
+/*
+ * Time stands still until a sleep or a frame moves it forward, never
+ * back. Sleeping returns straight away, so it is only meant for replays
+ * where one thread does everything, see PeopleCounter::Replay.
+ */
+class SimClock : public Clock {
+    public:
+        SimClock(long long startUs = 0);
+
+        long long NowUs(void);
+        void SleepUntilUs(long long wakeupUs);
+        void OnFrameStamp(long long stampUs);
+        void AdvanceTo(long long us);
+
+    private:
+        std::atomic<long long> nowUs;
+
+        // Camera timestamp that lines up with the start of the clock
+        long long firstStampUs;
+        bool stamped;
+};
+
+/*
+ * Wakes up every period on a clock. Each wakeup is set from the last one
+ * rather than from when the caller got round to waiting, so time spent
+ * working doesn't add up into drift. Ticks that were missed altogether
+ * are skipped rather than run back to back.
+ */
+class PeriodicTimer {
+    public:
+        PeriodicTimer(Clock* clock, long long periodUs);
+
+        void SetPeriodUs(long long periodUs);
+        long long Wait(void);
+        long long GetOverruns(void);
+
+    private:
+        Clock* clock;
+        long long periodUs;
+        long long nextUs;
+        bool started;
+        long long overruns;
+};
+
+Clock* GetSteadyClock(void);
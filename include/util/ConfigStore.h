@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *  ConfigStore.h
+ *
+ *  Holds the current TrackerConfig and lets it be replaced while the
+ *  tracking thread is running. Every version of the config is immutable;
+ *  a new version is published by swapping a pointer, and the tracking
+ *  thread picks up the latest version at the start of each frame.
+ *
+ *  The reader side (Acquire/Release) never locks or waits. Only one
+ *  thread may read from a ConfigStore; each PeopleCounter has its own.
+ *  Other threads can take a copy of the latest config with Copy.
+ *
+ *  Configs are loaded from XML files of the form:
+ *
+ *      <TrackerConfig>
+ *          <MISSING_THRESH>5</MISSING_THRESH>
+ *          <DIST_X_THRESH>200</DIST_X_THRESH>
+ *          ...
+ *      </TrackerConfig>
+ *
+ *  where the element names are the defines in TrackerConfig.h. Any
+ *  threshold that is left out keeps its default value. A file is
+ *  rejected if MISSING_THRESH is 0, CONFIRM_HITS is more than
+ *  CONFIRM_FRAMES, or CONFIRM_FRAMES is more than CONFIRM_FRAMES_MAX.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "TrackerConfig.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ConfigStore {
+    public:
+        ConfigStore();
+
+        const TrackerConfig* Acquire(void);
+        void Release(void);
+        void Copy(TrackerConfig& cfg);
+
+        void Publish(const TrackerConfig& cfg);
+        int LoadFile(const char* path);
+        int ReloadIfChanged(void);
+
+        ~ConfigStore();
+
+    private:
+        std::atomic<const TrackerConfig*> current;
+
+        // Version the reader is currently using, which must not be freed
+        std::atomic<const TrackerConfig*> inUse;
+
+        // Old versions waiting until the reader is done with them
+        std::mutex* writerMutex;
+        std::vector<const TrackerConfig*>* retired;
+
+        // File last loaded, and its modification time and size then
+        std::string path;
+        long long fileTimeNs;
+        long long fileSize;
+
+        static int ParseConfig(char* xml, TrackerConfig& cfg);
+        static int StatFile(const char* path, long long* timeNs, long long* size);
+};
@@ -0,0 +1,163 @@
+#pragma once
+/*
+ *  Executor.h
+ *
+ *  A small fixed pool of threads that runs coroutines, so several
+ *  cameras' pipeline stages can share a core instead of each stage
+ *  having a thread of its own that sleeps and polls.
+ *
+ *  A CoTask is a coroutine that is started with Executor::Spawn and runs
+ *  until it returns. It only gives up its thread at a co_await:
+ *
+ *      co_await executor->SleepFor(ms)     resumes after ms milliseconds
+ *      co_await signal.Wait()              resumes once the signal fires
+ *      co_await channel.Push(item)         resumes once there is room
+ *      co_await channel.Pop(item)          resumes once there is an item
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "FrameListener.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Executor;
+
+class CoTask {
+    public:
+        struct promise_type {
+            Executor* executor;
+
+            CoTask get_return_object(void) {
+                return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend(void) noexcept {
+                return {};
+            }
+
+            // Lets the executor know the task is done, then frees it
+            struct FinalAwaiter {
+                bool await_ready(void) noexcept {
+                    return false;
+                }
+                void await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+                void await_resume(void) noexcept {}
+            };
+
+            FinalAwaiter final_suspend(void) noexcept {
+                return {};
+            }
+
+            void return_void(void) {}
+            void unhandled_exception(void);
+        };
+
+        explicit CoTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+    private:
+        friend class Executor;
+
+        std::coroutine_handle<promise_type> handle;
+};
+
+struct TimerEntry {
+    std::chrono::steady_clock::time_point wakeup;
+    std::coroutine_handle<> handle;
+};
+
+class Executor {
+    public:
+        Executor(int numThreads = 1);
+        ~Executor();
+
+        void Start(void);
+        void Stop(void);
+
+        void Spawn(CoTask task);
+        void Schedule(std::coroutine_handle<> h);
+        void ScheduleAt(std::coroutine_handle<> h, std::chrono::steady_clock::time_point wakeup);
+
+        struct SleepAwaiter {
+            Executor* executor;
+            std::chrono::steady_clock::time_point wakeup;
+
+            bool await_ready(void) {
+                return wakeup <= std::chrono::steady_clock::now();
+            }
+            void await_suspend(std::coroutine_handle<> h) {
+                executor->ScheduleAt(h, wakeup);
+            }
+            void await_resume(void) {}
+        };
+
+        SleepAwaiter SleepFor(int ms);
+        SleepAwaiter SleepUntil(std::chrono::steady_clock::time_point wakeup);
+
+        int GetNumThreads(void);
+        int GetLiveTasks(void);
+        long long GetResumes(void);
+
+    private:
+        friend struct CoTask::promise_type::FinalAwaiter;
+
+        int numThreads;
+        bool running;
+        bool endSignal;
+
+        std::vector<std::thread>* threads;
+        std::mutex* readyMutex;
+        std::condition_variable* readyCond;
+        std::deque<std::coroutine_handle<>>* ready;
+
+        // Sleeping coroutines, as a heap on the wakeup time
+        std::vector<TimerEntry>* timers;
+
+        std::atomic<int> liveTasks;
+        std::atomic<long long> resumes;
+
+        void RunThread(void);
+        void TaskDone(void);
+};
+
+/*
+ * Wakes up a coroutine from any thread, e.g. the camera's when a new
+ * frame's boxes are published. Signals that fire while nobody is waiting
+ * are merged into one, so a slow consumer only ever sees the latest.
+ */
+class FrameSignal : public FrameListener {
+    public:
+        FrameSignal(Executor* executor);
+
+        void Notify(void);
+        void OnFrame(void);
+        void Close(void);
+
+        struct Awaiter {
+            FrameSignal* signal;
+
+            bool await_ready(void);
+            bool await_suspend(std::coroutine_handle<> h);
+            bool await_resume(void);
+        };
+
+        Awaiter Wait(void);
+        std::chrono::steady_clock::time_point GetLastNotify(void);
+        long long GetMerged(void);
+
+    private:
+        Executor* executor;
+        std::mutex lock;
+        bool pending;
+        bool closed;
+        std::coroutine_handle<> waiter;
+        std::chrono::steady_clock::time_point lastNotify;
+        long long merged;
+};
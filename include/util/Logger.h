@@ -0,0 +1,275 @@
+#pragma once
+/*
+ *  Logger.h
+ *
+ *  Log for the acquisition, tracking and image threads, which must not
+ *  wait on the console. A message is stored in binary form, as the time,
+ *  its format string and its arguments, in a ring of records allocated
+ *  up front; the writer thread turns them into text, prints them and
+ *  appends them to the log file, starting a new file once it gets too
+ *  big. Logging a message takes no lock and never allocates.
+ *
+ *  Any number of threads can log at once. Each record is guarded by a
+ *  sequence number: a thread claims the next record by moving the tail
+ *  on, fills it in, then sets its sequence number to hand it over to the
+ *  writer, which sets it again once it is done with it. When the ring is
+ *  full the message is dropped and counted.
+ *
+ *  Formats have a {} for each argument, which can be any number, or a
+ *  string that is copied into the record. The format must be a string
+ *  literal, since only its address is kept:
+ *
+ *      GetLogger()->Warn("No complete image in {} ms, last status {}.", ms, status);
+ *
+ *  Messages are rate limited by format: past LOG_RATE_BURST in
+ *  LOG_RATE_WINDOW_MS, the same message is only counted, and the writer
+ *  notes how many were left out at most once a window.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_LVL_DEBUG 0
+#define LOG_LVL_INFO  1
+#define LOG_LVL_WARN  2
+#define LOG_LVL_ERROR 3
+
+// Records in the ring, a power of two
+#define LOG_RING_RECORDS 4096
+
+// Most arguments in a message, and room for the strings among them
+#define LOG_MAX_ARGS   4
+#define LOG_TEXT_BYTES 160
+
+// How often the writer thread empties the ring
+#define LOG_FLUSH_MS 50
+
+// Size at which the log file is moved to <path>.1, and the number of
+// old files kept
+#define LOG_ROTATE_BYTES (8 * 1024 * 1024)
+#define LOG_KEEP_FILES   4
+
+// Most of the same message let through in each window
+#define LOG_RATE_BURST     10
+#define LOG_RATE_WINDOW_MS 1000
+
+// Messages rate limited separately, a power of two. Past that many, and
+// on collisions that linear probing doesn't resolve, nothing is limited.
+#define LOG_RATE_SLOTS  256
+#define LOG_RATE_PROBES 8
+
+// Most of each rate limited message's last line kept, to say what was
+// left out
+#define LOG_LAST_LINE_BYTES 256
+
+#define LOG_ARG_INT    0
+#define LOG_ARG_DOUBLE 1
+#define LOG_ARG_TEXT   2
+
+struct LogArg {
+    int type;
+    union {
+        long long i;
+        double d;
+
+        // Offset of a string in the record's text
+        int text;
+    };
+};
+
+struct LogRecord {
+    // Equal to the record's position in the ring when it can be claimed,
+    // one past it once filled in
+    std::atomic<size_t> seq;
+
+    long long timeUs;
+    const char* format;
+    uintptr_t key;
+
+    // Rate slot the key was counted in, -1 if it wasn't limited
+    int rateSlot;
+    int level;
+    int numArgs;
+    int textBytes;
+    LogArg args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+// Count of one message in the current window
+struct LogRate {
+    std::atomic<uintptr_t> key;
+    std::atomic<long long> windowUs;
+    std::atomic<int> count;
+    std::atomic<long long> suppressed;
+    std::atomic<int> level;
+};
+
+class Logger {
+    public:
+        Logger(int capacity = LOG_RING_RECORDS);
+        ~Logger();
+
+        void Start(void);
+        void Stop(void);
+        void Flush(void);
+
+        int OpenFile(const char* path);
+        void SetEcho(bool echo);
+        void SetLevel(int level);
+        void SetRateLimit(int burst, long long windowMs);
+
+        template <class... A>
+        void Log(int level, const char* format, A... args);
+        template <class... A>
+        void LogKeyed(int level, uintptr_t key, const char* format, A... args);
+
+        template <class... A>
+        void Debug(const char* format, A... args) {
+            Log(LOG_LVL_DEBUG, format, args...);
+        }
+        template <class... A>
+        void Info(const char* format, A... args) {
+            Log(LOG_LVL_INFO, format, args...);
+        }
+        template <class... A>
+        void Warn(const char* format, A... args) {
+            Log(LOG_LVL_WARN, format, args...);
+        }
+        template <class... A>
+        void Error(const char* format, A... args) {
+            Log(LOG_LVL_ERROR, format, args...);
+        }
+
+        long long GetLogged(void);
+        long long GetDropped(void);
+        long long GetSuppressed(void);
+        long long GetWritten(void);
+        long long GetRotations(void);
+
+    private:
+        LogRecord* ring;
+        size_t mask;
+
+        // Next record to claim, and next one for the writer. On separate
+        // cache lines, since the tail is written by every thread logging.
+        alignas(64) std::atomic<size_t> tail;
+        alignas(64) std::atomic<size_t> head;
+
+        alignas(64) std::atomic<int> minLevel;
+        std::atomic<int> rateBurst;
+        std::atomic<long long> rateWindowUs;
+        LogRate* rates;
+
+        std::atomic<long long> dropped;
+        std::atomic<long long> suppressed;
+        std::atomic<long long> written;
+        std::atomic<long long> rotations;
+
+        std::thread* writer;
+        std::atomic<bool> endSignal;
+
+        // Only used by the writer thread, once started
+        FILE* file;
+        std::string* path;
+        long long fileBytes;
+        std::atomic<bool> echo;
+        std::string* line;
+        long long droppedReported;
+
+        // Last message written for each rate slot, to say what was left
+        // out, and when each slot was last reported on
+        char* lastLines;
+        long long* reportedUs;
+
+        static long long NowUs(void);
+        bool Admit(uintptr_t key, int level, long long nowUs, int* slot);
+        LogRecord* Claim(size_t* pos);
+        void Publish(LogRecord* rec, size_t pos);
+
+        template <class V>
+        static void PutArg(LogRecord* rec, V value);
+        static void PutText(LogRecord* rec, const char* text);
+
+        void RunWriter(void);
+        int Drain(void);
+        void ReportSuppressed(bool all);
+        void ReportDropped(void);
+        void Format(const LogRecord& rec);
+        void Write(int level, long long timeUs, const std::string& text);
+        void Rotate(void);
+};
+
+Logger* GetLogger(void);
+
+/******************* Function Definitions ******************/
+
+/*
+ * Logs the message, rate limited by its format. Safe to call from any
+ * thread, and never waits.
+ */
+template <class... A>
+void Logger::Log(int level, const char* format, A... args) {
+    LogKeyed(level, (uintptr_t)format, format, args...);
+}
+
+/*
+ * Logs the message, rate limited by key instead of its format, for
+ * messages that pass most of their text as an argument.
+ */
+template <class... A>
+void Logger::LogKeyed(int level, uintptr_t key, const char* format, A... args) {
+    static_assert(sizeof...(A) <= LOG_MAX_ARGS, "Too many arguments to log");
+
+    if (level < minLevel.load(std::memory_order_relaxed))
+        return;
+
+    long long nowUs = NowUs();
+    int rateSlot;
+    if (!Admit(key, level, nowUs, &rateSlot))
+        return;
+
+    size_t pos;
+    LogRecord* rec = Claim(&pos);
+    if (rec == NULL) {
+        dropped++;
+        return;
+    }
+
+    rec->timeUs = nowUs;
+    rec->format = format;
+    rec->key = key;
+    rec->rateSlot = rateSlot;
+    rec->level = level;
+    rec->numArgs = 0;
+    rec->textBytes = 0;
+    (PutArg(rec, args), ...);
+
+    Publish(rec, pos);
+}
+
+template <class V>
+void Logger::PutArg(LogRecord* rec, V value) {
+    LogArg& arg = rec->args[rec->numArgs++];
+
+    if constexpr (std::is_floating_point<V>::value) {
+        arg.type = LOG_ARG_DOUBLE;
+        arg.d = (double)value;
+    }
+    else if constexpr (std::is_integral<V>::value || std::is_enum<V>::value) {
+        arg.type = LOG_ARG_INT;
+        arg.i = (long long)value;
+    }
+    else {
+        arg.type = LOG_ARG_TEXT;
+        arg.text = rec->textBytes;
+        PutText(rec, value);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+/*
+ *  MappedFile.h
+ *
+ *  Read only memory mapping of a whole file, so that large recordings
+ *  can be shared between threads without each one loading a copy.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+class MappedFile {
+    public:
+        MappedFile();
+
+        int Open(const char* path);
+        void Close(void);
+
+        const uint8_t* GetData(void) const;
+        size_t GetSize(void) const;
+
+        ~MappedFile();
+
+    private:
+        const uint8_t* data;
+        size_t size;
+
+#ifdef _WIN32
+        void* fileHandle;
+        void* mapHandle;
+#else
+        int fd;
+#endif
+};
@@ -0,0 +1,307 @@
+#pragma once
+/*
+ *  SpscQueue.h
+ *
+ *  Bounded lock-free queue between two threads, one pushing and one
+ *  popping. Items are swapped in and out of a fixed ring, so items that
+ *  own buffers (like vectors of boxes) are recycled rather than
+ *  reallocated.
+ *
+ *  The producer either drops an item when the queue is full (TryPush) or
+ *  waits for room (Push); the consumer waits for an item (Pop) or takes
+ *  one only if there is one (TryPop). Waiting threads sleep on the
+ *  queue's counters instead of spinning. The queue keeps how deep it
+ *  got, how many items were dropped, and how long each side waited, so
+ *  it shows where a pipeline backs up:
+ *
+ *      push waits   the stage after the queue is the bottleneck
+ *      pop waits    the stage before the queue is, or there is no work
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+template <class T>
+class SpscQueue {
+    public:
+        SpscQueue(int capacity);
+
+        bool TryPush(T& item);
+        bool Push(T& item);
+        bool Pop(T& item);
+        bool TryPop(T& item);
+        void Close(void);
+
+        int GetCapacity(void);
+        int GetDepth(void);
+        int GetHighWater(void);
+        long long GetPushed(void);
+        long long GetDropped(void);
+        long long GetPushWaits(void);
+        double GetPushWaitMs(void);
+        double GetMaxPushWaitMs(void);
+        double GetPopWaitMs(void);
+        void PrintReport(const char* name);
+
+    private:
+        std::vector<T> ring;
+        size_t mask;
+
+        // Kept on separate cache lines, since each is written by a
+        // different thread. Both only ever grow, and are masked into the ring.
+        alignas(64) std::atomic<size_t> head;     // next item to pop
+        alignas(64) std::atomic<size_t> tail;     // next slot to push into
+
+        // Bumped after every push and pop, and on close, to wake a waiting
+        // thread
+        alignas(64) std::atomic<uint32_t> pushEvents;
+        alignas(64) std::atomic<uint32_t> popEvents;
+        std::atomic<bool> closed;
+
+        std::atomic<int> highWater;
+        std::atomic<long long> pushed;
+        std::atomic<long long> dropped;
+        std::atomic<long long> pushWaits;
+        std::atomic<long long> pushWaitNs;
+        std::atomic<long long> maxPushWaitNs;
+        std::atomic<long long> popWaitNs;
+
+        void NotePushed(size_t t);
+};
+
+/******************* Function Definitions ******************/
+template <class T>
+SpscQueue<T>::SpscQueue(int capacity) : head(0), tail(0), pushEvents(0), popEvents(0), closed(false),
+                                        highWater(0), pushed(0), dropped(0), pushWaits(0), pushWaitNs(0),
+                                        maxPushWaitNs(0), popWaitNs(0) {
+    // Rounded up to a power of two so indices can be masked
+    size_t size = 1;
+    while (size < (size_t)capacity)
+        size <<= 1;
+
+    ring.resize(size);
+    mask = size - 1;
+}
+
+/*
+ * Swaps the item into the queue if there is room. The item is left with
+ * whatever the slot held before. Returns false, and counts a drop, if
+ * the queue is full or closed.
+ */
+template <class T>
+bool SpscQueue<T>::TryPush(T& item) {
+    size_t t = tail.load();
+    if (closed || t - head.load() == ring.size()) {
+        dropped++;
+        return false;
+    }
+
+    std::swap(ring[t & mask], item);
+    NotePushed(t);
+    return true;
+}
+
+/*
+ * Swaps the item into the queue, waiting for room if it is full. Returns
+ * false, with the item untouched, if the queue was closed.
+ */
+template <class T>
+bool SpscQueue<T>::Push(T& item) {
+    size_t t = tail.load();
+    bool waited = false;
+    std::chrono::steady_clock::time_point start;
+
+    while (t - head.load() == ring.size()) {
+        if (closed)
+            return false;
+
+        if (!waited) {
+            waited = true;
+            start = std::chrono::steady_clock::now();
+        }
+
+        // Checked again after reading the counter, so a pop in between
+        // isn't missed
+        uint32_t seen = popEvents.load();
+        if (t - head.load() == ring.size() && !closed)
+            popEvents.wait(seen);
+    }
+
+    if (closed)
+        return false;
+
+    if (waited) {
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        pushWaits++;
+        pushWaitNs += ns;
+        if (ns > maxPushWaitNs)
+            maxPushWaitNs.store(ns);
+    }
+
+    std::swap(ring[t & mask], item);
+    NotePushed(t);
+    return true;
+}
+
+/*
+ * Swaps the oldest item out of the queue, waiting for one if it is empty.
+ * Returns false once the queue is closed and empty.
+ */
+template <class T>
+bool SpscQueue<T>::Pop(T& item) {
+    size_t h = head.load();
+    bool waited = false;
+    std::chrono::steady_clock::time_point start;
+
+    while (tail.load() == h) {
+        if (closed)
+            break;
+
+        if (!waited) {
+            waited = true;
+            start = std::chrono::steady_clock::now();
+        }
+
+        uint32_t seen = pushEvents.load();
+        if (tail.load() == h && !closed)
+            pushEvents.wait(seen);
+    }
+
+    if (waited) {
+        popWaitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (tail.load() == h)
+        return false;
+
+    std::swap(ring[h & mask], item);
+    head.store(h + 1);
+
+    popEvents++;
+    popEvents.notify_one();
+    return true;
+}
+
+/*
+ * Swaps the oldest item out of the queue if there is one, without
+ * waiting. Returns false if it is empty.
+ */
+template <class T>
+bool SpscQueue<T>::TryPop(T& item) {
+    size_t h = head.load();
+    if (tail.load() == h)
+        return false;
+
+    std::swap(ring[h & mask], item);
+    head.store(h + 1);
+
+    popEvents++;
+    popEvents.notify_one();
+    return true;
+}
+
+/*
+ * Wakes up both sides. Items already in the queue can still be popped.
+ */
+template <class T>
+void SpscQueue<T>::Close(void) {
+    closed = true;
+
+    pushEvents++;
+    pushEvents.notify_all();
+    popEvents++;
+    popEvents.notify_all();
+}
+
+template <class T>
+int SpscQueue<T>::GetCapacity(void) {
+    return (int)ring.size();
+}
+
+/*
+ * Items waiting in the queue right now.
+ */
+template <class T>
+int SpscQueue<T>::GetDepth(void) {
+    return (int)(tail.load() - head.load());
+}
+
+/*
+ * Most items the queue has held at once.
+ */
+template <class T>
+int SpscQueue<T>::GetHighWater(void) {
+    return highWater;
+}
+
+template <class T>
+long long SpscQueue<T>::GetPushed(void) {
+    return pushed;
+}
+
+/*
+ * Items TryPush couldn't fit.
+ */
+template <class T>
+long long SpscQueue<T>::GetDropped(void) {
+    return dropped;
+}
+
+/*
+ * Number of times Push found the queue full and had to wait.
+ */
+template <class T>
+long long SpscQueue<T>::GetPushWaits(void) {
+    return pushWaits;
+}
+
+/*
+ * Total time Push spent waiting for room.
+ */
+template <class T>
+double SpscQueue<T>::GetPushWaitMs(void) {
+    return pushWaitNs / 1e6;
+}
+
+template <class T>
+double SpscQueue<T>::GetMaxPushWaitMs(void) {
+    return maxPushWaitNs / 1e6;
+}
+
+/*
+ * Total time Pop spent waiting for an item.
+ */
+template <class T>
+double SpscQueue<T>::GetPopWaitMs(void) {
+    return popWaitNs / 1e6;
+}
+
+template <class T>
+void SpscQueue<T>::PrintReport(const char* name) {
+    std::cout << name << " queue: " << GetDepth() << " of " << GetCapacity() << " deep, " << GetHighWater()
+              << " at most, " << GetPushed() << " pushed, " << GetDropped() << " dropped, " << GetPushWaits()
+              << " full waits for " << GetPushWaitMs() << " ms (" << GetMaxPushWaitMs() << " ms max), "
+              << GetPopWaitMs() << " ms waiting for items\n";
+}
+
+template <class T>
+void SpscQueue<T>::NotePushed(size_t t) {
+    tail.store(t + 1);
+
+    int depth = (int)(t + 1 - head.load());
+    if (depth > highWater)
+        highWater.store(depth);
+    pushed++;
+
+    pushEvents++;
+    pushEvents.notify_one();
+}
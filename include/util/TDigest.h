@@ -0,0 +1,61 @@
+#pragma once
+/*
+ *  TDigest.h
+ *
+ *  Streaming estimate of the distribution of a value, from which any
+ *  percentile can be read, in a fixed amount of memory however many
+ *  values go in. Two digests merge into one as cheaply as a single
+ *  compression, so hourly digests roll up into days, and digests from
+ *  different cameras into a whole site.
+ *
+ *  The values are summarised as up to TDIGEST_COMPRESSION centroids
+ *  (a mean and a weight), which are kept small near either end of the
+ *  distribution and allowed to grow in the middle, so the tails stay
+ *  accurate (Dunning's merging t-digest, with the arcsine scale). New
+ *  values are collected in a buffer and merged in when it fills up.
+ *
+ *  Nothing is random, so the same values in the same order always give
+ *  the same digest.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+// Largest number of centroids, which sets the accuracy
+#define TDIGEST_COMPRESSION 100
+
+// Values collected before they are merged into the centroids
+#define TDIGEST_BUFFER 128
+
+struct TDigestCentroid {
+    float mean;
+    float weight;
+};
+
+class TDigest {
+    public:
+        TDigest();
+
+        void Add(float value);
+        void Merge(const TDigest& other);
+        void Clear(void);
+
+        float Quantile(double q);
+        long long GetCount(void) const;
+        float GetMin(void) const;
+        float GetMax(void) const;
+        int GetCentroids(void);
+
+    private:
+        TDigestCentroid centroids[TDIGEST_COMPRESSION];
+        int numCentroids;
+
+        float buffer[TDIGEST_BUFFER];
+        int numBuffered;
+
+        long long count;
+        float min;
+        float max;
+
+        void Compress(const TDigestCentroid* extra, int numExtra);
+};
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *  ThreadControl.h
+ *
+ *  Pins threads to a CPU and runs them under a real-time scheduling
+ *  policy, so the acquisition and tracking threads aren't held up past
+ *  the next inference result on a busy host, and measures how late each
+ *  wakeup of a periodic thread is.
+ *
+ *  On Windows the real-time policies map to the time critical and
+ *  highest thread priorities. Elsewhere they are SCHED_FIFO and SCHED_RR,
+ *  which usually need root or CAP_SYS_NICE.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Scheduling policies
+#define THREAD_SCHED_NORMAL 0   // Whatever the OS gives new threads
+#define THREAD_SCHED_FIFO   1   // Real-time, runs until it blocks
+#define THREAD_SCHED_RR     2   // Real-time, time sliced with equal priorities
+
+// Leave the thread on whichever CPU the OS picks
+#define THREAD_ANY_CPU -1
+
+// Priority of real-time threads, from 1 to 99
+#define THREAD_RT_PRIORITY 50
+
+// Wakeup delays are kept in buckets of powers of two microseconds
+#define JITTER_BUCKETS 32
+
+struct ThreadPlacement {
+    int cpu;
+    int policy;
+    int priority;
+
+    ThreadPlacement(int cpu = THREAD_ANY_CPU, int policy = THREAD_SCHED_NORMAL,
+                    int priority = THREAD_RT_PRIORITY) : cpu(cpu), policy(policy), priority(priority) {}
+};
+
+int PlaceThread(std::thread& t, const ThreadPlacement& placement);
+int PlaceThisThread(const ThreadPlacement& placement);
+int GetNumCpus(void);
+
+class WakeupJitter {
+    public:
+        WakeupJitter();
+
+        void SleepFor(int ms);
+        void SleepUntil(std::chrono::steady_clock::time_point wakeup);
+        void Record(long long lateUs);
+
+        long long GetWakeups(void);
+        double GetAvgUs(void);
+        long long GetMaxUs(void);
+        long long GetPercentileUs(double q);
+        void PrintReport(const char* name);
+
+    private:
+        std::atomic<long long> wakeups;
+        std::atomic<long long> totalUs;
+        std::atomic<long long> maxUs;
+        std::atomic<long long> buckets[JITTER_BUCKETS];
+};
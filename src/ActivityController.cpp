@@ -0,0 +1,84 @@
+/*
+ *  ActivityController.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ActivityController.h"
+#include "Tracker.h"
+#include "Logger.h"
+
+ActivityController::ActivityController(BoxSource* cam) : mCam(cam), mode(MODE_ACTIVE), modeSwitches(0),
+                                                         lastUpdateMs(-1), lastActivityMs(0), modeStartMs(0) {
+    for (int i = 0; i < NUM_MODES; i++)
+        timeInMode[i].store(0);
+}
+
+/*
+ * Called once per tracking iteration with the number of people that are
+ * currently being tracked.
+ *
+ * Goes idle once nobody has been tracked for IDLE_TIMEOUT_MS and at least
+ * MIN_ACTIVE_MS have passed since waking up. Wakes up on the first frame
+ * that has anyone in it.
+ */
+void ActivityController::Update(int numTracks, long long nowMs) {
+    if (lastUpdateMs < 0) {
+        lastUpdateMs = nowMs;
+        lastActivityMs = nowMs;
+        modeStartMs = nowMs;
+    }
+
+    timeInMode[mode] += nowMs - lastUpdateMs;
+    lastUpdateMs = nowMs;
+
+    if (numTracks > 0)
+        lastActivityMs = nowMs;
+
+    if (mode == MODE_IDLE && numTracks > 0) {
+        // Go back to full rate, even if the camera refuses we poll faster
+        if (mCam->SetFrameRate(0))
+            GetLogger()->Warn("Unable to restore the full frame rate.");
+        SwitchMode(MODE_ACTIVE, nowMs);
+    }
+    else if (mode == MODE_ACTIVE &&
+             nowMs - lastActivityMs >= IDLE_TIMEOUT_MS &&
+             nowMs - modeStartMs >= MIN_ACTIVE_MS) {
+        if (mCam->SetFrameRate(IDLE_FRAME_RATE) == 0)
+            SwitchMode(MODE_IDLE, nowMs);
+        else
+            modeStartMs = nowMs; // Try again later
+    }
+}
+
+int ActivityController::GetMode(void) {
+    return mode;
+}
+
+/*
+ * Time in ms the tracking loop should wait before looking for the next
+ * frame in the current mode.
+ */
+int ActivityController::GetPollInterval(void) {
+    if (mode == MODE_IDLE)
+        return (int)(1000 / IDLE_FRAME_RATE);
+    else
+        return INFERENCE_TIME;
+}
+
+long long ActivityController::GetTimeInMode(int m) {
+    return timeInMode[m];
+}
+
+int ActivityController::GetModeSwitches(void) {
+    return modeSwitches;
+}
+
+/************************** Private Functions **************************/
+
+void ActivityController::SwitchMode(int newMode, long long nowMs) {
+    mode.store(newMode);
+    modeStartMs = nowMs;
+    modeSwitches++;
+}
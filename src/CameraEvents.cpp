@@ -0,0 +1,315 @@
+/*
+ *  CameraEvents.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "CameraEvents.h"
+#include "Logger.h"
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace Spinnaker::GenICam;
+
+using std::cout;
+
+// Events turned on, if the camera has them. Only some cameras report
+// acquisition starting and ending.
+static const char* eventNames[] = { "ExposureEnd", "Error", "AcquisitionStart", "AcquisitionEnd" };
+
+static long long NowUs(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+CameraEvents::CameraEvents() : offsetUs(0), nextSyncUs(0), synced(false), clockErrorUs(0), events(0),
+                               unmatched(0), errors(0), lastErrorCode(0) {
+    queue = new SpscQueue<CameraEvent>(CAM_EVENT_QUEUE);
+    pending = new PendingFrame[CAM_EVENT_PENDING];
+    cameraLatency = new WakeupJitter();
+    hostLatency = new WakeupJitter();
+
+    for (int i = 0; i < CAM_EVENT_PENDING; i++)
+        pending[i].frameId = -1;
+}
+
+/*
+ * Turns on the camera's events and finds the nodes their data is read
+ * from. Must be called after the camera is initialized, before the
+ * handler is registered with it. Returns -1 if the camera can't report
+ * when exposures end, in which case there is no timing to collect.
+ */
+int CameraEvents::Enable(INodeMap& nodeMap) {
+    bool exposureEnd = false;
+
+    try {
+        CEnumerationPtr selector = nodeMap.GetNode("EventSelector");
+        CEnumerationPtr notification = nodeMap.GetNode("EventNotification");
+        if (!IsAvailable(selector) || !IsWritable(selector) || !IsAvailable(notification)) {
+            GetLogger()->Warn("EventSelector is not available or writable.");
+            return -1;
+        }
+
+        CEnumEntryPtr on = notification->GetEntryByName("On");
+        if (!IsAvailable(on)) {
+            GetLogger()->Warn("EventNotification On is not a valid enum entry.");
+            return -1;
+        }
+
+        for (const char* name : eventNames) {
+            CEnumEntryPtr entry = selector->GetEntryByName(name);
+            if (!IsAvailable(entry))
+                continue;
+
+            selector->SetIntValue(entry->GetValue());
+            if (IsWritable(notification))
+                notification->SetIntValue(on->GetValue());
+            if (strcmp(name, "ExposureEnd") == 0)
+                exposureEnd = true;
+        }
+
+        exposureEndId = nodeMap.GetNode("EventExposureEndFrameID");
+        exposureEndTime = nodeMap.GetNode("EventExposureEndTimestamp");
+        errorId = nodeMap.GetNode("EventErrorFrameID");
+        errorTime = nodeMap.GetNode("EventErrorTimestamp");
+        errorCode = nodeMap.GetNode("EventErrorCode");
+        latch = nodeMap.GetNode("TimestampLatch");
+        latchValue = nodeMap.GetNode("TimestampLatchValue");
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Warn("Unable to turn on camera events: {}.", e.GetErrorMessage());
+        return -1;
+    }
+
+    if (!exposureEnd) {
+        GetLogger()->Warn("The camera doesn't report when exposures end.");
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Called by Spinnaker on its event thread. Copies the event's data into
+ * the queue for the acquisition thread.
+ */
+void CameraEvents::OnDeviceEvent(gcstring eventName) {
+    CameraEvent evt;
+    evt.frameId = -1;
+    evt.cameraNs = -1;
+    evt.code = 0;
+
+    try {
+        if (eventName == "EventExposureEnd") {
+            if (!IsAvailable(exposureEndId) || !IsAvailable(exposureEndTime))
+                return;
+
+            evt.type = CAM_EVENT_EXPOSURE_END;
+            evt.frameId = exposureEndId->GetValue();
+            evt.cameraNs = exposureEndTime->GetValue();
+        }
+        else if (eventName == "EventError") {
+            evt.type = CAM_EVENT_ERROR;
+            if (IsAvailable(errorId))
+                evt.frameId = errorId->GetValue();
+            if (IsAvailable(errorTime))
+                evt.cameraNs = errorTime->GetValue();
+            if (IsAvailable(errorCode))
+                evt.code = errorCode->GetValue();
+        }
+        else if (eventName == "EventAcquisitionStart") {
+            evt.type = CAM_EVENT_ACQ_START;
+        }
+        else if (eventName == "EventAcquisitionEnd") {
+            evt.type = CAM_EVENT_ACQ_END;
+        }
+        else {
+            return;
+        }
+    }
+    catch (Spinnaker::Exception&) {
+        return;
+    }
+
+    events++;
+    queue->TryPush(evt);
+}
+
+/*
+ * Called by the acquisition thread for every complete image, once its
+ * boxes are published. Takes in the events that have come since and
+ * matches the image with its exposure end.
+ */
+void CameraEvents::OnImage(long long frameId, long long arrivalUs, long long publishedUs) {
+    SyncClock(arrivalUs);
+    Drain();
+
+    hostLatency->Record(publishedUs - arrivalUs);
+
+    PendingFrame& frame = Slot(frameId);
+    frame.arrivalUs = arrivalUs;
+    Match(frame);
+}
+
+/*
+ * Forgets the frames waiting to be matched and the events not taken in
+ * yet, and measures the clocks again, for when the camera has been set
+ * up again and its frame IDs and clock may have started over. Called by
+ * the acquisition thread.
+ */
+void CameraEvents::Reset(void) {
+    CameraEvent evt;
+    while (queue->TryPop(evt)) {}
+
+    for (int i = 0; i < CAM_EVENT_PENDING; i++)
+        pending[i].frameId = -1;
+    synced = false;
+}
+
+/*
+ * Time from each exposure ending to its image arriving on the host.
+ */
+WakeupJitter* CameraEvents::GetCameraLatency(void) {
+    return cameraLatency;
+}
+
+/*
+ * Time from each image arriving to its boxes being published.
+ */
+WakeupJitter* CameraEvents::GetHostLatency(void) {
+    return hostLatency;
+}
+
+long long CameraEvents::GetEvents(void) {
+    return events;
+}
+
+/*
+ * Events the acquisition thread fell too far behind to take.
+ */
+long long CameraEvents::GetDropped(void) {
+    return queue->GetDropped();
+}
+
+/*
+ * Exposure ends without an image, or images without an exposure end.
+ */
+long long CameraEvents::GetUnmatched(void) {
+    return unmatched;
+}
+
+long long CameraEvents::GetErrors(void) {
+    return errors;
+}
+
+void CameraEvents::PrintReport(void) {
+    cout << "Camera timing: " << cameraLatency->GetWakeups() << " frames, exposure end to image "
+         << cameraLatency->GetAvgUs() << " us on average, " << cameraLatency->GetPercentileUs(0.99) << " us p99, "
+         << cameraLatency->GetMaxUs() << " us max, image to boxes " << hostLatency->GetAvgUs()
+         << " us on average, " << hostLatency->GetPercentileUs(0.99) << " us p99, " << hostLatency->GetMaxUs()
+         << " us max, clocks to within " << clockErrorUs << " us\n";
+    cout << "Camera events: " << GetEvents() << " events, " << GetDropped() << " dropped, " << GetUnmatched()
+         << " unmatched, " << GetErrors() << " errors";
+    if (errors > 0)
+        cout << " (last code " << lastErrorCode << ")";
+    cout << "\n";
+}
+
+CameraEvents::~CameraEvents() {
+    delete queue;
+    delete[] pending;
+    delete cameraLatency;
+    delete hostLatency;
+}
+
+/************************** Private Functions **************************/
+
+/*
+ * Measures the offset between the camera's clock and ours, if it is time
+ * to. The offset is taken from the middle of the latch command, so it is
+ * off by at most half the time the command took.
+ */
+void CameraEvents::SyncClock(long long nowUs) {
+    if (synced && nowUs < nextSyncUs)
+        return;
+    nextSyncUs = nowUs + CAM_CLOCK_SYNC_MS * 1000LL;
+
+    if (!IsAvailable(latch) || !IsAvailable(latchValue))
+        return;
+
+    try {
+        long long beforeUs = NowUs();
+        latch->Execute();
+        long long afterUs = NowUs();
+
+        offsetUs = (beforeUs + afterUs) / 2 - latchValue->GetValue() / 1000;
+        clockErrorUs.store((afterUs - beforeUs + 1) / 2);
+        synced = true;
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Warn("Unable to latch the camera's clock: {}.", e.GetErrorMessage());
+    }
+}
+
+/*
+ * Takes in the events the handler has queued.
+ */
+void CameraEvents::Drain(void) {
+    CameraEvent evt;
+
+    while (queue->TryPop(evt)) {
+        if (evt.type == CAM_EVENT_EXPOSURE_END) {
+            PendingFrame& frame = Slot(evt.frameId);
+            frame.exposureEndNs = evt.cameraNs;
+            Match(frame);
+        }
+        else if (evt.type == CAM_EVENT_ERROR) {
+            errors++;
+            lastErrorCode.store(evt.code);
+            GetLogger()->Warn("Camera error {} on frame {}.", evt.code, evt.frameId);
+        }
+        else if (evt.type == CAM_EVENT_ACQ_START) {
+            GetLogger()->Info("Camera started acquisition.");
+        }
+        else {
+            GetLogger()->Info("Camera ended acquisition.");
+        }
+    }
+}
+
+/*
+ * Slot of the frame with the given ID, taken over from whichever frame
+ * was in it if that was a different one.
+ */
+CameraEvents::PendingFrame& CameraEvents::Slot(long long frameId) {
+    PendingFrame& frame = pending[frameId & (CAM_EVENT_PENDING - 1)];
+
+    if (frame.frameId != frameId) {
+        // The frame there never got its other half
+        if (frame.frameId >= 0)
+            unmatched++;
+
+        frame.frameId = frameId;
+        frame.exposureEndNs = -1;
+        frame.arrivalUs = -1;
+    }
+
+    return frame;
+}
+
+/*
+ * Records the frame's time on the camera once both its exposure end and
+ * its image are in.
+ */
+void CameraEvents::Match(PendingFrame& frame) {
+    if (frame.exposureEndNs < 0 || frame.arrivalUs < 0)
+        return;
+
+    if (synced)
+        cameraLatency->Record(frame.arrivalUs - (frame.exposureEndNs / 1000 + offsetUs));
+    frame.frameId = -1;
+}
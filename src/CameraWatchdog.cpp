@@ -0,0 +1,165 @@
+/*
+ *  CameraWatchdog.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "CameraWatchdog.h"
+#include "Logger.h"
+#include <algorithm>
+#include <iostream>
+
+using std::cout;
+
+CameraWatchdog::CameraWatchdog(BoxSource* cam, Clock* clock, long long deadlineMs)
+    : mCam(cam), clock(clock), deadlineMs(deadlineMs), stopSignal(false), down(false), downSinceUs(0), outages(0),
+      failedReconnects(0), lastRecoveryMs(0), maxRecoveryMs(0), totalDownMs(0) {
+    mutex = new std::mutex();
+    mCam->SetFrameTimeout(deadlineMs);
+}
+
+/*
+ * Runs acquisition until Stop is called or the source runs out of frames,
+ * reconnecting whenever it fails. Takes the place of the source's
+ * StartAcquisition.
+ */
+void CameraWatchdog::Run(void) {
+    stopSignal.store(false);
+
+    while (!stopSignal) {
+        if (mCam->StartAcquisition() == 0 || stopSignal)
+            break;
+
+        // Frames from before the outage don't end it
+        mCam->ResetFirstFrame();
+        long long lastUs = mCam->GetLastFrameUs();
+
+        mutex->lock();
+        down = true;
+        downSinceUs = (lastUs >= 0) ? lastUs : clock->NowUs();
+        outages++;
+        mutex->unlock();
+
+        GetLogger()->Warn("Camera stopped delivering frames, reconnecting.");
+        if (!Reconnect())
+            break;
+    }
+}
+
+/*
+ * Ends acquisition, and any reconnect in progress, so that Run returns.
+ */
+void CameraWatchdog::Stop(void) {
+    stopSignal.store(true);
+    mCam->EndAcquisition();
+}
+
+/*
+ * Whether the camera has stopped and no frame has come since. Ends the
+ * outage once one has.
+ */
+bool CameraWatchdog::IsDown(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+    return down;
+}
+
+long long CameraWatchdog::GetOutages(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+    return outages;
+}
+
+/*
+ * Attempts to set the camera up again that failed.
+ */
+long long CameraWatchdog::GetFailedReconnects(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return failedReconnects;
+}
+
+/*
+ * Length of the last outage that has ended, and of the longest one.
+ */
+long long CameraWatchdog::GetLastRecoveryMs(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+    return lastRecoveryMs;
+}
+
+long long CameraWatchdog::GetMaxRecoveryMs(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+    return maxRecoveryMs;
+}
+
+/*
+ * Time spent without frames, including the outage still going on.
+ */
+long long CameraWatchdog::GetDownMs(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+    return totalDownMs + (down ? (clock->NowUs() - downSinceUs) / 1000 : 0);
+}
+
+void CameraWatchdog::PrintReport(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    Update();
+
+    cout << "Camera watchdog: " << outages << " outages, " << failedReconnects << " failed reconnects, last "
+         << lastRecoveryMs << " ms, worst " << maxRecoveryMs << " ms, " << totalDownMs / 1000 << " s down in total"
+         << (down ? ", down now" : "") << "\n";
+}
+
+CameraWatchdog::~CameraWatchdog() {
+    delete mutex;
+}
+
+/************************** Private Functions **************************/
+
+/*
+ * Ends the outage if a frame has come since. Must hold the mutex.
+ */
+void CameraWatchdog::Update(void) {
+    if (!down)
+        return;
+
+    long long firstUs = mCam->GetFirstFrameUs();
+    if (firstUs < 0)
+        return;
+
+    lastRecoveryMs = (firstUs - downSinceUs) / 1000;
+    maxRecoveryMs = std::max(maxRecoveryMs, lastRecoveryMs);
+    totalDownMs += lastRecoveryMs;
+    down = false;
+
+    GetLogger()->Info("Camera back after {} ms.", lastRecoveryMs);
+}
+
+/*
+ * Closes the camera and sets it up again until it works, backing off
+ * between attempts. Returns false if stopped first.
+ */
+bool CameraWatchdog::Reconnect(void) {
+    long long backoffMs = WATCHDOG_BACKOFF_MS;
+
+    while (!stopSignal) {
+        mCam->CloseCamera();
+        if (mCam->InitCamera() == 0)
+            return true;
+
+        mutex->lock();
+        failedReconnects++;
+        mutex->unlock();
+
+        // In short steps, so that Stop doesn't wait for a long backoff
+        long long wakeupUs = clock->NowUs() + backoffMs * 1000;
+        while (!stopSignal && clock->NowUs() < wakeupUs)
+            clock->SleepUntilUs(std::min(wakeupUs, clock->NowUs() + WATCHDOG_BACKOFF_MS * 1000LL));
+
+        backoffMs = std::min(backoffMs * 2, (long long)WATCHDOG_MAX_BACKOFF_MS);
+    }
+
+    return false;
+}
@@ -0,0 +1,437 @@
+/*
+ *  CountStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "CountStore.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using std::cout;
+using std::vector;
+
+/*************************** Encoding ***************************/
+
+static void PutVarint(vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+/*
+ * Reads a varint at *pos, moving it on. Returns false if it runs off the
+ * end of the data.
+ */
+static bool GetVarint(const vector<uint8_t>& in, size_t* pos, uint64_t* v) {
+    *v = 0;
+    for (int shift = 0; shift < 64 && *pos < in.size(); shift += 7) {
+        uint8_t b = in[(*pos)++];
+        *v |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Small negative numbers become small varints too
+static uint64_t ZigZag(long long v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static long long UnZigZag(uint64_t v) {
+    return (long long)(v >> 1) ^ -(long long)(v & 1);
+}
+
+static uint32_t Fnv1a(const vector<uint8_t>& data) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < data.size(); i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*************************** CountStore ***************************/
+
+CountStore::CountStore(long long blockMs) : blockMs(blockMs), cameraId(0), file(NULL), endOffset(0), samples(0),
+                                            blocksDecoded(0) {
+    index = new vector<BlockIndex>();
+    open = new vector<CountSample>();
+    bytes = new vector<uint8_t>();
+    decoded = new vector<CountSample>();
+    mutex = new std::mutex();
+}
+
+/*
+ * Opens the store at path to add to, creating it for the given camera if
+ * it doesn't exist. An existing store keeps its own camera and block
+ * length.
+ */
+int CountStore::Open(const char* path, int cameraId) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (file != NULL)
+        return -1;
+
+    index->clear();
+    open->clear();
+    samples = 0;
+
+    file = fopen(path, "r+b");
+    if (file == NULL) {
+        file = fopen(path, "w+b");
+        if (file == NULL) {
+            cout << "Unable to open " << path << ".\n";
+            return -1;
+        }
+
+        CountStoreHeader hdr;
+        hdr.magic = COUNT_STORE_MAGIC;
+        hdr.version = COUNT_STORE_VERSION;
+        hdr.cameraId = cameraId;
+        hdr.reserved = 0;
+        hdr.blockMs = blockMs;
+        fwrite(&hdr, sizeof(hdr), 1, file);
+        fflush(file);
+
+        this->cameraId = cameraId;
+        endOffset = sizeof(hdr);
+        return 0;
+    }
+
+    CountStoreHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, file) != 1 || hdr.magic != COUNT_STORE_MAGIC ||
+        hdr.version != COUNT_STORE_VERSION || hdr.blockMs <= 0) {
+        cout << "Not a count store, or an unsupported version.\n";
+        fclose(file);
+        file = NULL;
+        return -1;
+    }
+
+    this->cameraId = hdr.cameraId;
+    blockMs = hdr.blockMs;
+    return LoadIndex();
+}
+
+/*
+ * Writes out the block being filled and closes the file.
+ */
+int CountStore::Close(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (file == NULL)
+        return 0;
+
+    int err = WriteBlock();
+    fclose(file);
+    file = NULL;
+    return err;
+}
+
+/*
+ * Adds a sample, which must be later than the last one. Returns -1 if it
+ * isn't, or if in or out are negative.
+ */
+int CountStore::Append(const CountSample& sample) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (file == NULL || sample.in < 0 || sample.out < 0)
+        return -1;
+
+    long long lastMs = LLONG_MIN;
+    if (!open->empty())
+        lastMs = open->back().tMs;
+    else if (!index->empty())
+        lastMs = index->back().head.lastMs;
+    if (sample.tMs <= lastMs)
+        return -1;
+
+    if (!open->empty() && (open->size() == COUNT_BLOCK_SAMPLES ||
+                           sample.tMs / blockMs != open->front().tMs / blockMs)) {
+        if (WriteBlock())
+            return -1;
+    }
+
+    open->push_back(sample);
+    samples++;
+    return 0;
+}
+
+/*
+ * Totals of the samples in [fromMs, toMs), including the block still
+ * being filled. minCount and maxCount are 0 if there are none.
+ */
+int CountStore::Query(long long fromMs, long long toMs, CountTotals* totals) {
+    totals->in = 0;
+    totals->out = 0;
+    totals->minCount = INT_MAX;
+    totals->maxCount = INT_MIN;
+    totals->samples = 0;
+
+    std::lock_guard<std::mutex> lock(*mutex);
+    int err = 0;
+
+    // First block that ends at or after fromMs
+    auto it = std::lower_bound(index->begin(), index->end(), fromMs, [](const BlockIndex& b, long long t) {
+        return b.head.lastMs < t;
+    });
+
+    for (; it != index->end() && it->head.firstMs < toMs; ++it) {
+        const CountBlockHead& h = it->head;
+        if (h.firstMs >= fromMs && h.lastMs < toMs) {
+            totals->in += h.sumIn;
+            totals->out += h.sumOut;
+            totals->minCount = std::min(totals->minCount, (int)h.minCount);
+            totals->maxCount = std::max(totals->maxCount, (int)h.maxCount);
+            totals->samples += h.numSamples;
+        }
+        else if (ReadBlock(*it) == 0) {
+            AddSamples(*decoded, fromMs, toMs, totals);
+        }
+        else {
+            err = -1;
+        }
+    }
+
+    AddSamples(*open, fromMs, toMs, totals);
+
+    if (totals->samples == 0) {
+        totals->minCount = 0;
+        totals->maxCount = 0;
+    }
+
+    return err;
+}
+
+int CountStore::GetCameraId(void) {
+    return cameraId;
+}
+
+long long CountStore::GetSamples(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return samples;
+}
+
+int CountStore::GetBlocks(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return (int)index->size();
+}
+
+/*
+ * Size of the file, not counting the block being filled.
+ */
+long long CountStore::GetBytes(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return endOffset;
+}
+
+/*
+ * Blocks read back from disk by queries, as opposed to answered from the
+ * index.
+ */
+long long CountStore::GetBlocksDecoded(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return blocksDecoded;
+}
+
+CountStore::~CountStore() {
+    Close();
+    delete index;
+    delete open;
+    delete bytes;
+    delete decoded;
+    delete mutex;
+}
+
+/************************** Private Functions **************************/
+
+/*
+ * Reads the summary of every block, skipping over the columns. Only the
+ * last block's columns are checked, since a crash can only have cut that
+ * one short; anything after the last whole block is cut off.
+ */
+int CountStore::LoadIndex(void) {
+    fseek(file, 0, SEEK_END);
+    long long size = ftell(file);
+    long long offset = sizeof(CountStoreHeader);
+
+    while (offset + (long long)sizeof(CountBlockHead) <= size) {
+        BlockIndex block;
+        fseek(file, (long)offset, SEEK_SET);
+        if (fread(&block.head, sizeof(block.head), 1, file) != 1)
+            break;
+
+        const CountBlockHead& h = block.head;
+        long long next = offset + sizeof(h) + h.dataBytes;
+        if (h.magic != COUNT_BLOCK_MAGIC || h.numSamples == 0 || h.numSamples > COUNT_BLOCK_SAMPLES ||
+            next > size || (!index->empty() && h.firstMs <= index->back().head.lastMs))
+            break;
+
+        block.offset = offset;
+        index->push_back(block);
+        samples += h.numSamples;
+        offset = next;
+    }
+
+    if (!index->empty() && ReadBlock(index->back())) {
+        offset = index->back().offset;
+        samples -= index->back().head.numSamples;
+        index->pop_back();
+    }
+
+    if (offset < size) {
+        cout << "Count store is cut short, dropping " << size - offset << " bytes.\n";
+        fflush(file);
+#ifdef _WIN32
+        _chsize_s(_fileno(file), offset);
+#else
+        if (ftruncate(fileno(file), offset) != 0)
+            cout << "Unable to truncate the count store.\n";
+#endif
+    }
+
+    endOffset = offset;
+    return 0;
+}
+
+/*
+ * Encodes the block being filled and appends it to the file.
+ */
+int CountStore::WriteBlock(void) {
+    if (open->empty())
+        return 0;
+
+    CountBlockHead h;
+    h.magic = COUNT_BLOCK_MAGIC;
+    h.numSamples = (uint32_t)open->size();
+    h.firstMs = open->front().tMs;
+    h.lastMs = open->back().tMs;
+    h.sumIn = 0;
+    h.sumOut = 0;
+    h.minCount = INT_MAX;
+    h.maxCount = INT_MIN;
+
+    bytes->clear();
+    long long prevMs = h.firstMs;
+    long long prevDelta = 0;
+    for (size_t i = 1; i < open->size(); i++) {
+        long long delta = (*open)[i].tMs - prevMs;
+        PutVarint(*bytes, ZigZag(delta - prevDelta));
+        prevMs = (*open)[i].tMs;
+        prevDelta = delta;
+    }
+
+    for (auto it = open->begin(); it != open->end(); ++it) {
+        PutVarint(*bytes, it->in);
+        h.sumIn += it->in;
+    }
+
+    for (auto it = open->begin(); it != open->end(); ++it) {
+        PutVarint(*bytes, it->out);
+        h.sumOut += it->out;
+    }
+
+    int prevCount = 0;
+    for (auto it = open->begin(); it != open->end(); ++it) {
+        PutVarint(*bytes, ZigZag((long long)it->count - prevCount));
+        prevCount = it->count;
+        h.minCount = std::min(h.minCount, (int32_t)it->count);
+        h.maxCount = std::max(h.maxCount, (int32_t)it->count);
+    }
+
+    h.dataBytes = (uint32_t)bytes->size();
+    h.checksum = Fnv1a(*bytes);
+
+    fseek(file, (long)endOffset, SEEK_SET);
+    if (fwrite(&h, sizeof(h), 1, file) != 1 || fwrite(bytes->data(), 1, bytes->size(), file) != bytes->size() ||
+        fflush(file) != 0) {
+        cout << "Unable to write to the count store.\n";
+        return -1;
+    }
+
+    BlockIndex block;
+    block.head = h;
+    block.offset = endOffset;
+    index->push_back(block);
+
+    endOffset += sizeof(h) + h.dataBytes;
+    open->clear();
+    return 0;
+}
+
+/*
+ * Reads a block's columns from disk and decodes them into decoded.
+ */
+int CountStore::ReadBlock(const BlockIndex& block) {
+    const CountBlockHead& h = block.head;
+    bytes->resize(h.dataBytes);
+    decoded->resize(h.numSamples);
+    blocksDecoded++;
+
+    fseek(file, (long)(block.offset + sizeof(h)), SEEK_SET);
+    if (fread(bytes->data(), 1, h.dataBytes, file) != h.dataBytes || Fnv1a(*bytes) != h.checksum) {
+        cout << "Count store block at " << block.offset << " is corrupt.\n";
+        return -1;
+    }
+
+    size_t pos = 0;
+    uint64_t v;
+    bool ok = true;
+
+    long long t = h.firstMs;
+    long long delta = 0;
+    (*decoded)[0].tMs = t;
+    for (uint32_t i = 1; i < h.numSamples; i++) {
+        ok = ok && GetVarint(*bytes, &pos, &v);
+        delta += UnZigZag(v);
+        t += delta;
+        (*decoded)[i].tMs = t;
+    }
+
+    for (uint32_t i = 0; i < h.numSamples; i++) {
+        ok = ok && GetVarint(*bytes, &pos, &v);
+        (*decoded)[i].in = (int)v;
+    }
+
+    for (uint32_t i = 0; i < h.numSamples; i++) {
+        ok = ok && GetVarint(*bytes, &pos, &v);
+        (*decoded)[i].out = (int)v;
+    }
+
+    long long count = 0;
+    for (uint32_t i = 0; i < h.numSamples; i++) {
+        ok = ok && GetVarint(*bytes, &pos, &v);
+        count += UnZigZag(v);
+        (*decoded)[i].count = (int)count;
+    }
+
+    if (!ok || pos != bytes->size()) {
+        cout << "Count store block at " << block.offset << " is corrupt.\n";
+        return -1;
+    }
+
+    return 0;
+}
+
+void CountStore::AddSamples(const vector<CountSample>& s, long long fromMs, long long toMs, CountTotals* totals) {
+    for (auto it = s.begin(); it != s.end(); ++it) {
+        if (it->tMs < fromMs || it->tMs >= toMs)
+            continue;
+
+        totals->in += it->in;
+        totals->out += it->out;
+        totals->minCount = std::min(totals->minCount, it->count);
+        totals->maxCount = std::max(totals->maxCount, it->count);
+        totals->samples++;
+    }
+}
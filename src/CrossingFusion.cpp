@@ -0,0 +1,274 @@
+/*
+ *  CrossingFusion.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "CrossingFusion.h"
+#include <climits>
+
+using std::vector;
+using std::multimap;
+
+CrossingFusion::CrossingFusion(double refPos, long long windowMs, long long holdMs, long long staleMs)
+    : refPos(refPos), windowMs(windowMs), holdMs(holdMs), staleMs(staleMs), clock(GetSteadyClock()),
+      peopleCount(0), peopleIn(0), peopleOut(0), crossings(0), merged(0), unmatchable(0) {
+    cameras = new vector<FusionCamera>();
+    feeds = new vector<Feed*>();
+    progressMs = new vector<long long>();
+    heardMs = new vector<long long>();
+    pending = new multimap<long long, Crossing>();
+    mutex = new std::mutex();
+}
+
+/*
+ * Clock that cameras going quiet are timed on. Must be set before the
+ * first camera is added.
+ */
+void CrossingFusion::SetClock(Clock* clk) {
+    clock = clk;
+}
+
+/*
+ * Adds a camera and returns its index, or -1 if there are too many. All
+ * cameras must be added before the first path.
+ */
+int CrossingFusion::AddCamera(const FusionCamera& cam) {
+    if (cameras->size() == FUSION_MAX_CAMERAS)
+        return -1;
+
+    int camera = (int)cameras->size();
+    cameras->push_back(cam);
+    feeds->push_back(new Feed(this, camera));
+    progressMs->push_back(LLONG_MIN);
+    heardMs->push_back(clock->NowMs());
+    return camera;
+}
+
+/*
+ * Listener to add to the camera's Trajectories. Owned by the fusion.
+ */
+PathListener* CrossingFusion::GetFeed(int camera) {
+    return (*feeds)[camera];
+}
+
+void CrossingFusion::Feed::OnPathEnd(const TrajRecord& rec) {
+    fusion->AddPath(camera, rec);
+}
+
+/*
+ * Takes the path of a person the camera counted. It is merged into a
+ * crossing another camera already reported if there is one, and held
+ * otherwise. Can be called from each camera's tracking thread.
+ */
+void CrossingFusion::AddPath(int camera, const TrajRecord& rec) {
+    const FusionCamera& cam = (*cameras)[camera];
+    unsigned bit = 1u << camera;
+
+    // Directions are along the trail, LEFT being towards its start
+    int dir = rec.head.dir;
+    if (cam.trailPerPx < 0)
+        dir = (dir == LEFT) ? RIGHT : LEFT;
+
+    long long refMs;
+    bool matchable = TimeAtRef(cam, rec, &refMs);
+
+    std::lock_guard<std::mutex> lock(*mutex);
+    crossings++;
+    (*heardMs)[camera] = clock->NowMs();
+
+    if (rec.head.numPoints > 0) {
+        long long endMs = rec.head.startMs + rec.points[rec.head.numPoints - 1].tMs + cam.offsetMs;
+        if (endMs > (*progressMs)[camera])
+            (*progressMs)[camera] = endMs;
+    }
+
+    if (!matchable) {
+        unmatchable++;
+        Count(dir);
+        return;
+    }
+
+    // Closest crossing in the window that this camera hasn't reported
+    auto best = pending->end();
+    long long bestGap = 0;
+    for (auto it = pending->lower_bound(refMs - windowMs); it != pending->end() && it->first <= refMs + windowMs;
+         ++it) {
+        if (it->second.dir != dir || (it->second.cameras & bit) != 0)
+            continue;
+
+        long long gap = (it->first > refMs) ? it->first - refMs : refMs - it->first;
+        if (best == pending->end() || gap < bestGap) {
+            best = it;
+            bestGap = gap;
+        }
+    }
+
+    if (best != pending->end()) {
+        best->second.cameras |= bit;
+        merged++;
+    }
+    else {
+        Crossing crossing;
+        crossing.dir = dir;
+        crossing.cameras = bit;
+        pending->insert(std::make_pair(refMs, crossing));
+    }
+
+    Flush();
+}
+
+/*
+ * The camera's clock has reached cameraMs, so it has reported everyone
+ * it is going to for the time before that. Should be called regularly
+ * for every camera, since crossings are only counted once all of them
+ * have moved on.
+ */
+void CrossingFusion::Advance(int camera, long long cameraMs) {
+    std::lock_guard<std::mutex> lock(*mutex);
+
+    (*heardMs)[camera] = clock->NowMs();
+    long long siteMs = cameraMs + (*cameras)[camera].offsetMs;
+    if (siteMs > (*progressMs)[camera])
+        (*progressMs)[camera] = siteMs;
+
+    Flush();
+}
+
+int CrossingFusion::GetPeopleCount(void) {
+    return peopleCount;
+}
+
+/*
+ * People counted going towards the start of the trail.
+ */
+int CrossingFusion::GetPeopleIn(void) {
+    return peopleIn;
+}
+
+int CrossingFusion::GetPeopleOut(void) {
+    return peopleOut;
+}
+
+/*
+ * Crossings reported by all the cameras together.
+ */
+long long CrossingFusion::GetCrossings(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return crossings;
+}
+
+/*
+ * Crossings found to be a person another camera already reported.
+ */
+long long CrossingFusion::GetMerged(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return merged;
+}
+
+/*
+ * Crossings whose path never passed the reference point, which were
+ * counted without looking for duplicates.
+ */
+long long CrossingFusion::GetUnmatchable(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return unmatchable;
+}
+
+int CrossingFusion::GetPending(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+    return (int)pending->size();
+}
+
+/*
+ * Cameras that have gone quiet, which counting is not waiting for.
+ */
+int CrossingFusion::GetStaleCameras(void) {
+    std::lock_guard<std::mutex> lock(*mutex);
+
+    int stale = 0;
+    long long nowMs = clock->NowMs();
+    for (int i = 0; i < (int)cameras->size(); i++) {
+        if (IsStale(i, nowMs))
+            stale++;
+    }
+
+    return stale;
+}
+
+/*
+ * Site time at which the path last passed the reference point,
+ * interpolated between the points either side of it. Returns false if
+ * it never did.
+ */
+bool CrossingFusion::TimeAtRef(const FusionCamera& cam, const TrajRecord& rec, long long* refMs) {
+    bool found = false;
+
+    for (int i = 0; i < rec.head.numPoints - 1; i++) {
+        const TrajPoint& a = rec.points[i];
+        const TrajPoint& b = rec.points[i + 1];
+        double da = cam.trailAtX0 + cam.trailPerPx * a.x - refPos;
+        double db = cam.trailAtX0 + cam.trailPerPx * b.x - refPos;
+
+        if ((da < 0 && db < 0) || (da > 0 && db > 0))
+            continue;
+
+        double frac = (da != db) ? da / (da - db) : 0;
+        *refMs = rec.head.startMs + cam.offsetMs + a.tMs + (long long)(frac * (b.tMs - a.tMs));
+        found = true;
+    }
+
+    return found;
+}
+
+void CrossingFusion::Count(int dir) {
+    if (dir == LEFT) {
+        peopleIn++;
+        peopleCount.store(peopleCount + 1);
+    }
+    else {
+        peopleOut++;
+        if (peopleCount != 0)
+            peopleCount.store(peopleCount - 1);
+    }
+}
+
+bool CrossingFusion::IsStale(int camera, long long nowMs) {
+    return nowMs - (*heardMs)[camera] > staleMs;
+}
+
+/*
+ * Counts the crossings that no camera still reporting can report a
+ * duplicate of any more.
+ */
+void CrossingFusion::Flush(void) {
+    long long nowMs = clock->NowMs();
+    long long watermarkMs = LLONG_MAX;
+    for (int i = 0; i < (int)cameras->size(); i++) {
+        if (!IsStale(i, nowMs) && (*progressMs)[i] < watermarkMs)
+            watermarkMs = (*progressMs)[i];
+    }
+
+    // Until every camera still reporting has, or none is
+    if (watermarkMs == LLONG_MIN || watermarkMs == LLONG_MAX)
+        return;
+
+    auto it = pending->begin();
+    while (it != pending->end() && it->first + windowMs + holdMs < watermarkMs) {
+        Count(it->second.dir);
+        it = pending->erase(it);
+    }
+}
+
+CrossingFusion::~CrossingFusion() {
+    for (auto it = feeds->begin(); it != feeds->end(); ++it)
+        delete *it;
+
+    delete cameras;
+    delete feeds;
+    delete progressMs;
+    delete heardMs;
+    delete pending;
+    delete mutex;
+}
@@ -6,24 +6,63 @@
  */
 
 #include "HikerCam.h"
-#include <iostream>
+#include "Logger.h"
+#include <chrono>
 
 using namespace Spinnaker;
 using namespace Spinnaker::GenApi;
 using namespace Spinnaker::GenICam;
 
-using std::cout;
 using std::vector;
 using std::mutex;
+using std::chrono::steady_clock;
 
-HikerCam::HikerCam() : mSystem(NULL), mCamera(NULL), endAcquistionSignal(false) {
+static uintptr_t HashText(const char* text) {
+    uint32_t hash = 2166136261u;
+    for (const char* c = text; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+ * Points the view at the pixels of a complete image.
+ */
+static void MakeImageView(ImagePtr img, ImageView& view) {
+    view.data = (const uint8_t*)img->GetData();
+    view.width = (int)img->GetWidth();
+    view.height = (int)img->GetHeight();
+    view.stride = (int)img->GetStride();
+    view.format = img->GetPixelFormat();
+}
+
+HikerCam::HikerCam() : mSystem(NULL), mCamera(NULL), frameRate(0), endAcquistionSignal(false), imagePipeline(NULL),
+                       pipelineImages(NULL), numPipelineImages(0),
+                       framesDelivered(0), incompleteFrames(0), totalBoxLatencyNs(0), maxBoxLatencyNs(0),
+                       eventsRegistered(false) {
+    sdkLog = new SpinnakerLog();
     bufferMutex = new mutex();
+    cameraMutex = new mutex();
     boundingBoxBuffer = new vector<InferenceBoundingBox>();
+    jitter = new WakeupJitter();
+    events = new CameraEvents();
 }
 
+/*
+ * Sets up the first camera found for inference. Can be called again
+ * after CloseCamera to reconnect to it.
+ */
 int HikerCam::InitCamera(void) {
-    // Get the current system
-    mSystem = System::GetInstance();
+    std::lock_guard<mutex> lock(*cameraMutex);
+
+    // Get the current system, released in the destructor
+    if (mSystem == NULL) {
+        mSystem = System::GetInstance();
+        mSystem->RegisterLoggingEvent(*sdkLog);
+        mSystem->SetLoggingEventPriorityLevel(SPINNAKER_LOG_LEVEL);
+    }
 
     // Get list of cameras connected to the system
     CameraList camList = mSystem->GetCameras();
@@ -33,9 +72,8 @@ int HikerCam::InitCamera(void) {
     if (numCameras == 0)
     {
         camList.Clear();
-        mSystem->ReleaseInstance();
 
-        cout << "No cameras connected!\n";
+        GetLogger()->Error("No cameras connected!");
         return -1;
     }
 
@@ -54,9 +92,20 @@ int HikerCam::InitCamera(void) {
         // Enable inference settings
         if (EnableInference(mNodeMap))
             return -1;
+
+        // Time frames on the camera if it can tell which image is which
+        if (EnableChunks(mNodeMap) == 0 && events->Enable(mNodeMap) == 0) {
+            mCamera->RegisterEvent(*events);
+            eventsRegistered = true;
+        }
+
+        // Back to the rate asked for before a reconnect, such as the idle one
+        double fps = frameRate.load();
+        if (fps > 0 && ApplyFrameRate(fps))
+            GetLogger()->Warn("Unable to set the frame rate back to {} fps.", fps);
     }
     catch (Spinnaker::Exception& e) {
-        cout << "Spinnaker exception caught: " << e.GetErrorMessage() << ".\n";
+        GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
         return -1;
     }
 
@@ -70,21 +119,58 @@ int HikerCam::StartAcquisition(void) {
         // Get the nodemap
         INodeMap& mNodeMap = mCamera->GetNodeMap();
 
+        // Frame IDs and the camera's clock may have started over
+        events->Reset();
+
         // Start Acquisition
         mCamera->BeginAcquisition();
 
+        long long lastArrivalUs = 0;
+        long long lastStampUs = 0;
+        long long lastCompleteUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock::now().time_since_epoch()).count();
+        uint64_t grabTimeout = (frameTimeoutMs > 0) ? (uint64_t)frameTimeoutMs : EVENT_TIMEOUT_INFINITE;
+
         while (!endAcquistionSignal) {
-            ImagePtr img = mCamera->GetNextImage();
-            
+            // Throws once the timeout runs out
+            ImagePtr img = mCamera->GetNextImage(grabTimeout);
+            steady_clock::time_point received = steady_clock::now();
+
+            // The camera's clock isn't ours, so a wakeup is late by how much
+            // longer than the camera's frame interval it was since the last
+            long long arrivalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                received.time_since_epoch()).count();
+            long long stampUs = (long long)(img->GetTimeStamp() / 1000);
+            if (lastArrivalUs != 0)
+                jitter->Record((arrivalUs - lastArrivalUs) - (stampUs - lastStampUs));
+            lastArrivalUs = arrivalUs;
+            lastStampUs = stampUs;
+
+            // A simulated clock follows the camera's
+            clock->OnFrameStamp(stampUs);
+
             if (img->IsIncomplete()) {
-                cout << "Image is incomplete: " << img->GetImageStatus() << ".\n";
+                // Dropped packets now and then are normal, nothing but
+                // incomplete images for the whole timeout is not
+                incompleteFrames++;
+                GetLogger()->Warn("Image is incomplete: {}.",
+                                  Image::GetImageStatusDescription(img->GetImageStatus()));
+                if (frameTimeoutMs > 0 && arrivalUs - lastCompleteUs >= frameTimeoutMs * 1000) {
+                    GetLogger()->Error("No complete image in {} ms, last status {}.", frameTimeoutMs,
+                                       Image::GetImageStatusDescription(img->GetImageStatus()));
+                    mCamera->EndAcquisition();
+                    return -1;
+                }
             }
             else {
+                lastCompleteUs = arrivalUs;
+
                 // Get chunk data
                 ChunkData chunkData = img->GetChunkData();
 
                 // Save the current bounding box chunk data
                 InferenceBoundingBoxResult boundingBoxData = chunkData.GetInferenceBoundingBoxResult();
+                long long frameId = eventsRegistered ? chunkData.GetFrameID() : 0;
 
                 // Lock the mutex
                 bufferMutex->lock();
@@ -98,21 +184,107 @@ int HikerCam::StartAcquisition(void) {
                     boundingBoxBuffer->push_back(boundingBoxData.GetBoxAt(i));
                 }
 
+                // Keep the image the boxes came from, replacing the last one
+                latestImage = img;
+
                 // Unlock the mutex
                 bufferMutex->unlock();
+
+                PublishFrame();
+
+                long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    steady_clock::now() - received).count();
+                framesDelivered++;
+                totalBoxLatencyNs += ns;
+                if (ns > maxBoxLatencyNs)
+                    maxBoxLatencyNs.store(ns);
+
+                if (eventsRegistered)
+                    events->OnImage(frameId, arrivalUs, arrivalUs + ns / 1000);
+
+                // Image work only starts once the boxes are out. The image is
+                // handed over held, so it is copied on a worker.
+                if (imagePipeline != NULL) {
+                    PipelineImage* held = NULL;
+                    for (int i = 0; i < numPipelineImages && held == NULL; i++) {
+                        if (!pipelineImages[i].busy.load())
+                            held = &pipelineImages[i];
+                    }
+
+                    ImageView view;
+                    MakeImageView(img, view);
+                    if (held != NULL) {
+                        held->busy.store(true);
+                        held->image = img;
+                    }
+                    imagePipeline->Submit(view, img->GetFrameID(), held);
+                }
             }
         }
 
         mCamera->EndAcquisition();
     }
     catch (Spinnaker::Exception & e) {
-        cout << "Spinnaker exception caught: " << e.GetErrorMessage() << ".\n";
+        if (e.GetError() == SPINNAKER_ERR_TIMEOUT)
+            GetLogger()->Error("No image from the camera in {} ms.", frameTimeoutMs);
+        else
+            GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
         return -1;
     }
 
     return 0;
 }
 
+/*
+ * Called by Spinnaker on its own threads. All its messages share one
+ * format, so they are rate limited by their text instead.
+ */
+void SpinnakerLog::OnLogEvent(LoggingEventDataPtr data) {
+    int priority = data->GetPriority();
+    int level = LOG_LVL_DEBUG;
+    if (priority <= LOG_LEVEL_ERROR)
+        level = LOG_LVL_ERROR;
+    else if (priority <= LOG_LEVEL_WARN)
+        level = LOG_LVL_WARN;
+    else if (priority <= LOG_LEVEL_INFO)
+        level = LOG_LVL_INFO;
+
+    const char* message = data->GetLogMessage();
+    GetLogger()->LogKeyed(level, HashText(message), "Spinnaker {}: {}", data->GetCategoryName(), message);
+}
+
+/*
+ * Stops and de-initializes the camera after acquisition failed, so that
+ * InitCamera finds it again. The boxes of the last frame are dropped, as
+ * they will be out of date by the time frames come again.
+ */
+void HikerCam::CloseCamera(void) {
+    bufferMutex->lock();
+    boundingBoxBuffer->clear();
+    latestImage = NULL;
+    bufferMutex->unlock();
+
+    std::lock_guard<mutex> lock(*cameraMutex);
+    if (mCamera == NULL)
+        return;
+
+    try {
+        if (mCamera->IsStreaming())
+            mCamera->EndAcquisition();
+        if (eventsRegistered) {
+            eventsRegistered = false;
+            mCamera->UnregisterEvent(*events);
+        }
+        if (mCamera->IsInitialized())
+            mCamera->DeInit();
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+    }
+
+    mCamera = NULL;
+}
+
 void HikerCam::EndAcquisition(void) {
     endAcquistionSignal.store(true);
 }
@@ -131,28 +303,184 @@ void HikerCam::EndAcquisition(void) {
      bufferMutex->unlock();
 }
 
+/*
+ * Copies out the latest bounding boxes along with the image they were
+ * found in. The image is held, and its buffer kept from the camera,
+ * until the next call.
+ */
+void HikerCam::GetFrameData(vector<InferenceBoundingBox>& buf, ImageView& img) {
+    bufferMutex->lock();
+
+    buf = *boundingBoxBuffer;
+    heldImage = latestImage;
+
+    bufferMutex->unlock();
+
+    img.data = NULL;
+    if (heldImage != NULL && !heldImage->IsIncomplete())
+        MakeImageView(heldImage, img);
+}
+
+/*
+ * Hands every complete image to the given pipeline after its bounding
+ * boxes have been published. The pipeline is not owned by the camera,
+ * must be started before acquisition starts, and stopped before the
+ * camera is deleted, since it holds on to images until they are copied.
+ */
+void HikerCam::SetImagePipeline(ImagePipeline* pipeline) {
+    imagePipeline = pipeline;
+
+    delete[] pipelineImages;
+    numPipelineImages = pipeline->GetNumBuffers() + 1;
+    pipelineImages = new PipelineImage[numPipelineImages];
+}
+
+/*
+ * Average and worst time from an image arriving to its bounding boxes
+ * being available to GetBoundingBoxData.
+ */
+double HikerCam::GetAvgBoxLatencyUs(void) {
+    return (framesDelivered > 0) ? totalBoxLatencyNs / 1000.0 / framesDelivered : 0;
+}
+
+double HikerCam::GetMaxBoxLatencyUs(void) {
+    return maxBoxLatencyNs / 1000.0;
+}
+
+WakeupJitter* HikerCam::GetWakeupJitter(void) {
+    return jitter;
+}
+
+/*
+ * Time each frame spent on the camera and then on the host, or NULL if
+ * the camera doesn't send the events to tell.
+ */
+CameraEvents* HikerCam::GetCameraEvents(void) {
+    return eventsRegistered ? events : NULL;
+}
+
+/*
+ * Images that arrived with missing data, and were skipped.
+ */
+long long HikerCam::GetIncompleteFrames(void) {
+    return incompleteFrames;
+}
+
+/*
+ * Switches the camera between triggering a frame on every inference
+ * result (fps == 0) and free running at a fixed, lower frame rate.
+ * The network still runs on every frame that is captured, so a person
+ * walking into view is still detected while running at the low rate.
+ * While the camera is being set up again the rate is only remembered,
+ * without waiting, and set once the camera is back.
+ */
+int HikerCam::SetFrameRate(double fps) {
+    frameRate.store(fps);
+
+    std::unique_lock<mutex> lock(*cameraMutex, std::try_to_lock);
+    if (!lock.owns_lock() || mCamera == NULL)
+        return 0;
+
+    return ApplyFrameRate(fps);
+}
+
 HikerCam::~HikerCam() {
-    // Clear the camera list
-    CameraList camList = mSystem->GetCameras();
-    camList.Clear();
+    latestImage = NULL;
+    heldImage = NULL;
+
+    // The pipeline must have been stopped, so none of these is in use
+    delete[] pipelineImages;
+
+    if (eventsRegistered) {
+        try {
+            mCamera->UnregisterEvent(*events);
+        }
+        catch (Spinnaker::Exception& e) {
+            GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+        }
+    }
     mCamera = NULL;
 
-    // Release the system
-    mSystem->ReleaseInstance();
-    mSystem = NULL;
+    if (mSystem != NULL) {
+        // Clear the camera list
+        CameraList camList = mSystem->GetCameras();
+        camList.Clear();
+
+        // Release the system
+        mSystem->UnregisterLoggingEvent(*sdkLog);
+        mSystem->ReleaseInstance();
+        mSystem = NULL;
+    }
+    delete sdkLog;
+    delete events;
 
     // Delete bounding box buffer and mutex
     delete bufferMutex;
+    delete cameraMutex;
     delete boundingBoxBuffer;
+    delete jitter;
 }
 
 /************************** Private Functions **************************/
 
+/*
+ * Sets the frame rate on the camera. Must hold the camera mutex.
+ */
+int HikerCam::ApplyFrameRate(double fps) {
+    try {
+        INodeMap& nodeMap = mCamera->GetNodeMap();
+
+        if (fps > 0) {
+            // Enable manual frame rate control
+            CBooleanPtr frameRateEnable = nodeMap.GetNode("AcquisitionFrameRateEnable");
+            if (!IsAvailable(frameRateEnable) || !IsWritable(frameRateEnable)) {
+                GetLogger()->Error("AcquisitionFrameRateEnable is not available or writable.");
+                return -1;
+            }
+            frameRateEnable->SetValue(true);
+
+            // Set AcquisitionFrameRate, clamped to what the camera supports
+            CFloatPtr frameRate = nodeMap.GetNode("AcquisitionFrameRate");
+            if (!IsAvailable(frameRate) || !IsWritable(frameRate)) {
+                GetLogger()->Error("AcquisitionFrameRate is not available or writable.");
+                return -1;
+            }
+
+            if (fps < frameRate->GetMin())
+                fps = frameRate->GetMin();
+            else if (fps > frameRate->GetMax())
+                fps = frameRate->GetMax();
+            frameRate->SetValue(fps);
+        }
+
+        // Set TriggerMode to Off to free run, or On to trigger on InferenceReady
+        CEnumerationPtr triggerMode = nodeMap.GetNode("TriggerMode");
+        if (!IsAvailable(triggerMode) || !IsWritable(triggerMode)) {
+            GetLogger()->Error("TriggerMode is not available or writable.");
+            return -1;
+        }
+
+        CEnumEntryPtr mode = triggerMode->GetEntryByName((fps > 0) ? "Off" : "On");
+        if (!IsAvailable(mode)) {
+            GetLogger()->Error("TriggerMode entry is not a valid enum entry.");
+            return -1;
+        }
+
+        triggerMode->SetIntValue(mode->GetValue());
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+        return -1;
+    }
+
+    return 0;
+}
+
 int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Enable Inference
     CBooleanPtr inferenceEnable = nodeMap.GetNode("InferenceEnable");
     if (!IsAvailable(inferenceEnable) || !IsWritable(inferenceEnable)) {
-        cout << "InferenceEnable is not available or writable.\n";
+        GetLogger()->Error("InferenceEnable is not available or writable.");
         return -1;
     }
     else {
@@ -162,13 +490,13 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Change InferenceNetworkTypeSelector to Detection
     CEnumerationPtr networkType = nodeMap.GetNode("InferenceNetworkTypeSelector");
     if (!IsAvailable(networkType) || !IsWritable(networkType)) {
-        cout << "InferenceNetworkTypeSelector is not available or writable.\n";
+        GetLogger()->Error("InferenceNetworkTypeSelector is not available or writable.");
         return -1;
     }
     else {
         CEnumEntryPtr detectionNetwork = networkType->GetEntryByName("Detection");
         if (!IsAvailable(detectionNetwork)) {
-            cout << "Detection is not a valid enum entry.\n";
+            GetLogger()->Error("Detection is not a valid enum entry.");
             return -1;
         }
 
@@ -178,7 +506,7 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Set BoundingBoxThreshold to 0.60
     CFloatPtr boundingBoxThreshold = nodeMap.GetNode("InferenceBoundingBoxThreshold");
     if (!IsAvailable(boundingBoxThreshold) || !IsWritable(boundingBoxThreshold)) {
-        cout << "InferenceBoundingBoxThreshold is not available or writable.\n";
+        GetLogger()->Error("InferenceBoundingBoxThreshold is not available or writable.");
         return -1;
     }
     else {
@@ -188,13 +516,13 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Set TriggerSelector to FrameStart
     CEnumerationPtr triggerSelector = nodeMap.GetNode("TriggerSelector");
     if (!IsAvailable(triggerSelector) || !IsWritable(triggerSelector)) {
-        cout << "TriggerSelector is not available or writable.\n";
+        GetLogger()->Error("TriggerSelector is not available or writable.");
         return -1;
     }
     else {
         CEnumEntryPtr frameStart = triggerSelector->GetEntryByName("FrameStart");
         if (!IsAvailable(frameStart)) {
-            cout << "FrameStart is not a valid enum entry.\n";
+            GetLogger()->Error("FrameStart is not a valid enum entry.");
             return -1;
         }
 
@@ -204,13 +532,13 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Set TriggerMode to On
     CEnumerationPtr triggerMode = nodeMap.GetNode("TriggerMode");
     if (!IsAvailable(triggerMode) || !IsWritable(triggerMode)) {
-        cout << "TriggerMode is not available or writable.\n";
+        GetLogger()->Error("TriggerMode is not available or writable.");
         return -1;
     }
     else {
         CEnumEntryPtr onMode = triggerMode->GetEntryByName("On");
         if (!IsAvailable(onMode)) {
-            cout << "On is not a valid enum entry.\n";
+            GetLogger()->Error("On is not a valid enum entry.");
             return -1;
         }
 
@@ -220,13 +548,13 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
     // Set TriggerSource to InferenceReady
     CEnumerationPtr triggerSource = nodeMap.GetNode("TriggerSource");
     if (!IsAvailable(triggerSource) || !IsWritable(triggerSource)) {
-        cout << "TriggerSource is not available or writable.\n";
+        GetLogger()->Error("TriggerSource is not available or writable.");
         return -1;
     }
     else {
         CEnumEntryPtr infReady = triggerSource->GetEntryByName("InferenceReady");
         if (!IsAvailable(infReady)) {
-            cout << "InferenceReady is not a valid enum entry.\n";
+            GetLogger()->Error("InferenceReady is not a valid enum entry.");
             return -1;
         }
 
@@ -238,3 +566,45 @@ int HikerCam::EnableInference(INodeMap& nodeMap) {
 
 
 
+
+/*
+ * Sends the frame ID along with every image, so that the camera's events
+ * can be matched with the image they were about.
+ */
+int HikerCam::EnableChunks(INodeMap& nodeMap) {
+    // Enable chunk data
+    CBooleanPtr chunkMode = nodeMap.GetNode("ChunkModeActive");
+    if (!IsAvailable(chunkMode) || !IsWritable(chunkMode)) {
+        GetLogger()->Warn("ChunkModeActive is not available or writable.");
+        return -1;
+    }
+    chunkMode->SetValue(true);
+
+    // Select the FrameID chunk
+    CEnumerationPtr chunkSelector = nodeMap.GetNode("ChunkSelector");
+    if (!IsAvailable(chunkSelector) || !IsWritable(chunkSelector)) {
+        GetLogger()->Warn("ChunkSelector is not available or writable.");
+        return -1;
+    }
+    else {
+        CEnumEntryPtr frameId = chunkSelector->GetEntryByName("FrameID");
+        if (!IsAvailable(frameId)) {
+            GetLogger()->Warn("FrameID is not a valid enum entry.");
+            return -1;
+        }
+
+        chunkSelector->SetIntValue(frameId->GetValue());
+    }
+
+    // Enable it
+    CBooleanPtr chunkEnable = nodeMap.GetNode("ChunkEnable");
+    if (!IsAvailable(chunkEnable)) {
+        GetLogger()->Warn("ChunkEnable is not available.");
+        return -1;
+    }
+    else if (IsWritable(chunkEnable)) {
+        chunkEnable->SetValue(true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ *  ClipRecorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ClipRecorder.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include "SpinVideo.h"
+#endif
+
+#define CLIP_FRAME_BYTES (CLIP_MAX_WIDTH * CLIP_MAX_HEIGHT * 3)
+
+using namespace Spinnaker;
+
+using std::string;
+using std::vector;
+
+static long long NowMs(void) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Writes every CLIP_SCALE'th pixel of the image into dst as RGB8. Bayer
+ * images are sampled one 2x2 block at a time. Returns -1 if the pixel
+ * format isn't supported.
+ */
+static int Downscale(const ImageView& img, uint8_t* dst, int width, int height) {
+    int rx = 0;
+    int ry = 0;
+    bool bayer = true;
+    switch (img.format) {
+        case PixelFormat_BayerRG8: rx = 0; ry = 0; break;
+        case PixelFormat_BayerGR8: rx = 1; ry = 0; break;
+        case PixelFormat_BayerGB8: rx = 0; ry = 1; break;
+        case PixelFormat_BayerBG8: rx = 1; ry = 1; break;
+        case PixelFormat_Mono8:
+        case PixelFormat_RGB8:
+        case PixelFormat_BGR8:     bayer = false; break;
+        default:                   return -1;
+    }
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = img.data + (size_t)(y * CLIP_SCALE) * img.stride;
+        const uint8_t* next = row + img.stride;
+        uint8_t* out = dst + (size_t)y * width * 3;
+
+        for (int x = 0; x < width; x++, out += 3) {
+            int sx = x * CLIP_SCALE;
+
+            if (bayer) {
+                const uint8_t* rows[2] = { row, next };
+                out[0] = rows[ry][sx + rx];
+                out[1] = (uint8_t)((rows[ry][sx + 1 - rx] + rows[1 - ry][sx + rx] + 1) >> 1);
+                out[2] = rows[1 - ry][sx + 1 - rx];
+            }
+            else if (img.format == PixelFormat_Mono8) {
+                out[0] = out[1] = out[2] = row[sx];
+            }
+            else if (img.format == PixelFormat_RGB8) {
+                memcpy(out, row + 3 * sx, 3);
+            }
+            else {
+                out[0] = row[3 * sx + 2];
+                out[1] = row[3 * sx + 1];
+                out[2] = row[3 * sx];
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Clips are written to the given directory, which must exist.
+ */
+ClipRecorder::ClipRecorder(const char* clipDir) : dir(clipDir), nextSlot(0), triggerMs(-1), encoder(NULL),
+                                                  endSignal(false), clipsWritten(0), framesSkipped(0) {
+    ring = new ClipFrame[CLIP_RING_FRAMES];
+    ringPixels = new uint8_t[(size_t)CLIP_RING_FRAMES * CLIP_FRAME_BYTES];
+    scratch = new uint8_t[CLIP_FRAME_BYTES];
+    clipSlots = new vector<ClipStamp>();
+    clipSlots->reserve(CLIP_RING_FRAMES);
+
+    for (int i = 0; i < CLIP_RING_FRAMES; i++) {
+        ring[i].seq.store(0);
+        ring[i].timeMs = -1;
+        ring[i].frameId = 0;
+        ring[i].width = 0;
+        ring[i].height = 0;
+        ring[i].pixels = ringPixels + (size_t)i * CLIP_FRAME_BYTES;
+    }
+}
+
+void ClipRecorder::Start(void) {
+    if (encoder != NULL)
+        return;
+
+    endSignal.store(false);
+    encoder = new std::thread(&ClipRecorder::RunEncoder, this);
+}
+
+/*
+ * Stops the encoder thread, after it finishes the clip it is writing.
+ */
+void ClipRecorder::Stop(void) {
+    if (encoder == NULL)
+        return;
+
+    endSignal.store(true);
+    encoder->join();
+    delete encoder;
+    encoder = NULL;
+}
+
+/*
+ * Stores a downscaled copy of the frame in the oldest slot of the ring.
+ * Called from the image pipeline workers.
+ */
+void ClipRecorder::ProcessImage(const ImageView& img, uint64_t frameId, int /* worker */) {
+    int width = std::min(img.width / CLIP_SCALE, CLIP_MAX_WIDTH);
+    int height = std::min(img.height / CLIP_SCALE, CLIP_MAX_HEIGHT);
+    if (width == 0 || height == 0)
+        return;
+
+    ClipFrame& frame = ring[nextSlot++ % CLIP_RING_FRAMES];
+
+    unsigned seq = frame.seq.load(std::memory_order_relaxed);
+    frame.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (Downscale(img, frame.pixels, width, height) == 0) {
+        frame.timeMs = NowMs();
+        frame.frameId = frameId;
+        frame.width = width;
+        frame.height = height;
+    }
+    else {
+        frame.timeMs = -1;
+    }
+
+    frame.seq.store(seq + 2, std::memory_order_release);
+}
+
+/*
+ * Marks the time of the crossing for the encoder thread to pick up.
+ */
+void ClipRecorder::OnCrossing(int /* trackId */, int /* dir */) {
+    triggerMs.store(NowMs());
+}
+
+void ClipRecorder::OnAnomaly(int /* trackId */) {
+    triggerMs.store(NowMs());
+}
+
+int ClipRecorder::GetClipsWritten(void) {
+    return clipsWritten;
+}
+
+/*
+ * Number of frames left out of clips because they were overwritten while
+ * being copied.
+ */
+long long ClipRecorder::GetFramesSkipped(void) {
+    return framesSkipped;
+}
+
+/*
+ * Waits for a crossing, then for CLIP_POST_MS after it, and writes out
+ * the frames from CLIP_PRE_MS before it. Crossings during the wait
+ * extend the clip up to CLIP_MAX_MS.
+ */
+void ClipRecorder::RunEncoder(void) {
+    while (!endSignal) {
+        long long trigger = triggerMs.load();
+        if (trigger < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(CLIP_POLL_MS));
+            continue;
+        }
+
+        long long startMs = trigger - CLIP_PRE_MS;
+        long long endMs = trigger + CLIP_POST_MS;
+        while (!endSignal && NowMs() < endMs) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(CLIP_POLL_MS));
+
+            long long latest = triggerMs.load();
+            if (latest > trigger) {
+                trigger = latest;
+                endMs = std::min(latest + CLIP_POST_MS, startMs + CLIP_MAX_MS);
+            }
+        }
+
+        // A crossing after the end of this clip starts the next one
+        triggerMs.compare_exchange_strong(trigger, -1);
+        WriteClip(startMs, endMs);
+    }
+}
+
+/*
+ * Reads when the frame in a slot was taken. Returns false if the slot is
+ * empty or was written to while it was being read.
+ */
+bool ClipRecorder::ReadStamp(int slot, ClipStamp* stamp) {
+    ClipFrame& frame = ring[slot];
+
+    unsigned seq = frame.seq.load(std::memory_order_acquire);
+    if (seq & 1)
+        return false;
+
+    stamp->timeMs = frame.timeMs;
+    stamp->frameId = frame.frameId;
+    stamp->slot = slot;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return frame.seq.load(std::memory_order_relaxed) == seq && stamp->timeMs >= 0;
+}
+
+/*
+ * Copies a frame out of the ring into the scratch buffer. Returns false
+ * if the slot is empty or was written to while it was being copied.
+ */
+bool ClipRecorder::CopyFrame(int slot, uint64_t* frameId, int* width, int* height) {
+    ClipFrame& frame = ring[slot];
+
+    unsigned seq = frame.seq.load(std::memory_order_acquire);
+    if (seq & 1)
+        return false;
+
+    long long timeMs = frame.timeMs;
+    *frameId = frame.frameId;
+    *width = frame.width;
+    *height = frame.height;
+    if (timeMs >= 0)
+        memcpy(scratch, frame.pixels, (size_t)*width * *height * 3);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return frame.seq.load(std::memory_order_relaxed) == seq && timeMs >= 0;
+}
+
+void ClipRecorder::WriteClip(long long startMs, long long endMs) {
+    // Find the frames in the clip, oldest first
+    clipSlots->clear();
+    for (int i = 0; i < CLIP_RING_FRAMES; i++) {
+        ClipStamp stamp;
+        if (ReadStamp(i, &stamp) && stamp.timeMs >= startMs && stamp.timeMs <= endMs)
+            clipSlots->push_back(stamp);
+    }
+    std::sort(clipSlots->begin(), clipSlots->end(), [](const ClipStamp& a, const ClipStamp& b) {
+        return a.frameId < b.frameId;
+    });
+
+    if (clipSlots->empty())
+        return;
+
+    char name[512];
+    int clip = clipsWritten;
+    int written = 0;
+
+#ifdef _WIN32
+    Video::SpinVideo video;
+    Video::AVIOption option;
+    option.frameRate = (float)(1000.0 * clipSlots->size() / std::max(endMs - startMs, 1LL));
+    snprintf(name, sizeof(name), "%s/clip_%04d", dir.c_str(), clip);
+
+    try {
+        video.Open(name, option);
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+        return;
+    }
+#endif
+
+    for (auto it = clipSlots->begin(); it != clipSlots->end(); ++it) {
+        // A different frame in the slot now is out of order, or out of the clip
+        uint64_t frameId;
+        int width;
+        int height;
+        if (!CopyFrame(it->slot, &frameId, &width, &height) || frameId != it->frameId) {
+            framesSkipped++;
+            continue;
+        }
+
+#ifdef _WIN32
+        try {
+            video.Append(Image::Create(width, height, 0, 0, PixelFormat_RGB8, scratch));
+        }
+        catch (Spinnaker::Exception& e) {
+            GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+            break;
+        }
+#else
+        snprintf(name, sizeof(name), "%s/clip_%04d_%03d.ppm", dir.c_str(), clip, written);
+        FILE* f = fopen(name, "wb");
+        if (f == NULL) {
+            GetLogger()->Error("Unable to open {}.", name);
+            break;
+        }
+        fprintf(f, "P6\n%d %d\n255\n", width, height);
+        fwrite(scratch, 1, (size_t)width * height * 3, f);
+        fclose(f);
+#endif
+        written++;
+    }
+
+#ifdef _WIN32
+    video.Close();
+#endif
+
+    if (written > 0)
+        clipsWritten++;
+}
+
+ClipRecorder::~ClipRecorder() {
+    Stop();
+
+    delete[] ring;
+    delete[] ringPixels;
+    delete[] scratch;
+    delete clipSlots;
+}
@@ -0,0 +1,91 @@
+/*
+ *  ConvertStage.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ConvertStage.h"
+#include "Logger.h"
+
+using namespace Spinnaker;
+
+using std::vector;
+
+/*
+ * Bytes per pixel of the formats that can be converted to.
+ */
+static int BytesPerPixel(PixelFormatEnums format) {
+    switch (format) {
+        case PixelFormat_Mono8:  return 1;
+        case PixelFormat_RGB8:
+        case PixelFormat_BGR8:   return 3;
+        default:                 return 4;
+    }
+}
+
+ConvertStage::ConvertStage(PixelFormatEnums fmt, int numWorkers) : format(fmt) {
+    buffers = new vector<ConvertBuffer>(numWorkers);
+    consumers = new vector<ImageConsumer*>();
+
+    for (auto it = buffers->begin(); it != buffers->end(); ++it)
+        it->pixels = new vector<uint8_t>();
+}
+
+/*
+ * Consumers of the converted images, must be added before the pipeline
+ * is started.
+ */
+void ConvertStage::AddConsumer(ImageConsumer* consumer) {
+    consumers->push_back(consumer);
+}
+
+/*
+ * Converts the image into this worker's buffer. The Image objects that
+ * wrap the source and destination are made on the first frame and only
+ * pointed at the new data after that.
+ */
+void ConvertStage::ProcessImage(const ImageView& img, uint64_t frameId, int worker) {
+    ConvertBuffer& buf = (*buffers)[worker];
+    size_t size = (size_t)img.width * img.height * BytesPerPixel(format);
+    if (buf.pixels->size() < size)
+        buf.pixels->resize(size);
+
+    try {
+        if (buf.src == NULL) {
+            buf.src = Image::Create(img.width, img.height, 0, 0, img.format, (void*)img.data);
+            buf.dst = Image::Create(img.width, img.height, 0, 0, format, &(*buf.pixels)[0]);
+        }
+        else {
+            buf.src->ResetImage(img.width, img.height, 0, 0, img.format, (void*)img.data);
+            buf.dst->ResetImage(img.width, img.height, 0, 0, format, &(*buf.pixels)[0]);
+        }
+
+        buf.src->Convert(buf.dst, format);
+    }
+    catch (Spinnaker::Exception& e) {
+        GetLogger()->Error("Spinnaker exception caught: {}.", e.GetErrorMessage());
+        return;
+    }
+
+    ImageView out;
+    out.data = &(*buf.pixels)[0];
+    out.width = img.width;
+    out.height = img.height;
+    out.stride = img.width * BytesPerPixel(format);
+    out.format = format;
+
+    for (auto it = consumers->begin(); it != consumers->end(); ++it)
+        (*it)->ProcessImage(out, frameId, worker);
+}
+
+ConvertStage::~ConvertStage() {
+    for (auto it = buffers->begin(); it != buffers->end(); ++it) {
+        it->src = NULL;
+        it->dst = NULL;
+        delete it->pixels;
+    }
+
+    delete buffers;
+    delete consumers;
+}
@@ -0,0 +1,184 @@
+/*
+ *  Heatmap.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Heatmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HEATMAP_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HEATMAP_NEON
+#endif
+
+using namespace Spinnaker;
+
+using std::cout;
+using std::vector;
+
+/*
+ * Adds w to cells c0 to c1 of a row.
+ */
+static void AddSpan(float* row, int c0, int c1, float w) {
+    int c = c0;
+
+#if defined(HEATMAP_SSE)
+    __m128 vw = _mm_set1_ps(w);
+    for (; c + 4 <= c1 + 1; c += 4)
+        _mm_storeu_ps(row + c, _mm_add_ps(_mm_loadu_ps(row + c), vw));
+#elif defined(HEATMAP_NEON)
+    float32x4_t vw = vdupq_n_f32(w);
+    for (; c + 4 <= c1 + 1; c += 4)
+        vst1q_f32(row + c, vaddq_f32(vld1q_f32(row + c), vw));
+#endif
+
+    for (; c <= c1; c++)
+        row[c] += w;
+}
+
+/*
+ * Multiplies n cells by s, n being a multiple of 4.
+ */
+static void ScaleCells(float* cells, int n, float s) {
+#if defined(HEATMAP_SSE)
+    __m128 vs = _mm_set1_ps(s);
+    for (int i = 0; i < n; i += 4)
+        _mm_storeu_ps(cells + i, _mm_mul_ps(_mm_loadu_ps(cells + i), vs));
+#elif defined(HEATMAP_NEON)
+    float32x4_t vs = vdupq_n_f32(s);
+    for (int i = 0; i < n; i += 4)
+        vst1q_f32(cells + i, vmulq_f32(vld1q_f32(cells + i), vs));
+#else
+    for (int i = 0; i < n; i++)
+        cells[i] *= s;
+#endif
+}
+
+Heatmap::Heatmap(double halfLife) : halfLifeMs(halfLife), weight(1.0f), lastFrameMs(-1), lastSnapshotMs(-1),
+                                    snapshotMs(-1) {
+    grid = new float[HEATMAP_ROWS * HEATMAP_STRIDE];
+    memset(grid, 0, sizeof(float) * HEATMAP_ROWS * HEATMAP_STRIDE);
+
+    snapshot = new vector<float>(HEATMAP_ROWS * HEATMAP_COLS, 0.0f);
+    snapshotMutex = new std::mutex();
+}
+
+/*
+ * Called at the start of every frame. Moves the weight of new footprints
+ * on by the time since the last frame, and takes a snapshot every
+ * HEATMAP_SNAPSHOT_MS.
+ */
+void Heatmap::BeginFrame(long long nowMs) {
+    if (lastFrameMs < 0) {
+        lastFrameMs = nowMs;
+        lastSnapshotMs = nowMs;
+    }
+
+    weight *= (float)exp2((nowMs - lastFrameMs) / halfLifeMs);
+    lastFrameMs = nowMs;
+
+    if (weight > HEATMAP_MAX_WEIGHT)
+        Rescale();
+
+    if (nowMs - lastSnapshotMs >= HEATMAP_SNAPSHOT_MS) {
+        TakeSnapshot();
+        lastSnapshotMs = nowMs;
+    }
+}
+
+/*
+ * Adds the footprint of a person box: the cells under the bottom
+ * 1/HEATMAP_FOOT_FRACTION of the box.
+ */
+void Heatmap::AddBox(const InferenceBoundingBox& box) {
+    int x1 = std::max((int)box.rect.topLeftXCoord, 0);
+    int x2 = std::min((int)box.rect.bottomRightXCoord, CAM_X - 1);
+    int y2 = std::min((int)box.rect.bottomRightYCoord, CAM_Y - 1);
+    int y1 = std::max(y2 - (y2 - (int)box.rect.topLeftYCoord) / HEATMAP_FOOT_FRACTION, 0);
+    if (x2 < x1 || y2 < y1)
+        return;
+
+    int c0 = x1 / HEATMAP_CELL;
+    int c1 = x2 / HEATMAP_CELL;
+    for (int r = y1 / HEATMAP_CELL; r <= y2 / HEATMAP_CELL; r++)
+        AddSpan(grid + r * HEATMAP_STRIDE, c0, c1, weight);
+}
+
+/*
+ * Copies the grid, in frames of presence with the decay applied, to be
+ * read by other threads.
+ */
+void Heatmap::TakeSnapshot(void) {
+    float inv = 1.0f / weight;
+
+    snapshotMutex->lock();
+    for (int r = 0; r < HEATMAP_ROWS; r++) {
+        const float* row = grid + r * HEATMAP_STRIDE;
+        float* out = &(*snapshot)[r * HEATMAP_COLS];
+        for (int c = 0; c < HEATMAP_COLS; c++)
+            out[c] = row[c] * inv;
+    }
+    snapshotMs = lastFrameMs;
+    snapshotMutex->unlock();
+}
+
+/*
+ * Copies out the latest snapshot, HEATMAP_ROWS rows of HEATMAP_COLS
+ * cells, and returns the time it was taken at (-1 if none has been).
+ * Safe to call from any thread.
+ */
+long long Heatmap::GetSnapshot(vector<float>& cells) {
+    snapshotMutex->lock();
+    cells = *snapshot;
+    long long t = snapshotMs;
+    snapshotMutex->unlock();
+    return t;
+}
+
+/*
+ * Writes the latest snapshot as a greyscale image, one pixel per cell,
+ * scaled so the busiest cell is white.
+ */
+int Heatmap::WritePGM(const char* path) {
+    vector<float> cells;
+    GetSnapshot(cells);
+
+    float maxVal = *std::max_element(cells.begin(), cells.end());
+    float scale = (maxVal > 0) ? 255.0f / maxVal : 0.0f;
+
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    fprintf(f, "P5\n%d %d\n255\n", HEATMAP_COLS, HEATMAP_ROWS);
+    for (size_t i = 0; i < cells.size(); i++)
+        fputc((int)(cells[i] * scale + 0.5f), f);
+    fclose(f);
+
+    return 0;
+}
+
+/*
+ * Folds the weight into the grid so it can start growing from 1 again.
+ */
+void Heatmap::Rescale(void) {
+    ScaleCells(grid, HEATMAP_ROWS * HEATMAP_STRIDE, 1.0f / weight);
+    weight = 1.0f;
+}
+
+Heatmap::~Heatmap() {
+    delete[] grid;
+    delete snapshot;
+    delete snapshotMutex;
+}
@@ -0,0 +1,57 @@
+/*
+ *  HeatmapImage.cpp
+ *
+ *  Renders a Heatmap in colour with the Spinnaker image utilities. Kept
+ *  apart from Heatmap.cpp so the heatmap itself doesn't need the
+ *  Spinnaker libraries.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Heatmap.h"
+#include "ImageUtilityHeatmap.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace Spinnaker;
+
+using std::cout;
+using std::vector;
+
+/*
+ * Saves the latest snapshot as a colour image the size of the frame, in
+ * the format given by the file extension. Cold cells are black and the
+ * busiest cell is red.
+ */
+int SaveHeatmapImage(Heatmap& heatmap, const char* path) {
+    vector<float> cells;
+    heatmap.GetSnapshot(cells);
+
+    float maxVal = *std::max_element(cells.begin(), cells.end());
+    float scale = (maxVal > 0) ? 255.0f / maxVal : 0.0f;
+
+    int width = HEATMAP_COLS * HEATMAP_CELL;
+    int height = HEATMAP_ROWS * HEATMAP_CELL;
+    vector<uint8_t> pixels(width * height);
+    for (int y = 0; y < height; y++) {
+        const float* row = &cells[(y / HEATMAP_CELL) * HEATMAP_COLS];
+        for (int x = 0; x < width; x++)
+            pixels[y * width + x] = (uint8_t)(row[x / HEATMAP_CELL] * scale + 0.5f);
+    }
+
+    try {
+        ImagePtr mono = Image::Create(width, height, 0, 0, PixelFormat_Mono8, &pixels[0]);
+        ImageUtilityHeatmap::SetHeatmapColorGradient(ImageUtilityHeatmap::HEATMAP_BLACK,
+                                                     ImageUtilityHeatmap::HEATMAP_RED);
+        ImageUtilityHeatmap::SetHeatmapRange(0, 100);
+        ImagePtr colour = ImageUtilityHeatmap::CreateHeatmap(mono);
+        colour->Save(path);
+    }
+    catch (Spinnaker::Exception& e) {
+        cout << "Spinnaker exception caught: " << e.GetErrorMessage() << ".\n";
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+/*
+ *  ImagePipeline.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ImagePipeline.h"
+#include <chrono>
+#include <cstring>
+
+using std::vector;
+using std::deque;
+using std::mutex;
+using std::unique_lock;
+using std::thread;
+using std::condition_variable;
+
+ImagePipeline::ImagePipeline(int workerCount, int numBuffers)
+    : numWorkers(workerCount), dropPolicy(DROP_NEWEST), running(false), framePool(NULL), endSignal(false),
+      submitted(0), dropped(0), processed(0), queued(0), totalSubmitNs(0), maxSubmitNs(0) {
+    consumers = new vector<ImageConsumer*>();
+    workers = new vector<thread>();
+    slots = new vector<ImageSlot>(numBuffers);
+    freeSlots = new vector<ImageSlot*>();
+    queue = new deque<ImageSlot*>();
+    queueMutex = new mutex();
+    queueReady = new condition_variable();
+
+    for (auto it = slots->begin(); it != slots->end(); ++it) {
+        it->pixels = new vector<uint8_t>();
+        it->view.data = NULL;
+        it->hold = NULL;
+        freeSlots->push_back(&(*it));
+    }
+}
+
+/*
+ * Consumers must be added before Start and are called in the order they
+ * were added.
+ */
+void ImagePipeline::AddConsumer(ImageConsumer* consumer) {
+    consumers->push_back(consumer);
+}
+
+void ImagePipeline::SetDropPolicy(int policy) {
+    dropPolicy = policy;
+}
+
+int ImagePipeline::GetNumWorkers(void) {
+    return numWorkers;
+}
+
+/*
+ * Most images the pipeline holds at once, queued or being worked on.
+ */
+int ImagePipeline::GetNumBuffers(void) {
+    return (int)slots->size();
+}
+
+/*
+ * Copies images into slots of the arena instead of buffers that grow to
+ * the image size. Must be called before the arena is committed and
+ * before Start.
+ */
+void ImagePipeline::UseArena(Arena* arena, size_t maxImageBytes) {
+    if (framePool == NULL)
+        framePool = arena->AddPool("frames", maxImageBytes, (int)slots->size());
+}
+
+void ImagePipeline::Start(void) {
+    if (running)
+        return;
+
+    endSignal = false;
+    for (int i = 0; i < numWorkers; i++)
+        workers->push_back(thread(&ImagePipeline::RunWorker, this, i));
+    running = true;
+}
+
+/*
+ * Waits for the images being worked on to finish. Images still waiting
+ * for a worker are dropped.
+ */
+void ImagePipeline::Stop(void) {
+    if (!running)
+        return;
+
+    queueMutex->lock();
+    endSignal = true;
+    vector<ImageSlot*> waiting(queue->begin(), queue->end());
+    queue->clear();
+    queueMutex->unlock();
+    queueReady->notify_all();
+
+    for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+        FreeSlot(*it);
+        dropped++;
+    }
+
+    for (auto it = workers->begin(); it != workers->end(); ++it)
+        it->join();
+    workers->clear();
+    running = false;
+}
+
+/*
+ * Called from the acquisition thread once the bounding boxes of the frame
+ * have been published, and queues the image for the workers. Without a
+ * hold the image is copied into a free buffer first, so the caller can
+ * release the camera's buffer as soon as this returns. With one the
+ * worker copies it and releases the hold, which the pipeline owns from
+ * here on. Never waits for a worker: returns false if the image was
+ * dropped because every buffer is in use.
+ */
+bool ImagePipeline::Submit(const ImageView& img, uint64_t frameId, ImageHold* hold) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    submitted++;
+    if (!running || img.data == NULL) {
+        if (hold != NULL)
+            hold->Release();
+        dropped++;
+        return false;
+    }
+
+    ImageSlot* slot = TakeSlot();
+    if (slot == NULL) {
+        if (hold != NULL)
+            hold->Release();
+        dropped++;
+        return false;
+    }
+
+    slot->frameId = frameId;
+    slot->source = img;
+    slot->hold = hold;
+    if (hold == NULL && CopyIn(slot, img)) {
+        FreeSlot(slot);
+        dropped++;
+        return false;
+    }
+
+    queueMutex->lock();
+    queue->push_back(slot);
+    queueMutex->unlock();
+    queueReady->notify_one();
+
+    queued++;
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    totalSubmitNs += ns;
+    if (ns > maxSubmitNs)
+        maxSubmitNs.store(ns);
+
+    return true;
+}
+
+long long ImagePipeline::GetSubmitted(void) {
+    return submitted;
+}
+
+/*
+ * Number of images whose work was skipped because the workers were busy.
+ */
+long long ImagePipeline::GetDropped(void) {
+    return dropped;
+}
+
+long long ImagePipeline::GetProcessed(void) {
+    return processed;
+}
+
+/*
+ * Average and worst time the acquisition thread spent in Submit.
+ */
+double ImagePipeline::GetAvgSubmitUs(void) {
+    return (queued > 0) ? totalSubmitNs / 1000.0 / queued : 0;
+}
+
+double ImagePipeline::GetMaxSubmitUs(void) {
+    return maxSubmitNs / 1000.0;
+}
+
+void ImagePipeline::RunWorker(int worker) {
+    while (true) {
+        ImageSlot* slot;
+        {
+            unique_lock<mutex> lock(*queueMutex);
+            queueReady->wait(lock, [this] { return endSignal || !queue->empty(); });
+            if (queue->empty())
+                return;
+
+            slot = queue->front();
+            queue->pop_front();
+        }
+
+        // Copy a held image out, so it can go back to the camera before
+        // the work on it starts
+        if (slot->hold != NULL) {
+            int err = CopyIn(slot, slot->source);
+            slot->hold->Release();
+            slot->hold = NULL;
+
+            if (err) {
+                FreeSlot(slot);
+                dropped++;
+                continue;
+            }
+        }
+
+        for (auto it = consumers->begin(); it != consumers->end(); ++it)
+            (*it)->ProcessImage(slot->view, slot->frameId, worker);
+        processed++;
+
+        FreeSlot(slot);
+    }
+}
+
+/*
+ * Gets a buffer to copy a new image into, following the drop policy when
+ * there are none free. Returns NULL if the new image should be dropped.
+ */
+ImageSlot* ImagePipeline::TakeSlot(void) {
+    ImageSlot* slot = NULL;
+
+    queueMutex->lock();
+    if (!freeSlots->empty()) {
+        slot = freeSlots->back();
+        freeSlots->pop_back();
+    }
+    else if (dropPolicy == DROP_OLDEST && !queue->empty()) {
+        slot = queue->front();
+        queue->pop_front();
+        dropped++;
+    }
+
+    if (framePool != NULL)
+        framePool->NoteUsed((int)(slots->size() - freeSlots->size()) + (slot == NULL));
+    queueMutex->unlock();
+
+    // The dropped image was never copied
+    if (slot != NULL && slot->hold != NULL) {
+        slot->hold->Release();
+        slot->hold = NULL;
+    }
+
+    return slot;
+}
+
+/*
+ * Copies the image into the slot's buffer. Returns -1 if it doesn't fit
+ * in the arena.
+ */
+int ImagePipeline::CopyIn(ImageSlot* slot, const ImageView& img) {
+    size_t size = (size_t)img.stride * img.height;
+    uint8_t* pixels;
+    if (framePool != NULL) {
+        pixels = (uint8_t*)framePool->GetSlot((int)(slot - &(*slots)[0]));
+        if (pixels == NULL || size > framePool->GetSlotSize()) {
+            framePool->NoteRefused();
+            return -1;
+        }
+    }
+    else {
+        // Only grows until it fits the camera's images
+        if (slot->pixels->size() < size)
+            slot->pixels->resize(size);
+        pixels = &(*slot->pixels)[0];
+    }
+    memcpy(pixels, img.data, size);
+
+    slot->view = img;
+    slot->view.data = pixels;
+    return 0;
+}
+
+void ImagePipeline::FreeSlot(ImageSlot* slot) {
+    if (slot->hold != NULL) {
+        slot->hold->Release();
+        slot->hold = NULL;
+    }
+
+    queueMutex->lock();
+    freeSlots->push_back(slot);
+    queueMutex->unlock();
+}
+
+ImagePipeline::~ImagePipeline() {
+    Stop();
+
+    for (auto it = slots->begin(); it != slots->end(); ++it)
+        delete it->pixels;
+
+    delete consumers;
+    delete workers;
+    delete slots;
+    delete freeSlots;
+    delete queue;
+    delete queueMutex;
+    delete queueReady;
+}
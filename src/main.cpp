@@ -10,6 +10,20 @@
 #include "Centroid.h"
 #include "Kalman.h"
 #include "StateCentroid.h"
+#include "IoU.h"
+#include "FixedStateCentroid.h"
+#include "SimCam.h"
+#include "Scenario.h"
+#include "ImagePipeline.h"
+#include "ConvertStage.h"
+#include "ClipRecorder.h"
+#include "Arena.h"
+#include "ThreadControl.h"
+#include "CoPipeline.h"
+#include "StagedPipeline.h"
+#include "CountStore.h"
+#include "Logger.h"
+#include <chrono>
 #include <iostream>
 #include <thread>
 
@@ -18,9 +32,154 @@
  *      1 - Centroid
  *      2 - Kalman
  *      3 - StateCentroid
+ *      4 - IoU
+ *      5 - FixedStateCentroid (StateCentroid in fixed point, for boards
+ *          without a fast FPU)
  */
 #define TRACKER_IMPL 3
 
+/*
+ * Set to 1 to lower the frame rate while nobody is in view.
+ */
+#define ADAPTIVE_RATE 1
+
+/*
+ * Set to 1 to keep people who are hidden for a moment, e.g. behind a
+ * signpost, on the same tracker instead of counting them twice.
+ */
+#define REIDENTIFY 0
+
+/*
+ * Set to 1 to only make a tracker for a box once it has been seen in a
+ * few frames, so one-off false detections are never counted.
+ */
+#define TENTATIVE_TRACKS 0
+
+/*
+ * Set to 1 to count people from a synthetic scenario instead of the
+ * camera. The run ends once the scenario is over and a report of the
+ * counting accuracy and the number of frames processed is printed. With
+ * SIM_REPLAY the scenario is played on a simulated clock, as fast as the
+ * CPU allows and with the same count every run, instead of in real time.
+ */
+#define USE_SIM_CAM 0
+#define SIM_REPLAY  1
+#define SIM_DURATION_MS     (10 * 60 * 1000)
+#define SIM_PEOPLE_PER_HOUR 60
+#define SIM_SEED            1
+
+/*
+ * Number of threads doing image work off the acquisition thread, 0 turns
+ * image processing off. Images are converted to IMAGE_FORMAT first.
+ */
+#define IMAGE_WORKERS 0
+#define IMAGE_FORMAT  PixelFormat_RGB8
+
+/*
+ * Set to 1 to save a short clip around every crossing to CLIP_DIR. Needs
+ * IMAGE_WORKERS.
+ */
+#define RECORD_CLIPS 0
+#define CLIP_DIR     "clips"
+
+/*
+ * Set to 1 to keep a heatmap of where people walk, saved to HEATMAP_PATH
+ * every HEATMAP_SAVE_MS.
+ */
+#define HEATMAP         1
+#define HEATMAP_PATH    "heatmap.png"
+#define HEATMAP_SAVE_MS (10 * 60 * 1000)
+
+/*
+ * Set to 1 to log the path of every person counted to TRAJECTORY_LOG.
+ */
+#define TRAJECTORIES   0
+#define TRAJECTORY_LOG "trajectories.hktj"
+
+/*
+ * Set to 1 to keep hourly distributions of walking speed and time in
+ * view, the last hour's printed every STATS_REPORT_MS.
+ */
+#define TRACK_STATS     1
+#define STATS_REPORT_MS (60 * 60 * 1000)
+
+/*
+ * Set to 1 to store the people in and out every COUNT_SAMPLE_MS, along
+ * with the count, in COUNT_STORE_PATH for queries over months or years.
+ * Only when running on the camera.
+ */
+#define COUNT_STORE      0
+#define COUNT_STORE_PATH "counts.hkcs"
+#define COUNT_SAMPLE_MS  (60 * 1000)
+
+/*
+ * Set to 1 to reconnect to the camera when it goes WATCHDOG_DEADLINE_MS
+ * without a frame, instead of waiting for it forever. The outages and how
+ * long each took to recover from are printed every WATCHDOG_REPORT_MS.
+ */
+#define CAMERA_WATCHDOG    1
+#define WATCHDOG_REPORT_MS (10 * 60 * 1000)
+
+/*
+ * Set to 1 to take the trackers, the per frame box buffers and the image
+ * buffers from one allocation made at startup, sized by ArenaCaps. How
+ * much of each was used is printed every ARENA_REPORT_MS.
+ */
+#define ARENA           0
+#define ARENA_REPORT_MS (10 * 60 * 1000)
+
+/*
+ * CPUs to pin the acquisition, tracking and export threads to, or
+ * THREAD_ANY_CPU. The export thread is the main loop, which prints the
+ * count and saves the heatmap. Acquisition and tracking run under
+ * THREAD_POLICY: THREAD_SCHED_NORMAL, THREAD_SCHED_FIFO or
+ * THREAD_SCHED_RR. How late each thread woke up is printed every
+ * JITTER_REPORT_MS, along with how long frames spent on the camera from
+ * the end of their exposure, if the camera reports it.
+ */
+#define ACQ_CPU          THREAD_ANY_CPU
+#define TRACK_CPU        THREAD_ANY_CPU
+#define EXPORT_CPU       THREAD_ANY_CPU
+#define THREAD_POLICY    THREAD_SCHED_NORMAL
+#define JITTER_REPORT_MS (10 * 60 * 1000)
+
+/*
+ * How frames get from the camera to the tracker:
+ *      0 - a tracking thread that polls the camera once per inference
+ *      1 - coroutine stages on a one thread Executor, woken up by the
+ *          camera for every frame
+ *      2 - stages on threads of their own joined by queues, whose depth,
+ *          drops and wait times are printed every PIPELINE_REPORT_MS
+ * 1 and 2 drop re-identification by image and TRACK_CPU.
+ */
+#define PIPELINE           0
+#define PIPELINE_REPORT_MS (10 * 60 * 1000)
+
+/*
+ * Messages from the camera, tracking and image threads are printed by a
+ * background thread, see Logger. Set LOG_TO_FILE to 1 to also append
+ * them to LOG_PATH, which is moved aside every LOG_ROTATE_BYTES.
+ */
+#define LOG_TO_FILE 1
+#define LOG_PATH    "hikercam.log"
+
+/*
+ * Tracker thresholds, reloaded whenever the file changes.
+ */
+#define CONFIG_PATH "hikercam.xml"
+
+#if (TRACKER_IMPL == 1) 
+typedef Centroid TrackerImpl;
+#elif (TRACKER_IMPL == 2)
+typedef Kalman TrackerImpl;
+#elif (TRACKER_IMPL == 3)
+typedef StateCentroid TrackerImpl;
+#elif (TRACKER_IMPL == 4)
+typedef IoU TrackerImpl;
+#elif (TRACKER_IMPL == 5)
+typedef FixedStateCentroid TrackerImpl;
+#endif
+
 using namespace Spinnaker;
 using std::cout;
 using std::thread;
@@ -29,35 +188,282 @@ using std::vector;
 int main(void) {
     int err = 0;
 
-#if (TRACKER_IMPL == 1) 
-    PeopleCounter<Centroid>* cntr = new PeopleCounter<Centroid>();
-#elif (TRACKER_IMPL == 2)
-    PeopleCounter<Kalman>* cntr = new PeopleCounter<Kalman>();
-#elif (TRACKER_IMPL == 3)
-    PeopleCounter<StateCentroid>* cntr = new PeopleCounter<StateCentroid>();
+#if LOG_TO_FILE
+    GetLogger()->OpenFile(LOG_PATH);
 #endif
 
+#if ARENA
+    Arena* arena = new Arena();
+    ArenaCaps caps;
+#endif
+
+#if USE_SIM_CAM
+    Scenario* scenario = new Scenario();
+    scenario->GenerateSynthetic(SIM_DURATION_MS, SIM_PEOPLE_PER_HOUR, SIM_SEED);
+    SimCam* cam = new SimCam(scenario);
+    PeopleCounter<TrackerImpl>* cntr = new PeopleCounter<TrackerImpl>(cam);
+#if SIM_REPLAY
+    SimClock* simClock = new SimClock();
+    cntr->SetClock(simClock);
+#endif
+#elif IMAGE_WORKERS
+#if ARENA
+    ImagePipeline* pipeline = new ImagePipeline(IMAGE_WORKERS, caps.framesInFlight);
+    pipeline->UseArena(arena, caps.maxImageBytes);
+#else
+    ImagePipeline* pipeline = new ImagePipeline(IMAGE_WORKERS);
+#endif
+    ConvertStage* convert = new ConvertStage(IMAGE_FORMAT, IMAGE_WORKERS);
+    pipeline->AddConsumer(convert);
+#if RECORD_CLIPS
+    ClipRecorder* clips = new ClipRecorder(CLIP_DIR);
+    pipeline->AddConsumer(clips);
+    clips->Start();
+#endif
+    pipeline->Start();
+
+    HikerCam* cam = new HikerCam();
+    cam->SetImagePipeline(pipeline);
+    PeopleCounter<TrackerImpl>* cntr = new PeopleCounter<TrackerImpl>(cam);
+#if RECORD_CLIPS
+    cntr->AddCountListener(clips);
+#endif
+#else
+    PeopleCounter<TrackerImpl>* cntr = new PeopleCounter<TrackerImpl>();
+#endif
+
+#if ADAPTIVE_RATE
+    cntr->EnableActivityControl();
+#endif
+
+#if REIDENTIFY
+    cntr->EnableReIdentification();
+#endif
+
+#if TENTATIVE_TRACKS
+    cntr->EnableTentativeTracks();
+#endif
+
+#if HEATMAP
+    cntr->EnableHeatmap();
+#endif
+
+#if TRAJECTORIES
+    cntr->EnableTrajectories();
+    cntr->GetTrajectories()->OpenLog(TRAJECTORY_LOG);
+#endif
+
+#if TRACK_STATS
+    cntr->EnableTrackStats();
+#endif
+
+#if CAMERA_WATCHDOG
+    cntr->EnableWatchdog();
+#endif
+
+    cntr->SetThreadPlacement(ThreadPlacement(ACQ_CPU, THREAD_POLICY), ThreadPlacement(TRACK_CPU, THREAD_POLICY));
+    PlaceThisThread(ThreadPlacement(EXPORT_CPU));
+    WakeupJitter exportJitter;
+
+#if ARENA
+    cntr->UseArena(arena, caps);
+    if (arena->Commit()) {
+        cout << "Error allocating the arena!\n";
+        return -1;
+    }
+#endif
+
+    // Fall back to the default thresholds if there is no config file
+    ConfigStore* config = cntr->GetConfigStore();
+    if (config->LoadFile(CONFIG_PATH))
+        cout << "Using the default tracker config.\n";
+
     err = cntr->InitPeopleCounter();
     if (err) {
         cout << "Error InitTracker!\n";
         return -1;
     }
 
+#if (USE_SIM_CAM && SIM_REPLAY)
+    // Tracks every frame on this thread as the scenario plays
+    cntr->Replay();
+#elif (PIPELINE == 1)
+    Executor* executor = new Executor(1);
+    CoPipeline<TrackerImpl>* stages = new CoPipeline<TrackerImpl>(executor, cntr);
+    executor->Start();
+    stages->Start();
+#elif (PIPELINE == 2)
+    StagedPipeline<TrackerImpl>* stages = new StagedPipeline<TrackerImpl>(cntr);
+    stages->Start();
+#else
     // Create acquisition thread.
-#if (TRACKER_IMPL == 1) 
-    thread acqThread(&PeopleCounter<Centroid>::StartPeopleCounter, cntr);
-#elif (TRACKER_IMPL == 2)
-    thread acqThread(&PeopleCounter<Kalman>::StartPeopleCounter, cntr);
-#elif (TRACKER_IMPL == 3)
-    thread acqThread(&PeopleCounter<StateCentroid>::StartPeopleCounter, cntr);
+    thread acqThread(&PeopleCounter<TrackerImpl>::StartPeopleCounter, cntr);
+#endif
+
+#if USE_SIM_CAM
+#if !SIM_REPLAY
+    while (!cam->IsFinished()) {
+        cout << cntr->GetPeopleCount() << "\n";
+        config->ReloadIfChanged();
+        exportJitter.SleepFor(500);
+    }
+
+    // Give the trackers time to expire the last people, and leave
+    // re-identification, under the config in use
+    TrackerConfig lastConfig;
+    config->Copy(lastConfig);
+    cntr->GetClock()->SleepForUs((lastConfig.missingThresh + REID_WINDOW + 2) * INFERENCE_TIME * 1000LL);
+#if (PIPELINE == 1)
+    stages->Stop();
+    executor->Stop();
+    delete stages;
+    delete executor;
+#elif (PIPELINE == 2)
+    stages->Stop();
+    stages->PrintReport();
+    delete stages;
+#else
+    cntr->StopPeopleCounter();
+    acqThread.join();
+#endif
 #endif
 
+    // People that were never in a frame, or only in one, can't be counted
+    int missed = 0;
+    int seenOnce = 0;
+    for (int i = 0; i < scenario->GetNumPeople(); i++) {
+        if (cam->GetFramesSeen(i) == 0)
+            missed++;
+        else if (cam->GetFramesSeen(i) == 1)
+            seenOnce++;
+    }
+
+    double fullRateFrames = scenario->GetDuration() / INFERENCE_TIME;
+    cout << "People:          " << scenario->GetNumPeople() << "\n";
+    cout << "Expected count:  " << scenario->GetExpectedCount(scenario->GetDuration()) << "\n";
+    cout << "Counted:         " << cntr->GetPeopleCount() << "\n";
+    cout << "Never seen:      " << missed << "\n";
+    cout << "Seen in 1 frame: " << seenOnce << "\n";
+    cout << "Frames:          " << cam->GetFramesDelivered() << " of " << (long long)fullRateFrames
+         << " at full rate (" << 100.0 * (1.0 - cam->GetFramesDelivered() / fullRateFrames) << "% saved)\n";
+
+    ActivityController* activity = cntr->GetActivityController();
+    if (activity != NULL) {
+        cout << "Time active:     " << activity->GetTimeInMode(MODE_ACTIVE) / 1000 << " s\n";
+        cout << "Time idle:       " << activity->GetTimeInMode(MODE_IDLE) / 1000 << " s\n";
+        cout << "Mode switches:   " << activity->GetModeSwitches() << "\n";
+    }
+
+    cout << "Trackers made:   " << cntr->GetTrackersCreated() << "\n";
+    TentativeTracks* tentative = cntr->GetTentativeTracks();
+    if (tentative != NULL) {
+        cout << "Tentative:       " << tentative->GetCreated() << " (" << tentative->GetRejected()
+             << " rejected)\n";
+    }
+
+    cntr->GetAcquisitionJitter()->PrintReport("Acquisition");
+    cntr->GetTrackingJitter()->PrintReport("Tracking");
+    exportJitter.PrintReport("Export");
+
+#if ARENA
+    arena->PrintReport();
+#endif
+#if TRAJECTORIES
+    cntr->GetTrajectories()->PrintReport();
+#endif
+#if TRACK_STATS
+    // The simulation is shorter than a bucket, so report the bucket it ran in
+    cntr->GetTrackStats()->PrintReport(cntr->GetClock()->NowMs() + STATS_BUCKET_MS);
+#endif
+#if CAMERA_WATCHDOG
+    cntr->GetWatchdog()->PrintReport();
+#endif
+
+    delete cntr;
+    delete scenario;
+#if SIM_REPLAY
+    delete simClock;
+#endif
+#else
+#if COUNT_STORE
+    CountStore* counts = new CountStore();
+    if (counts->Open(COUNT_STORE_PATH))
+        cout << "Not storing counts.\n";
+    int lastIn = 0;
+    int lastOut = 0;
+#endif
+
+    int loops = 0;
     while (1) {
         cout << cntr->GetPeopleCount() << "\n";
-        Sleep(500);
+        config->ReloadIfChanged();
+        exportJitter.SleepFor(500);
+
+        loops++;
+#if HEATMAP
+        if (loops % (HEATMAP_SAVE_MS / 500) == 0)
+            SaveHeatmapImage(*cntr->GetHeatmap(), HEATMAP_PATH);
+#endif
+#if ARENA
+        if (loops % (ARENA_REPORT_MS / 500) == 0)
+            arena->PrintReport();
+#endif
+#if TRACK_STATS
+        if (loops % (STATS_REPORT_MS / 500) == 0)
+            cntr->GetTrackStats()->PrintReport(cntr->GetClock()->NowMs());
+#endif
+#if COUNT_STORE
+        if (loops % (COUNT_SAMPLE_MS / 500) == 0) {
+            // Stamped with the wall clock so it can be queried by date
+            CountSample sample;
+            sample.tMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            sample.in = cntr->GetPeopleIn() - lastIn;
+            sample.out = cntr->GetPeopleOut() - lastOut;
+            sample.count = cntr->GetPeopleCount();
+            lastIn += sample.in;
+            lastOut += sample.out;
+            counts->Append(sample);
+        }
+#endif
+        if (loops % (JITTER_REPORT_MS / 500) == 0) {
+            cntr->GetAcquisitionJitter()->PrintReport("Acquisition");
+            cntr->GetTrackingJitter()->PrintReport("Tracking");
+            exportJitter.PrintReport("Export");
+
+            CameraEvents* camEvents = cntr->GetBoxSource()->GetCameraEvents();
+            if (camEvents != NULL)
+                camEvents->PrintReport();
+        }
+#if (PIPELINE == 2)
+        if (loops % (PIPELINE_REPORT_MS / 500) == 0)
+            stages->PrintReport();
+#endif
+#if CAMERA_WATCHDOG
+        if (loops % (WATCHDOG_REPORT_MS / 500) == 0)
+            cntr->GetWatchdog()->PrintReport();
+#endif
     }
 
+#if COUNT_STORE
+    delete counts;
+#endif
+#if IMAGE_WORKERS
+    // Gives the images it holds back to the camera before it goes
+    pipeline->Stop();
+#endif
     delete cntr;
+#if IMAGE_WORKERS
+    delete pipeline;
+    delete convert;
+#if RECORD_CLIPS
+    delete clips;
+#endif
+#endif
+#endif
+#if ARENA
+    delete arena;
+#endif
     return 0;
 }
 
@@ -0,0 +1,217 @@
+/*
+ *  BoxStream.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "BoxStream.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace Spinnaker;
+
+using std::cout;
+using std::vector;
+
+BoxStream::BoxStream() : header(NULL), frames(NULL), boxes(NULL), crossings(NULL) {
+    buffer = new vector<uint8_t>();
+}
+
+/*
+ * Reads the whole file into memory.
+ */
+int BoxStream::Load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    buffer->resize(size);
+    size_t read = fread(buffer->data(), 1, size, f);
+    fclose(f);
+
+    if (read != (size_t)size) {
+        cout << "Unable to read " << path << ".\n";
+        return -1;
+    }
+
+    return Attach(buffer->data(), buffer->size());
+}
+
+/*
+ * Uses a stream that is already in memory. The memory must outlive
+ * this object and is never copied.
+ */
+int BoxStream::Attach(const uint8_t* data, size_t size) {
+    if (size < sizeof(StreamHeader)) {
+        cout << "Box stream is too short.\n";
+        return -1;
+    }
+
+    const StreamHeader* hdr = (const StreamHeader*)data;
+    if (hdr->magic != BOX_STREAM_MAGIC || hdr->version != BOX_STREAM_VERSION) {
+        cout << "Not a box stream, or an unsupported version.\n";
+        return -1;
+    }
+
+    size_t expected = sizeof(StreamHeader) +
+                      hdr->numFrames * sizeof(StreamFrame) +
+                      hdr->numBoxes * sizeof(StreamBox) +
+                      hdr->numCrossings * sizeof(StreamCrossing);
+    if (size < expected) {
+        cout << "Box stream is truncated.\n";
+        return -1;
+    }
+
+    // Every frame's boxes must be in the box table
+    const StreamFrame* frm = (const StreamFrame*)(data + sizeof(StreamHeader));
+    for (uint32_t i = 0; i < hdr->numFrames; i++) {
+        if ((uint64_t)frm[i].firstBox + frm[i].numBoxes > hdr->numBoxes) {
+            cout << "Box stream frame " << i << " has boxes outside the box table.\n";
+            return -1;
+        }
+    }
+
+    header = hdr;
+    frames = frm;
+    boxes = (const StreamBox*)(frames + hdr->numFrames);
+    crossings = (const StreamCrossing*)(boxes + hdr->numBoxes);
+
+    return 0;
+}
+
+int BoxStream::GetNumFrames(void) const {
+    return (header != NULL) ? (int)header->numFrames : 0;
+}
+
+double BoxStream::GetFrameTime(int frame) const {
+    return frames[frame].tMs;
+}
+
+/*
+ * Fills boxes with the inference results of the given frame. If ids is
+ * not NULL, it is filled with the ground truth identity of each box.
+ */
+void BoxStream::GetFrame(int frame, vector<InferenceBoundingBox>& out, vector<int>* ids) const {
+    out.clear();
+    if (ids != NULL)
+        ids->clear();
+
+    const StreamBox* box = boxes + frames[frame].firstBox;
+    for (uint32_t i = 0; i < frames[frame].numBoxes; i++, box++) {
+        InferenceBoundingBox b;
+        memset(&b, 0, sizeof(b));
+        b.boxType = INFERENCE_BOX_TYPE_RECTANGLE;
+        b.classId = box->classId;
+        b.confidence = box->confidence;
+        b.rect.topLeftXCoord = box->topLeftXCoord;
+        b.rect.topLeftYCoord = box->topLeftYCoord;
+        b.rect.bottomRightXCoord = box->bottomRightXCoord;
+        b.rect.bottomRightYCoord = box->bottomRightYCoord;
+
+        out.push_back(b);
+        if (ids != NULL)
+            ids->push_back(box->gtId);
+    }
+}
+
+int BoxStream::GetNumCrossings(void) const {
+    return (header != NULL) ? (int)header->numCrossings : 0;
+}
+
+const StreamCrossing& BoxStream::GetCrossing(int i) const {
+    return crossings[i];
+}
+
+BoxStream::~BoxStream() {
+    delete buffer;
+}
+
+/*************************** BoxStreamWriter ***************************/
+
+BoxStreamWriter::BoxStreamWriter() {
+    frames = new vector<StreamFrame>();
+    boxes = new vector<StreamBox>();
+    crossings = new vector<StreamCrossing>();
+}
+
+/*
+ * Adds a frame of boxes, and their ground truth identities if ids is not
+ * NULL. Returns -1, without adding the frame, if an identity doesn't fit
+ * in a box.
+ */
+int BoxStreamWriter::AddFrame(double tMs, const vector<InferenceBoundingBox>& frameBoxes,
+                              const vector<int>* ids) {
+    for (size_t i = 0; ids != NULL && i < ids->size(); i++) {
+        if ((*ids)[i] < NO_GT_ID || (*ids)[i] > MAX_GT_ID) {
+            cout << "Ground truth ID " << (*ids)[i] << " doesn't fit in a box stream.\n";
+            return -1;
+        }
+    }
+
+    StreamFrame frame;
+    frame.tMs = tMs;
+    frame.firstBox = (uint32_t)boxes->size();
+    frame.numBoxes = (uint32_t)frameBoxes.size();
+    frames->push_back(frame);
+
+    for (size_t i = 0; i < frameBoxes.size(); i++) {
+        StreamBox box;
+        box.topLeftXCoord = frameBoxes[i].rect.topLeftXCoord;
+        box.topLeftYCoord = frameBoxes[i].rect.topLeftYCoord;
+        box.bottomRightXCoord = frameBoxes[i].rect.bottomRightXCoord;
+        box.bottomRightYCoord = frameBoxes[i].rect.bottomRightYCoord;
+        box.classId = frameBoxes[i].classId;
+        box.gtId = (int16_t)((ids != NULL) ? (*ids)[i] : NO_GT_ID);
+        box.confidence = frameBoxes[i].confidence;
+        boxes->push_back(box);
+    }
+
+    return 0;
+}
+
+void BoxStreamWriter::AddCrossing(int gtId, int dir, double tMs) {
+    StreamCrossing crossing;
+    crossing.gtId = gtId;
+    crossing.dir = dir;
+    crossing.tMs = tMs;
+    crossings->push_back(crossing);
+}
+
+int BoxStreamWriter::Save(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    StreamHeader hdr;
+    hdr.magic = BOX_STREAM_MAGIC;
+    hdr.version = BOX_STREAM_VERSION;
+    hdr.numFrames = (uint32_t)frames->size();
+    hdr.numBoxes = (uint32_t)boxes->size();
+    hdr.numCrossings = (uint32_t)crossings->size();
+    hdr.reserved = 0;
+
+    fwrite(&hdr, sizeof(hdr), 1, f);
+    fwrite(frames->data(), sizeof(StreamFrame), frames->size(), f);
+    fwrite(boxes->data(), sizeof(StreamBox), boxes->size(), f);
+    fwrite(crossings->data(), sizeof(StreamCrossing), crossings->size(), f);
+
+    int err = ferror(f) ? -1 : 0;
+    fclose(f);
+    return err;
+}
+
+BoxStreamWriter::~BoxStreamWriter() {
+    delete frames;
+    delete boxes;
+    delete crossings;
+}
@@ -0,0 +1,284 @@
+/*
+ *  Scenario.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Scenario.h"
+#include <algorithm>
+#include <random>
+
+// Detection confidence reported for every simulated box
+#define SIM_CONFIDENCE 0.90
+
+// Confidence of boxes the detector is unsure about, which are dropped
+// by the PeopleCounter, and of false positives, which are not
+#define SIM_LOW_CONFIDENCE 0.30
+#define SIM_FP_CONFIDENCE  0.75
+
+using namespace Spinnaker;
+
+using std::vector;
+
+Scenario::Scenario() : durationMs(0), seed(0), dropRate(0), jitter(0), falsePositiveRate(0),
+                       occluderX1(0), occluderX2(0), viewX(0), trailLength(CAM_X) {
+    people = new vector<SimPerson>();
+}
+
+/*
+ * Fills the scenario with people arriving at random over the given
+ * duration. People arrive in small groups walking the same direction,
+ * which is what is usually seen on the trails, with long empty periods
+ * in between when the rate is low.
+ */
+void Scenario::GenerateSynthetic(double duration, double peoplePerHour, unsigned rngSeed) {
+    std::mt19937 rng(rngSeed);
+    std::exponential_distribution<double> groupGap(peoplePerHour / 2.0 / 3600000.0);
+    std::uniform_int_distribution<int> groupSize(1, 3);
+    std::uniform_real_distribution<double> spacing(1000, 3000);
+    std::uniform_real_distribution<double> speed(0.1, 0.4);
+    std::uniform_int_distribution<int> yPos(CAM_Y / 3, 2 * CAM_Y / 3);
+    std::uniform_int_distribution<int> height(CAM_Y / 3, CAM_Y / 2);
+    std::bernoulli_distribution leftToRight(0.5);
+
+    seed = rngSeed;
+    durationMs = duration;
+    people->clear();
+
+    double t = groupGap(rng);
+    int id = 0;
+    while (t < duration) {
+        int size = groupSize(rng);
+        double groupSpeed = leftToRight(rng) ? speed(rng) : -speed(rng);
+
+        for (int i = 0; i < size; i++) {
+            SimPerson person;
+            person.id = id++;
+            person.startMs = t;
+            person.speed = groupSpeed;
+            person.y = yPos(rng);
+            person.height = height(rng);
+            person.width = person.height / 3;
+            people->push_back(person);
+
+            if (GetEndTime(person) > durationMs)
+                durationMs = GetEndTime(person);
+
+            t += spacing(rng);
+        }
+
+        t += groupGap(rng);
+    }
+}
+
+void Scenario::AddPerson(SimPerson person) {
+    auto it = std::upper_bound(people->begin(), people->end(), person,
+        [](const SimPerson& a, const SimPerson& b) { return a.startMs < b.startMs; });
+    people->insert(it, person);
+
+    if (GetEndTime(person) > durationMs)
+        durationMs = GetEndTime(person);
+}
+
+/*
+ * Makes the detections imperfect:
+ *      dropRate - fraction of boxes reported with a confidence too low
+ *                 to be used
+ *      jitterPx - maximum error in pixels of each box edge
+ *      falsePositiveRate - chance of a box with nobody in it per frame
+ *
+ * The noise only depends on the seed, the person and the time, so the
+ * same scenario always produces the same boxes.
+ */
+void Scenario::SetNoise(double drop, double jitterPx, double fpRate) {
+    dropRate = drop;
+    jitter = jitterPx;
+    falsePositiveRate = fpRate;
+}
+
+/*
+ * Hides people while the middle of their box is between x1 and x2, like
+ * a signpost in front of the trail would. Everyone is visible again once
+ * they come out the other side.
+ */
+void Scenario::SetOccluder(int x1, int x2) {
+    occluderX1 = x1;
+    occluderX2 = x2;
+}
+
+/*
+ * Makes the camera see the part of a longer stretch of trail starting x
+ * pixels in, so two scenarios with the same people and different views
+ * act as two cameras whose views overlap. People walk the whole
+ * trailLength, and the duration grows to match.
+ */
+void Scenario::SetView(int x, int length) {
+    viewX = x;
+    trailLength = length;
+
+    for (auto it = people->begin(); it != people->end(); ++it) {
+        if (GetEndTime(*it) > durationMs)
+            durationMs = GetEndTime(*it);
+    }
+}
+
+/*
+ * Writes the boxes seen at every frameMs, along with the ground truth
+ * identities and crossings, to the given writer. Returns -1 if there are
+ * too many people for the stream to tell apart.
+ */
+int Scenario::Record(BoxStreamWriter& writer, double frameMs) const {
+    vector<InferenceBoundingBox> boxes;
+    vector<int> ids;
+
+    for (double t = frameMs; t <= durationMs; t += frameMs) {
+        GetBoxes(t, boxes, &ids);
+        if (writer.AddFrame(t, boxes, &ids))
+            return -1;
+    }
+
+    for (auto it = people->begin(); it != people->end(); ++it)
+        writer.AddCrossing(it->id, (it->speed < 0) ? LEFT : RIGHT, GetEndTime(*it));
+
+    return 0;
+}
+
+/*
+ * Produces the bounding boxes that the camera would output at the given
+ * time. If ids is not NULL, it is filled with the ground truth identity
+ * of each box, or NO_GT_ID for false positives.
+ */
+void Scenario::GetBoxes(double tMs, vector<InferenceBoundingBox>& boxes, vector<int>* ids) const {
+    boxes.clear();
+    if (ids != NULL)
+        ids->clear();
+
+    for (auto it = people->begin(); it != people->end() && it->startMs <= tMs; ++it) {
+        double travelled = (tMs - it->startMs) * std::abs(it->speed);
+        double left;
+
+        if (it->speed > 0)
+            left = travelled - it->width - viewX;
+        else
+            left = trailLength - travelled - viewX;
+
+        double right = left + it->width;
+        if (right <= 0 || left >= CAM_X)
+            continue;
+
+        double center = (left + right) / 2;
+        if (center >= occluderX1 && center < occluderX2)
+            continue;
+
+        double top = it->y - it->height / 2;
+        double bottom = it->y + it->height / 2;
+        if (jitter > 0) {
+            uint64_t t = (uint64_t)tMs;
+            left += jitter * (2 * Random(t, it->id, 1) - 1);
+            right += jitter * (2 * Random(t, it->id, 2) - 1);
+            top += jitter * (2 * Random(t, it->id, 3) - 1);
+            bottom += jitter * (2 * Random(t, it->id, 4) - 1);
+        }
+
+        InferenceBoundingBox box;
+        memset(&box, 0, sizeof(box));
+        box.boxType = INFERENCE_BOX_TYPE_RECTANGLE;
+        box.classId = PERSON_ID;
+        box.confidence = (float)SIM_CONFIDENCE;
+        box.rect.topLeftXCoord = (int16_t)std::max(left, 0.0);
+        box.rect.bottomRightXCoord = (int16_t)std::min(right, (double)(CAM_X - 1));
+        box.rect.topLeftYCoord = (int16_t)std::max(top, 0.0);
+        box.rect.bottomRightYCoord = (int16_t)std::min(bottom, (double)(CAM_Y - 1));
+
+        if (dropRate > 0 && Random((uint64_t)tMs, it->id, 0) < dropRate)
+            box.confidence = (float)SIM_LOW_CONFIDENCE;
+
+        boxes.push_back(box);
+        if (ids != NULL)
+            ids->push_back(it->id);
+    }
+
+    if (falsePositiveRate > 0 && Random((uint64_t)tMs, 0, 5) < falsePositiveRate) {
+        int x = (int)(Random((uint64_t)tMs, 0, 6) * (CAM_X - 100));
+        int y = (int)(Random((uint64_t)tMs, 0, 7) * (CAM_Y - 300));
+
+        InferenceBoundingBox box;
+        memset(&box, 0, sizeof(box));
+        box.boxType = INFERENCE_BOX_TYPE_RECTANGLE;
+        box.classId = PERSON_ID;
+        box.confidence = (float)SIM_FP_CONFIDENCE;
+        box.rect.topLeftXCoord = (int16_t)x;
+        box.rect.bottomRightXCoord = (int16_t)(x + 100);
+        box.rect.topLeftYCoord = (int16_t)y;
+        box.rect.bottomRightYCoord = (int16_t)(y + 300);
+
+        boxes.push_back(box);
+        if (ids != NULL)
+            ids->push_back(NO_GT_ID);
+    }
+}
+
+/*
+ * Returns the count a perfect tracker would report once everyone who
+ * has fully left the frame by tMs has been counted. People moving right
+ * to left count as LEFT and increase the count, as in PeopleCounter.
+ */
+int Scenario::GetExpectedCount(double tMs) const {
+    vector<const SimPerson*> exited;
+    for (auto it = people->begin(); it != people->end(); ++it) {
+        if (GetEndTime(*it) <= tMs)
+            exited.push_back(&(*it));
+    }
+
+    std::sort(exited.begin(), exited.end(), [this](const SimPerson* a, const SimPerson* b) {
+        return GetEndTime(*a) < GetEndTime(*b);
+    });
+
+    int count = 0;
+    for (auto it = exited.begin(); it != exited.end(); ++it) {
+        if ((*it)->speed < 0)
+            count++;
+        else if (count != 0)
+            count--;
+    }
+
+    return count;
+}
+
+double Scenario::GetDuration(void) const {
+    return durationMs;
+}
+
+int Scenario::GetNumPeople(void) const {
+    return (int)people->size();
+}
+
+const SimPerson& Scenario::GetPerson(int i) const {
+    return (*people)[i];
+}
+
+Scenario::~Scenario() {
+    delete people;
+}
+
+/************************** Private Functions **************************/
+
+/*
+ * Time at which the person has completely left the frame, or the trail
+ * if the camera only sees part of it.
+ */
+double Scenario::GetEndTime(const SimPerson& person) const {
+    return person.startMs + (trailLength + person.width) / std::abs(person.speed);
+}
+
+/*
+ * Deterministic random number in [0, 1) for the given inputs.
+ */
+double Scenario::Random(uint64_t a, uint64_t b, uint64_t c) const {
+    uint64_t x = seed + a * 0x9E3779B97F4A7C15ULL + b * 0xBF58476D1CE4E5B9ULL + c * 0x94D049BB133111EBULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x = x ^ (x >> 31);
+    return (x >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,169 @@
+/*
+ *  SimCam.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "SimCam.h"
+#include <algorithm>
+#include <thread>
+
+using namespace Spinnaker;
+
+using std::vector;
+using std::mutex;
+
+SimCam::SimCam(Scenario* scenario) : mScenario(scenario), endAcquistionSignal(false), finished(false),
+                                     frameRate(0), framesDelivered(0), startUs(-1), frameTime(0), nextFault(0),
+                                     downUntilMs(0) {
+    bufferMutex = new mutex();
+    boundingBoxBuffer = new vector<InferenceBoundingBox>();
+    framesSeen = new vector<int>(scenario->GetNumPeople(), 0);
+    jitter = new WakeupJitter();
+    faults = new vector<SimFault>();
+}
+
+/*
+ * Fails while the camera is down after a fault.
+ */
+int SimCam::InitCamera(void) {
+    if (startUs >= 0 && GetScenarioMs() < downUntilMs)
+        return -1;
+
+    return 0;
+}
+
+/*
+ * Makes the camera fail at the given point of the scenario. Must be
+ * called before StartAcquisition.
+ */
+void SimCam::AddFault(const SimFault& fault) {
+    faults->push_back(fault);
+    std::sort(faults->begin(), faults->end(), [](const SimFault& a, const SimFault& b) {
+        return a.atMs < b.atMs;
+    });
+}
+
+/*
+ * Plays back the scenario from the start, producing one frame every
+ * INFERENCE_TIME ms, or at the requested frame rate if one is set. Frames
+ * are paced by the clock, so on a SimClock they come out as fast as they
+ * are taken. When started again after a fault, carries on from where the
+ * scenario has got to in the meantime.
+ */
+int SimCam::StartAcquisition(void) {
+    endAcquistionSignal.store(false);
+
+    vector<InferenceBoundingBox> boxes;
+    vector<int> ids;
+
+    if (startUs < 0)
+        startUs = clock->NowUs();
+    else
+        frameTime = std::max(frameTime, GetScenarioMs());
+
+    while (!endAcquistionSignal && frameTime <= mScenario->GetDuration()) {
+        double fps = frameRate;
+        double nextTime = frameTime + ((fps > 0) ? (1000.0 / fps) : INFERENCE_TIME);
+
+        if (nextFault < faults->size() && (*faults)[nextFault].atMs <= nextTime)
+            return Fail((*faults)[nextFault++]);
+        frameTime = nextTime;
+
+        long long wakeupUs = startUs + (long long)(frameTime * 1000);
+        clock->SleepUntilUs(wakeupUs);
+        jitter->Record(clock->NowUs() - wakeupUs);
+
+        mScenario->GetBoxes(frameTime, boxes, &ids);
+        for (auto it = ids.begin(); it != ids.end(); ++it) {
+            if (*it >= 0 && *it < (int)framesSeen->size())
+                (*framesSeen)[*it]++;
+        }
+
+        bufferMutex->lock();
+        boundingBoxBuffer->swap(boxes);
+        bufferMutex->unlock();
+
+        framesDelivered++;
+        PublishFrame();
+    }
+
+    if (frameTime > mScenario->GetDuration())
+        finished.store(true);
+    return 0;
+}
+
+void SimCam::EndAcquisition(void) {
+    endAcquistionSignal.store(true);
+}
+
+void SimCam::GetBoundingBoxData(vector<InferenceBoundingBox>& buf) {
+    bufferMutex->lock();
+    buf = *boundingBoxBuffer;
+    bufferMutex->unlock();
+}
+
+int SimCam::SetFrameRate(double fps) {
+    frameRate.store(fps);
+    return 0;
+}
+
+WakeupJitter* SimCam::GetWakeupJitter(void) {
+    return jitter;
+}
+
+bool SimCam::IsFinished(void) {
+    return finished;
+}
+
+long long SimCam::GetFramesDelivered(void) {
+    return framesDelivered;
+}
+
+/*
+ * Number of delivered frames the given person was visible in. Only
+ * valid once acquisition has finished.
+ */
+int SimCam::GetFramesSeen(int personIdx) {
+    return (*framesSeen)[mScenario->GetPerson(personIdx).id];
+}
+
+SimCam::~SimCam() {
+    delete bufferMutex;
+    delete boundingBoxBuffer;
+    delete framesSeen;
+    delete jitter;
+    delete faults;
+}
+
+/************************** Private Functions **************************/
+
+/*
+ * Time into the scenario according to the clock.
+ */
+double SimCam::GetScenarioMs(void) {
+    return (clock->NowUs() - startUs) / 1000.0;
+}
+
+/*
+ * Waits for the fault to happen, then fails the way it says: straight
+ * away, or by delivering nothing until the frame timeout runs out or
+ * acquisition is ended.
+ */
+int SimCam::Fail(const SimFault& fault) {
+    clock->SleepUntilUs(startUs + (long long)(fault.atMs * 1000));
+    downUntilMs = fault.atMs + fault.downMs;
+
+    if (fault.type == SIM_FAULT_DROP)
+        return -1;
+
+    long long lastUs = (GetLastFrameUs() >= 0) ? GetLastFrameUs() : clock->NowUs();
+    while (!endAcquistionSignal) {
+        if (frameTimeoutMs > 0 && clock->NowUs() - lastUs >= frameTimeoutMs * 1000)
+            return -1;
+        clock->SleepForUs(SIM_STALL_POLL_MS * 1000LL);
+    }
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ *  Appearance.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Appearance.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SIG_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIG_NEON
+#endif
+
+#define SIG_SAMPLES (SIG_SAMPLES_X * SIG_SAMPLES_Y)
+
+// Smallest box, in pixels, worth taking a signature of
+#define SIG_MIN_WIDTH  8
+#define SIG_MIN_HEIGHT 16
+
+using namespace Spinnaker;
+
+/*
+ * Position of the red pixel in each 2x2 block of a Bayer image, the blue
+ * one is diagonally opposite and the other two are green.
+ */
+static int BayerRedOffset(PixelFormatEnums format, int* rx, int* ry) {
+    switch (format) {
+        case PixelFormat_BayerRG8: *rx = 0; *ry = 0; return 0;
+        case PixelFormat_BayerGR8: *rx = 1; *ry = 0; return 0;
+        case PixelFormat_BayerGB8: *rx = 0; *ry = 1; return 0;
+        case PixelFormat_BayerBG8: *rx = 1; *ry = 1; return 0;
+        default: return -1;
+    }
+}
+
+/*
+ * Reads the colour of every sample point into separate R, G and B arrays.
+ * Bayer images are sampled one 2x2 block at a time so no demosaicing is
+ * needed.
+ */
+static int GatherSamples(const ImageView& img, const int* xs, const int* ys,
+                         uint8_t* r, uint8_t* g, uint8_t* b) {
+    int rx, ry;
+    bool bayer = (BayerRedOffset(img.format, &rx, &ry) == 0);
+
+    if (!bayer && img.format != PixelFormat_Mono8 && img.format != PixelFormat_RGB8 &&
+        img.format != PixelFormat_BGR8)
+        return -1;
+
+    int n = 0;
+    for (int j = 0; j < SIG_SAMPLES_Y; j++) {
+        int y = ys[j];
+        if (bayer)
+            y = std::min(y & ~1, img.height - 2);
+
+        const uint8_t* row = img.data + (size_t)y * img.stride;
+        const uint8_t* next = row + img.stride;
+
+        for (int i = 0; i < SIG_SAMPLES_X; i++, n++) {
+            int x = xs[i];
+
+            if (bayer) {
+                x = std::min(x & ~1, img.width - 2);
+                const uint8_t* rows[2] = { row, next };
+                r[n] = rows[ry][x + rx];
+                b[n] = rows[1 - ry][x + 1 - rx];
+                g[n] = (uint8_t)((rows[ry][x + 1 - rx] + rows[1 - ry][x + rx] + 1) >> 1);
+            }
+            else if (img.format == PixelFormat_Mono8) {
+                r[n] = g[n] = b[n] = row[x];
+            }
+            else if (img.format == PixelFormat_RGB8) {
+                r[n] = row[3 * x];
+                g[n] = row[3 * x + 1];
+                b[n] = row[3 * x + 2];
+            }
+            else {
+                b[n] = row[3 * x];
+                g[n] = row[3 * x + 1];
+                r[n] = row[3 * x + 2];
+            }
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Turns every sample into its bin index, RRGGBB from the top 2 bits of
+ * each channel.
+ */
+static void QuantizeSamples(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t* idx) {
+#if defined(SIG_SSE2)
+    // There is no byte shift, but the bits shifted in from the next byte
+    // are masked off and the shifts back up never leave the byte
+    const __m128i mask = _mm_set1_epi8(0x03);
+    for (int i = 0; i < SIG_SAMPLES; i += 16) {
+        __m128i vr = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(r + i)), 6), mask);
+        __m128i vg = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(g + i)), 6), mask);
+        __m128i vb = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(b + i)), 6), mask);
+        __m128i v = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(vr, 4), _mm_slli_epi16(vg, 2)), vb);
+        _mm_storeu_si128((__m128i*)(idx + i), v);
+    }
+#elif defined(SIG_NEON)
+    for (int i = 0; i < SIG_SAMPLES; i += 16) {
+        uint8x16_t vr = vshrq_n_u8(vld1q_u8(r + i), 6);
+        uint8x16_t vg = vshrq_n_u8(vld1q_u8(g + i), 6);
+        uint8x16_t vb = vshrq_n_u8(vld1q_u8(b + i), 6);
+        vst1q_u8(idx + i, vorrq_u8(vorrq_u8(vshlq_n_u8(vr, 4), vshlq_n_u8(vg, 2)), vb));
+    }
+#else
+    for (int i = 0; i < SIG_SAMPLES; i++)
+        idx[i] = (uint8_t)(((r[i] >> 6) << 4) | ((g[i] >> 6) << 2) | (b[i] >> 6));
+#endif
+}
+
+/*
+ * Takes the signature of the person in the given box. Only the middle
+ * of the box is used since its edges are mostly background. Returns -1,
+ * and marks the signature as invalid, if the box is too small or the
+ * pixel format isn't supported.
+ */
+int ComputeSignature(const ImageView& img, const InferenceBoundingBox& box, Signature& sig) {
+    sig.valid = false;
+
+    if (img.data == NULL)
+        return -1;
+
+    int x1 = std::max((int)box.rect.topLeftXCoord, 0);
+    int x2 = std::min((int)box.rect.bottomRightXCoord, img.width - 1);
+    int y1 = std::max((int)box.rect.topLeftYCoord, 0);
+    int y2 = std::min((int)box.rect.bottomRightYCoord, img.height - 1);
+
+    // Middle 60% across and 80% down
+    int w = x2 - x1;
+    int h = y2 - y1;
+    x1 += w / 5;
+    w -= 2 * (w / 5);
+    y1 += h / 10;
+    h -= 2 * (h / 10);
+    if (w < SIG_MIN_WIDTH || h < SIG_MIN_HEIGHT)
+        return -1;
+
+    int xs[SIG_SAMPLES_X];
+    int ys[SIG_SAMPLES_Y];
+    for (int i = 0; i < SIG_SAMPLES_X; i++)
+        xs[i] = x1 + (2 * i + 1) * w / (2 * SIG_SAMPLES_X);
+    for (int j = 0; j < SIG_SAMPLES_Y; j++)
+        ys[j] = y1 + (2 * j + 1) * h / (2 * SIG_SAMPLES_Y);
+
+    uint8_t r[SIG_SAMPLES];
+    uint8_t g[SIG_SAMPLES];
+    uint8_t b[SIG_SAMPLES];
+    if (GatherSamples(img, xs, ys, r, g, b))
+        return -1;
+
+    uint8_t idx[SIG_SAMPLES];
+    QuantizeSamples(r, g, b, idx);
+
+    uint16_t counts[SIG_BINS];
+    memset(counts, 0, sizeof(counts));
+    for (int i = 0; i < SIG_SAMPLES; i++)
+        counts[idx[i]]++;
+
+    // Scale so the bins add up to at most 255
+    for (int i = 0; i < SIG_BINS; i++)
+        sig.bins[i] = (uint8_t)((counts[i] * 255) / SIG_SAMPLES);
+
+    sig.valid = true;
+    return 0;
+}
+
+/*
+ * Sum of absolute differences between the bins, from 0 for identical
+ * signatures to SIG_MAX_DIST.
+ */
+int SignatureDistance(const Signature& a, const Signature& b) {
+#if defined(SIG_SSE2)
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < SIG_BINS; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a.bins + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b.bins + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(va, vb));
+    }
+    return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+#elif defined(SIG_NEON)
+    uint16x8_t sum = vdupq_n_u16(0);
+    for (int i = 0; i < SIG_BINS; i += 16)
+        sum = vpadalq_u8(sum, vabdq_u8(vld1q_u8(a.bins + i), vld1q_u8(b.bins + i)));
+    uint16_t lanes[8];
+    vst1q_u16(lanes, sum);
+    int dist = 0;
+    for (int i = 0; i < 8; i++)
+        dist += lanes[i];
+    return dist;
+#else
+    int dist = 0;
+    for (int i = 0; i < SIG_BINS; i++)
+        dist += abs((int)a.bins[i] - (int)b.bins[i]);
+    return dist;
+#endif
+}
+
+/*
+ * Moves the signature of a track a quarter of the way towards the latest
+ * one, so it follows slow changes in lighting without being thrown off
+ * by a single bad crop.
+ */
+void BlendSignature(Signature& sig, const Signature& latest) {
+    if (!latest.valid)
+        return;
+
+    if (!sig.valid) {
+        sig = latest;
+        return;
+    }
+
+#if defined(SIG_SSE2)
+    for (int i = 0; i < SIG_BINS; i += 16) {
+        __m128i vs = _mm_loadu_si128((const __m128i*)(sig.bins + i));
+        __m128i vl = _mm_loadu_si128((const __m128i*)(latest.bins + i));
+        _mm_storeu_si128((__m128i*)(sig.bins + i), _mm_avg_epu8(vs, _mm_avg_epu8(vs, vl)));
+    }
+#elif defined(SIG_NEON)
+    for (int i = 0; i < SIG_BINS; i += 16) {
+        uint8x16_t vs = vld1q_u8(sig.bins + i);
+        uint8x16_t vl = vld1q_u8(latest.bins + i);
+        vst1q_u8(sig.bins + i, vrhaddq_u8(vs, vrhaddq_u8(vs, vl)));
+    }
+#else
+    for (int i = 0; i < SIG_BINS; i++) {
+        int half = (sig.bins[i] + latest.bins[i] + 1) >> 1;
+        sig.bins[i] = (uint8_t)((sig.bins[i] + half + 1) >> 1);
+    }
+#endif
+}
@@ -9,33 +9,29 @@
 #include <iostream>
 #include <thread>
 
-#define DIST_TOLERANCE 300
-
 using namespace Spinnaker;
 
 using std::cout;
-using std::vector;
 using std::thread;
 
 Centroid::Centroid(InferenceBoundingBox box) {
     count = 0;
-    centerPrev = new vector<int>(2);
 
-    (*centerPrev)[0] = (box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2;
-    (*centerPrev)[1] = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2;
+    centerPrev[0] = (box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2;
+    centerPrev[1] = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2;
 
-    if ((*centerPrev)[0] < (CAM_X / 2))
+    if (centerPrev[0] < (CAM_X / 2))
         dir = RIGHT;
     else
         dir = LEFT;
 }
 
-bool Centroid::isBoxMatch(Spinnaker::InferenceBoundingBox box) {
+bool Centroid::isBoxMatch(Spinnaker::InferenceBoundingBox box, const TrackerConfig& cfg) {
     // Get the distance from the previous center
     int centerXCurr = (box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2;
     int centerYCurr = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2;
 
-    if (abs(centerXCurr - (*centerPrev)[0]) > DIST_TOLERANCE)
+    if (abs(centerXCurr - centerPrev[0]) > cfg.distTolerance)
         return false;
     else
         return true;
@@ -50,18 +46,21 @@ void Centroid::updateTracker(InferenceBoundingBox box) {
     int centerYCurr = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2;
 
     // Update the centroid
-    (*centerPrev)[0] = centerXCurr;
-    (*centerPrev)[1] = centerYCurr;
+    centerPrev[0] = centerXCurr;
+    centerPrev[1] = centerYCurr;
 }
 
-int Centroid::updateTracker(void) {
-    return (Tracker::updateTracker());
+int Centroid::updateTracker(const TrackerConfig& cfg) {
+    return (Tracker::updateTracker(cfg));
 }
 
 bool Centroid::getDir(void) {
+    int fitDir = fit.GetDir();
+    if (fitDir >= 0)
+        return fitDir;
+
     return dir;
 }
 
 Centroid::~Centroid() {
-    delete centerPrev;
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ *  FixedStateCentroid.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "FixedStateCentroid.h"
+#include <cmath>
+#include <cstring>
+
+using namespace Spinnaker;
+
+/*
+ * Square of a distance, in 64 bits so that Q16.16 values can't overflow.
+ */
+static int64_t Square(int64_t v) {
+    return v * v;
+}
+
+FixedStateCentroid::FixedStateCentroid(InferenceBoundingBox box) {
+    int32_t init[4];
+
+    count = 0;
+    memset(state, 0, sizeof(state));
+    MakeStateVector(box, init);
+    memcpy(state, init, sizeof(state));
+}
+
+/*
+ * Determines if the provided box matches the current state, with the
+ * same rule as StateCentroid::isBoxMatch. Distances are compared to the
+ * thresholds squared, and the difference of the box diagonals, which
+ * are only known squared, is tested with
+ *
+ *      |sqrt(a) - sqrt(b)| > t  <=>  a + b - t^2 > 0 and (a + b - t^2)^2 > 4ab
+ *
+ * which only holds on integers for a whole pixel t. A fractional box size
+ * threshold is compared on the diagonals themselves, as StateCentroid
+ * does.
+ */
+bool FixedStateCentroid::isBoxMatch(InferenceBoundingBox box, const TrackerConfig& cfg) {
+    int32_t obs[4];
+    MakeStateVector(box, obs);
+
+    // Positions are whole pixels, so a distance is within a threshold
+    // exactly when it is within the threshold rounded down. Velocities are
+    // compared at the precision they are kept in.
+    int64_t distX = (int64_t)floor(cfg.distXThresh);
+    int64_t distY = (int64_t)floor(cfg.distYThresh);
+    int64_t velX = llround(cfg.velXThresh * FIXED_ONE);
+    int64_t boxSize = (int64_t)cfg.boxSizeThresh;
+
+    if (Square((obs[0] - state[0]) >> FIXED_SHIFT) <= Square(distX))
+        return true;
+    if (Square((obs[1] - state[1]) >> FIXED_SHIFT) <= Square(distY))
+        return true;
+    if (Square((int64_t)obs[2] - state[2]) <= Square(velX))
+        return true;
+
+    int64_t a = obs[3];
+    int64_t b = state[3];
+    if (boxSize != cfg.boxSizeThresh)
+        return fabs(sqrt((double)a) - sqrt((double)b)) <= cfg.boxSizeThresh;
+
+    int64_t lhs = a + b - Square(boxSize);
+    if (lhs <= 0 || Square(lhs) <= 4 * a * b)
+        return true;
+
+    return false;
+}
+
+void FixedStateCentroid::updateTracker(InferenceBoundingBox box) {
+    int32_t obs[4];
+
+    // Reset missing counter
+    count = 0;
+
+    // Update the state vector
+    MakeStateVector(box, obs);
+    memcpy(state, obs, sizeof(state));
+}
+
+int FixedStateCentroid::updateTracker(const TrackerConfig& cfg) {
+    return (Tracker::updateTracker(cfg));
+}
+
+bool FixedStateCentroid::getDir(void) {
+    int fitDir = fit.GetDir();
+    if (fitDir >= 0)
+        return fitDir;
+
+    return (state[2] > 0);
+}
+
+FixedStateCentroid::~FixedStateCentroid() {
+}
+
+/*
+ * Takes in a bounding box and fills out with the state vector that
+ * represents the state of the system at this point, as
+ * StateCentroid::MakeStateVector does.
+ */
+void FixedStateCentroid::MakeStateVector(InferenceBoundingBox box, int32_t* out) {
+    int centerX = (box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2;
+    int centerY = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2;
+    out[0] = centerX * FIXED_ONE;
+    out[1] = centerY * FIXED_ONE;
+
+    // If a previous x-position exists, use it to calculate the
+    // current velocity.
+    if (state[0] > 0) {
+        int dx = centerX - (state[0] >> FIXED_SHIFT);
+        if (dx != 0)
+            out[2] = dx * FIXED_ONE / INFERENCE_TIME;
+        else
+            out[2] = state[2];
+    }
+    else {
+        // X velocity should be negative if person is moving from left to right
+        if (centerX > CAM_X / 2)
+            out[2] = (centerX - CAM_X) * FIXED_ONE / INFERENCE_TIME;
+        else
+            out[2] = centerX * FIXED_ONE / INFERENCE_TIME;
+    }
+
+    // Square of the length of the box diagonal
+    int width = box.rect.bottomRightXCoord - box.rect.topLeftXCoord;
+    int height = box.rect.bottomRightYCoord - box.rect.topLeftYCoord;
+    out[3] = width * width + height * height;
+}
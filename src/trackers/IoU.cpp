@@ -0,0 +1,355 @@
+/*
+ *  IoU.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "IoU.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define IOU_SSE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define IOU_NEON
+#endif
+
+using namespace Spinnaker;
+
+using std::vector;
+
+struct IoUPair {
+    float iou;
+    int box;
+    int track;
+};
+
+/*
+ * Buffers used by matchFrame, kept from one frame to the next so that
+ * matching doesn't allocate once they have grown to the crowd size. Each
+ * thread has its own so several PeopleCounters can run at once.
+ */
+struct IoUScratch {
+    vector<int16_t> boxes;
+    vector<int> boxIndex;
+    vector<int16_t> tracks;
+    vector<int32_t> areas;
+    vector<float> iou;
+    vector<IoUPair> pairs;
+    vector<char> trackUsed;
+};
+
+static thread_local IoUScratch scratch;
+
+static int16_t ClampX(double v) {
+    return (int16_t)std::max(std::min(v, CAM_X - 1.0), 0.0);
+}
+
+static int16_t ClampY(double v) {
+    return (int16_t)std::max(std::min(v, CAM_Y - 1.0), 0.0);
+}
+
+static int32_t BoxArea(const int16_t* b) {
+    return std::max(b[2] - b[0], 0) * std::max(b[3] - b[1], 0);
+}
+
+static float BoxIoU(const int16_t* a, const int16_t* b) {
+    int iw = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+    int ih = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+    if (iw <= 0 || ih <= 0)
+        return 0.0f;
+
+    int32_t inter = iw * ih;
+    return (float)inter / std::max(BoxArea(a) + BoxArea(b) - inter, 1);
+}
+
+static void GetCorners(const InferenceBoundingBox& box, int16_t* out) {
+    out[0] = box.rect.topLeftXCoord;
+    out[1] = box.rect.topLeftYCoord;
+    out[2] = box.rect.bottomRightXCoord;
+    out[3] = box.rect.bottomRightYCoord;
+}
+
+IoU::IoU(InferenceBoundingBox b) : velY(0) {
+    count = 0;
+    GetCorners(b, box);
+    startX = (box[0] + box[2]) / 2;
+
+    // People walk across the frame faster than a box width every few
+    // frames, so the first match needs a guess at the velocity. Only
+    // someone coming in at the edge can be guessed at; anyone already
+    // in view, after an outage say, could be going either way
+    int width = box[2] - box[0];
+    velX = 0;
+    if (box[0] <= width)
+        velX = IOU_INIT_SPEED * INFERENCE_TIME;
+    else if (box[2] >= CAM_X - 1 - width)
+        velX = -IOU_INIT_SPEED * INFERENCE_TIME;
+}
+
+/*
+ * Scalar version of the test done by matchFrame, for a single pair.
+ */
+bool IoU::isBoxMatch(InferenceBoundingBox b, const TrackerConfig& cfg) {
+    int16_t pred[4];
+    int16_t obs[4];
+    getPredictedBox(pred);
+    GetCorners(b, obs);
+
+    return BoxIoU(pred, obs) >= cfg.iouThresh;
+}
+
+void IoU::updateTracker(InferenceBoundingBox b) {
+    int16_t obs[4];
+    GetCorners(b, obs);
+
+    // Frames since the last match, the current one included
+    int frames = count + 1;
+
+    // The side of a box that is cut off by the edge of the frame doesn't
+    // move with the person, so only the sides that are clear of it count
+    double dx = 0;
+    int sides = 0;
+    if (box[0] > 0 && obs[0] > 0) {
+        dx += obs[0] - box[0];
+        sides++;
+    }
+    if (box[2] < CAM_X - 1 && obs[2] < CAM_X - 1) {
+        dx += obs[2] - box[2];
+        sides++;
+    }
+    if (sides > 0)
+        velX += IOU_VEL_SMOOTHING * (dx / sides / frames - velX);
+
+    double dy = ((obs[1] + obs[3]) - (box[1] + box[3])) / 2.0 / frames;
+    velY += IOU_VEL_SMOOTHING * (dy - velY);
+
+    // Reset missing counter
+    count = 0;
+    memcpy(box, obs, sizeof(box));
+}
+
+int IoU::updateTracker(const TrackerConfig& cfg) {
+    return (Tracker::updateTracker(cfg));
+}
+
+/*
+ * Direction the box has moved since it was first seen. A box that hasn't
+ * moved is assumed to be heading for the far side of the frame.
+ */
+bool IoU::getDir(void) {
+    int fitDir = fit.GetDir();
+    if (fitDir >= 0)
+        return fitDir;
+
+    int centerX = (box[0] + box[2]) / 2;
+
+    if (centerX != startX)
+        return (centerX > startX) ? RIGHT : LEFT;
+    else
+        return (startX < CAM_X / 2) ? RIGHT : LEFT;
+}
+
+/*
+ * Where the last box matched is expected to be in the current frame. A
+ * side cut off by the edge of the frame stays there, since the rest of
+ * the person may still be out of view.
+ */
+void IoU::getPredictedBox(int16_t* out) {
+    int frames = count + 1;
+    double dx = velX * frames;
+    double dy = velY * frames;
+
+    out[0] = (box[0] <= 0) ? box[0] : ClampX(box[0] + dx);
+    out[1] = ClampY(box[1] + dy);
+    out[2] = (box[2] >= CAM_X - 1) ? box[2] : ClampX(box[2] + dx);
+    out[3] = ClampY(box[3] + dy);
+}
+
+/*
+ * Matches the people in the frame to the trackers, filling matches with
+ * the index of the tracker for each box, or -1 if no tracker overlaps it
+ * by at least the IoU threshold. The pairs with the most overlap are
+ * taken first and each tracker is matched at most once.
+ */
+bool IoU::matchFrame(const vector<InferenceBoundingBox>& boxes, const vector<IoU*>& trackers,
+                     const TrackerConfig& cfg, vector<int>& matches) {
+    matches.assign(boxes.size(), -1);
+
+    scratch.boxes.clear();
+    scratch.boxIndex.clear();
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (boxes[i].classId == PERSON_ID && boxes[i].confidence > cfg.confidenceThresh) {
+            int16_t b[4];
+            GetCorners(boxes[i], b);
+            scratch.boxes.insert(scratch.boxes.end(), b, b + 4);
+            scratch.boxIndex.push_back((int)i);
+        }
+    }
+
+    int numBoxes = (int)scratch.boxIndex.size();
+    int numTracks = (int)trackers.size();
+    if (numBoxes == 0 || numTracks == 0)
+        return true;
+
+    // Predicted boxes as four rows, padded with empty boxes
+    int stride = IOU_PAD(numTracks);
+    scratch.tracks.assign(4 * stride, 0);
+    scratch.areas.assign(stride, 0);
+    for (int t = 0; t < numTracks; t++) {
+        int16_t pred[4];
+        trackers[t]->getPredictedBox(pred);
+        for (int k = 0; k < 4; k++)
+            scratch.tracks[k * stride + t] = pred[k];
+        scratch.areas[t] = BoxArea(pred);
+    }
+
+    scratch.iou.resize((size_t)numBoxes * stride);
+    IoUMatrix(&scratch.boxes[0], numBoxes, &scratch.tracks[0], &scratch.areas[0], stride, &scratch.iou[0]);
+
+    scratch.pairs.clear();
+    float thresh = (float)cfg.iouThresh;
+    for (int b = 0; b < numBoxes; b++) {
+        const float* row = &scratch.iou[(size_t)b * stride];
+        for (int t = 0; t < numTracks; t++) {
+            if (row[t] > 0 && row[t] >= thresh)
+                scratch.pairs.push_back({ row[t], b, t });
+        }
+    }
+
+    std::sort(scratch.pairs.begin(), scratch.pairs.end(), [](const IoUPair& a, const IoUPair& b) {
+        if (a.iou != b.iou)
+            return a.iou > b.iou;
+        if (a.box != b.box)
+            return a.box < b.box;
+        return a.track < b.track;
+    });
+
+    scratch.trackUsed.assign(numTracks, 0);
+    for (auto it = scratch.pairs.begin(); it != scratch.pairs.end(); ++it) {
+        int& match = matches[scratch.boxIndex[it->box]];
+        if (match < 0 && !scratch.trackUsed[it->track]) {
+            match = it->track;
+            scratch.trackUsed[it->track] = 1;
+        }
+    }
+
+    return true;
+}
+
+IoU::~IoU() {
+}
+
+/*
+ * The overlap of one box with IOU_LANES track boxes is found with 16 bit
+ * min/max, and groups of tracks none of which overlap the box are
+ * skipped before the widening multiplies and the divide. In a frame most
+ * people are far apart, so most groups are skipped.
+ */
+void IoUMatrix(const int16_t* boxes, int numBoxes, const int16_t* tracks, const int32_t* trackAreas,
+               int trackStride, float* iou) {
+    const int16_t* tx1 = tracks;
+    const int16_t* ty1 = tracks + trackStride;
+    const int16_t* tx2 = tracks + 2 * trackStride;
+    const int16_t* ty2 = tracks + 3 * trackStride;
+
+    for (int b = 0; b < numBoxes; b++) {
+        const int16_t* box = boxes + 4 * b;
+        int32_t boxArea = BoxArea(box);
+        float* row = iou + (size_t)b * trackStride;
+
+#if defined(IOU_SSE)
+        __m128i bx1 = _mm_set1_epi16(box[0]);
+        __m128i by1 = _mm_set1_epi16(box[1]);
+        __m128i bx2 = _mm_set1_epi16(box[2]);
+        __m128i by2 = _mm_set1_epi16(box[3]);
+        __m128i barea = _mm_set1_epi32(boxArea);
+        __m128i one = _mm_set1_epi32(1);
+        __m128i zero = _mm_setzero_si128();
+
+        for (int t = 0; t < trackStride; t += IOU_LANES) {
+            __m128i iw = _mm_sub_epi16(_mm_min_epi16(bx2, _mm_loadu_si128((const __m128i*)(tx2 + t))),
+                                       _mm_max_epi16(bx1, _mm_loadu_si128((const __m128i*)(tx1 + t))));
+            __m128i ih = _mm_sub_epi16(_mm_min_epi16(by2, _mm_loadu_si128((const __m128i*)(ty2 + t))),
+                                       _mm_max_epi16(by1, _mm_loadu_si128((const __m128i*)(ty1 + t))));
+
+            __m128i overlap = _mm_and_si128(_mm_cmpgt_epi16(iw, zero), _mm_cmpgt_epi16(ih, zero));
+            if (_mm_movemask_epi8(overlap) == 0) {
+                _mm_storeu_ps(row + t, _mm_setzero_ps());
+                _mm_storeu_ps(row + t + 4, _mm_setzero_ps());
+                continue;
+            }
+
+            iw = _mm_and_si128(iw, overlap);
+            ih = _mm_and_si128(ih, overlap);
+            __m128i lo = _mm_mullo_epi16(iw, ih);
+            __m128i hi = _mm_mulhi_epi16(iw, ih);
+
+            for (int half = 0; half < 2; half++) {
+                __m128i inter = half ? _mm_unpackhi_epi16(lo, hi) : _mm_unpacklo_epi16(lo, hi);
+                __m128i tarea = _mm_loadu_si128((const __m128i*)(trackAreas + t + 4 * half));
+                __m128i uni = _mm_sub_epi32(_mm_add_epi32(barea, tarea), inter);
+
+                // max with 1 for the empty padding boxes, SSE2 has no max_epi32
+                __m128i small = _mm_cmplt_epi32(uni, one);
+                uni = _mm_or_si128(_mm_andnot_si128(small, uni), _mm_and_si128(small, one));
+
+                _mm_storeu_ps(row + t + 4 * half, _mm_div_ps(_mm_cvtepi32_ps(inter), _mm_cvtepi32_ps(uni)));
+            }
+        }
+#elif defined(IOU_NEON)
+        int16x8_t bx1 = vdupq_n_s16(box[0]);
+        int16x8_t by1 = vdupq_n_s16(box[1]);
+        int16x8_t bx2 = vdupq_n_s16(box[2]);
+        int16x8_t by2 = vdupq_n_s16(box[3]);
+        int32x4_t barea = vdupq_n_s32(boxArea);
+        int32x4_t one = vdupq_n_s32(1);
+        int16x8_t zero = vdupq_n_s16(0);
+
+        for (int t = 0; t < trackStride; t += IOU_LANES) {
+            int16x8_t iw = vsubq_s16(vminq_s16(bx2, vld1q_s16(tx2 + t)), vmaxq_s16(bx1, vld1q_s16(tx1 + t)));
+            int16x8_t ih = vsubq_s16(vminq_s16(by2, vld1q_s16(ty2 + t)), vmaxq_s16(by1, vld1q_s16(ty1 + t)));
+
+            uint16x8_t overlap = vandq_u16(vcgtq_s16(iw, zero), vcgtq_s16(ih, zero));
+            uint64x2_t any = vreinterpretq_u64_u16(overlap);
+            if ((vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) == 0) {
+                vst1q_f32(row + t, vdupq_n_f32(0));
+                vst1q_f32(row + t + 4, vdupq_n_f32(0));
+                continue;
+            }
+
+            iw = vandq_s16(iw, vreinterpretq_s16_u16(overlap));
+            ih = vandq_s16(ih, vreinterpretq_s16_u16(overlap));
+
+            for (int half = 0; half < 2; half++) {
+                int32x4_t inter = half ? vmull_s16(vget_high_s16(iw), vget_high_s16(ih))
+                                       : vmull_s16(vget_low_s16(iw), vget_low_s16(ih));
+                int32x4_t uni = vsubq_s32(vaddq_s32(barea, vld1q_s32(trackAreas + t + 4 * half)), inter);
+                float32x4_t u = vcvtq_f32_s32(vmaxq_s32(uni, one));
+
+                // Reciprocal estimate refined twice, close enough to a divide
+                float32x4_t r = vrecpeq_f32(u);
+                r = vmulq_f32(vrecpsq_f32(u, r), r);
+                r = vmulq_f32(vrecpsq_f32(u, r), r);
+
+                vst1q_f32(row + t + 4 * half, vmulq_f32(vcvtq_f32_s32(inter), r));
+            }
+        }
+#else
+        for (int t = 0; t < trackStride; t++) {
+            int iw = std::min(box[2], tx2[t]) - std::max(box[0], tx1[t]);
+            int ih = std::min(box[3], ty2[t]) - std::max(box[1], ty1[t]);
+            if (iw <= 0 || ih <= 0) {
+                row[t] = 0.0f;
+                continue;
+            }
+
+            int32_t inter = iw * ih;
+            row[t] = (float)inter / std::max(boxArea + trackAreas[t] - inter, 1);
+        }
+#endif
+    }
+}
@@ -7,20 +7,21 @@
 
 #include "Kalman.h"
 #include <iostream>
+#include <cmath>
+#include <cstring>
 #include <thread>
 
 using namespace Spinnaker;
 
 using std::cout;
-using std::vector;
 using std::thread;
 
-#define DIST_THRESH 200
-
 Kalman::Kalman(InferenceBoundingBox box) {
     // Initialize starting vector
-    x = new vector<double>(4);
-    *x = this->MakeStateVector(box);
+    double init[4];
+    memset(x, 0, sizeof(x));
+    this->MakeStateVector(box, init);
+    memcpy(x, init, sizeof(x));
 
     // Initialize covariance matrix
     double covTemp[][4] = {{1, 0, 2, 0},
@@ -36,20 +37,21 @@ Kalman::Kalman(InferenceBoundingBox box) {
  * Determines if the provided box matches the current filter
  * by comparing it to the predicted state.
  */
-bool Kalman::isBoxMatch(InferenceBoundingBox box) {
+bool Kalman::isBoxMatch(InferenceBoundingBox box, const TrackerConfig& cfg) {
     // Predict the state vector
-    this->Predict();
+    this->Predict(NULL);
     
     // Compare the predicted vector with the observed vector
-    vector<double> obs = this->MakeStateVector(box);
+    double obs[4];
+    this->MakeStateVector(box, obs);
 
     double squaredSum = 0;
     for (int i = 0; i < 4; i++) {
-        squaredSum += (pow(obs[i] - (*x)[i], 2));
+        squaredSum += (pow(obs[i] - x[i], 2));
     }
     double dist = sqrt(squaredSum);
 
-    return (dist < DIST_THRESH);
+    return (dist < cfg.distThresh);
 }
 
 /*
@@ -61,7 +63,8 @@ void Kalman::updateTracker(InferenceBoundingBox box) {
     // Reset missing counter
     count = 0;
 
-    vector<double> sv = this->MakeStateVector(box);
+    double sv[4];
+    this->MakeStateVector(box, sv);
     double obsCov[][4] = { {1, 0, 0, 0},
                         {0, 1, 0, 0},
                         {0, 0, 10, 0},
@@ -70,16 +73,19 @@ void Kalman::updateTracker(InferenceBoundingBox box) {
     this->Update(sv, obsCov);
 }
 
-int Kalman::updateTracker(void) {
-    return (Tracker::updateTracker());
+int Kalman::updateTracker(const TrackerConfig& cfg) {
+    return (Tracker::updateTracker(cfg));
 }
 
 bool Kalman::getDir(void) {
-    return ((*x)[2] > 0);
+    int fitDir = fit.GetDir();
+    if (fitDir >= 0)
+        return fitDir;
+
+    return (x[2] > 0);
 }
 
 Kalman::~Kalman() {
-    delete x;
 }
 
 /************************ Private Functions ****************************/
@@ -91,29 +97,30 @@ Kalman::~Kalman() {
  * x(k) = F * x(k-1)
  * P(k) = F * P(k-1) * F_T
  *
- * Returns the predicted state vector.
+ * Fills out with the predicted state vector.
  */
-vector<double> Kalman::Predict(void) {
-    vector<double> state;
+void Kalman::Predict(double* out) {
+    double state[4];
     
     // Find predicted state vector
     for (int i = 0; i < 4; i++) {
         double val = 0;
 
         for (int j = 0; j < 4; j++) {
-            val += (*x)[j] * pred[i][j]; // x(k) = F * x(k-1)
+            val += x[j] * pred[i][j]; // x(k) = F * x(k-1)
             
         }
-        state.push_back(val);
+        state[i] = val;
     }
-    *x = state;
+    memcpy(x, state, sizeof(x));
 
     // Find predicted covariance matrix
     double tempMat[4][4] = { 0 };
     matMultiply(cov, pred, tempMat);      // F * P(k-1)
     matMultiply(tempMat, predTrans, cov); // P(k) = F * P(k-1) * F_T
 
-    return state;
+    if (out != NULL)
+        memcpy(out, state, sizeof(state));
 }
 
 /* 
@@ -124,7 +131,10 @@ vector<double> Kalman::Predict(void) {
  *
  * Where K = P(k) * F_T * (F * P(k) * F_T + R(k))^-1
  */
-void Kalman::Update(std::vector<double> obsState /* z(k) */, double obsCov[][4] /* R(k) */) {
+void Kalman::Update(const double* obs /* z(k) */, double obsCov[][4] /* R(k) */) {
+    double obsState[4];
+    memcpy(obsState, obs, sizeof(obsState));
+
     // Calculate the kalman game
     double gain[4][4] = { 0 };
 
@@ -151,7 +161,7 @@ void Kalman::Update(std::vector<double> obsState /* z(k) */, double obsCov[][4]
     for (int i = 0; i < 4; i++) {
         double subVal = 0;
         for (int j = 0; j < 4; j++) {
-            subVal += pred[i][j] * (*x)[j];
+            subVal += pred[i][j] * x[j];
         }
 
         obsState[i] -= subVal;
@@ -163,7 +173,7 @@ void Kalman::Update(std::vector<double> obsState /* z(k) */, double obsCov[][4]
             addVal += gain[i][j] * obsState[i];
         }
 
-        (*x)[i] += addVal;
+        x[i] += addVal;
     }
 
     // Calculate the updated covariance matrix
@@ -177,32 +187,29 @@ void Kalman::Update(std::vector<double> obsState /* z(k) */, double obsCov[][4]
 }
 
 /* 
- * Takes in a bounding box and creates a state vector that 
+ * Takes in a bounding box and fills out with the state vector that 
  * represents the state of the system at this point.
  */
-vector<double> Kalman::MakeStateVector(InferenceBoundingBox box) {
-    vector<double> ret;
-    ret.push_back((box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2); // X position
-    ret.push_back((box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2); // Y position
+void Kalman::MakeStateVector(InferenceBoundingBox box, double* out) {
+    out[0] = (box.rect.bottomRightXCoord + box.rect.topLeftXCoord) / 2; // X position
+    out[1] = (box.rect.bottomRightYCoord + box.rect.topLeftYCoord) / 2; // Y position
 
     // If a previous x-position exists, use it to calcualte the 
     // current velocity.
-    if ((*x)[2] > 0) {
-        ret.push_back((ret[0] - (*x)[0]) / INFERENCE_TIME);
+    if (x[2] > 0) {
+        out[2] = (out[0] - x[0]) / INFERENCE_TIME;
     }
     else {
         // X velocity should be negative if person is moving from left to right
-        if (ret[0] > CAM_X / 2)
-            ret.push_back((ret[0] - CAM_X) / CAM_MS_PER_FRAME);
+        if (out[0] > CAM_X / 2)
+            out[2] = (out[0] - CAM_X) / CAM_MS_PER_FRAME;
         else
-            ret.push_back(ret[0] / CAM_MS_PER_FRAME);
+            out[2] = out[0] / CAM_MS_PER_FRAME;
     }
 
     // Length of box diagonal
-    ret.push_back(sqrt(pow(box.rect.bottomRightXCoord - box.rect.topLeftXCoord, 2) +
-        pow(box.rect.bottomRightYCoord - box.rect.topLeftYCoord, 2)));
-
-    return ret;
+    out[3] = sqrt(pow(box.rect.bottomRightXCoord - box.rect.topLeftXCoord, 2) +
+        pow(box.rect.bottomRightYCoord - box.rect.topLeftYCoord, 2));
 }
 
 /*
@@ -0,0 +1,223 @@
+/*
+ *  ReIdentifier.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ReIdentifier.h"
+#include <cstdlib>
+
+using namespace Spinnaker;
+
+using std::unordered_map;
+
+ReIdentifier::ReIdentifier() : image(NULL), frame(0), numExpired(0), revived(0), signaturesTaken(0) {
+    signatures = new unordered_map<int, Signature>();
+}
+
+/*
+ * Must be called at the start of every frame with the image the boxes
+ * were found in, or NULL if there is none. Without images expired
+ * trackers are still revived, but only by position.
+ */
+void ReIdentifier::BeginFrame(const ImageView* img) {
+    image = img;
+    frame++;
+}
+
+/*
+ * Refreshes the signature of a tracker from the box it was matched to.
+ * Called while more than one person is in view, every REID_REFRESH
+ * frames for each tracker.
+ */
+void ReIdentifier::UpdateSignature(Tracker* tr, const InferenceBoundingBox& box) {
+    if (image == NULL || (frame + tr->getId()) % REID_REFRESH != 0)
+        return;
+
+    Signature latest;
+    if (ComputeSignature(*image, box, latest))
+        return;
+    signaturesTaken++;
+
+    auto it = signatures->find(tr->getId());
+    if (it == signatures->end()) {
+        (*signatures)[tr->getId()] = latest;
+    }
+    else {
+        BlendSignature(it->second, latest);
+    }
+}
+
+/*
+ * Takes an expired tracker that may only be hidden. Returns false if the
+ * person left through the edge of the frame, or there is no room left,
+ * in which case the tracker should be counted straight away.
+ */
+bool ReIdentifier::Bury(Tracker* tr) {
+    const InferenceBoundingBox& last = tr->getLastBox();
+    if (last.rect.topLeftXCoord < REID_EDGE_MARGIN || last.rect.bottomRightXCoord > CAM_X - REID_EDGE_MARGIN)
+        return false;
+
+    if (numExpired == REID_MAX_EXPIRED)
+        return false;
+
+    ExpiredTracker& e = expired[numExpired++];
+    e.tr = tr;
+    e.frame = frame;
+    e.sig.valid = false;
+
+    auto it = signatures->find(tr->getId());
+    if (it != signatures->end()) {
+        e.sig = it->second;
+        signatures->erase(it);
+    }
+
+    return true;
+}
+
+/*
+ * Looks for an expired tracker the given box could belong to. If one is
+ * found it is handed back to be tracked again, otherwise NULL is
+ * returned and the box is a new person.
+ *
+ * When there are signatures to compare, the closest one below
+ * REID_SIG_THRESH wins. Otherwise a tracker is only revived if it is the
+ * only one that could have got to where the box is.
+ */
+Tracker* ReIdentifier::Revive(const InferenceBoundingBox& box) {
+    if (numExpired == 0)
+        return NULL;
+
+    Signature boxSig;
+    boxSig.valid = false;
+    bool tookSig = false;
+
+    int best = -1;
+    int bestDist = REID_SIG_THRESH + 1;
+    int noSig = -1;
+    int numPlausible = 0;
+
+    for (int i = 0; i < numExpired; i++) {
+        if (!IsPlausible(expired[i], box))
+            continue;
+        numPlausible++;
+
+        if (!expired[i].sig.valid) {
+            noSig = i;
+            continue;
+        }
+
+        if (!tookSig && image != NULL) {
+            tookSig = true;
+            if (ComputeSignature(*image, box, boxSig) == 0)
+                signaturesTaken++;
+        }
+
+        if (boxSig.valid) {
+            int dist = SignatureDistance(expired[i].sig, boxSig);
+            if (dist < bestDist) {
+                best = i;
+                bestDist = dist;
+            }
+        }
+        else {
+            noSig = i;
+        }
+    }
+
+    if (best < 0 && numPlausible == 1 && noSig >= 0)
+        best = noSig;
+
+    if (best < 0)
+        return NULL;
+
+    Tracker* tr = expired[best].tr;
+    Signature sig = expired[best].sig;
+    BlendSignature(sig, boxSig);
+    if (sig.valid)
+        (*signatures)[tr->getId()] = sig;
+
+    RemoveExpired(best);
+    revived++;
+    return tr;
+}
+
+/*
+ * Hands back one expired tracker that has been gone for longer than
+ * REID_WINDOW frames, so it can be counted, or NULL once there are none.
+ */
+Tracker* ReIdentifier::Collect(void) {
+    for (int i = 0; i < numExpired; i++) {
+        if (frame - expired[i].frame > REID_WINDOW) {
+            Tracker* tr = expired[i].tr;
+            RemoveExpired(i);
+            return tr;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Hands back the expired trackers one at a time whatever their age, or
+ * NULL once there are none, for owners that free trackers themselves.
+ */
+Tracker* ReIdentifier::Drain(void) {
+    if (numExpired == 0)
+        return NULL;
+
+    Tracker* tr = expired[numExpired - 1].tr;
+    numExpired--;
+    return tr;
+}
+
+/*
+ * Drops the signature of a tracker that is about to be deleted.
+ */
+void ReIdentifier::Forget(Tracker* tr) {
+    signatures->erase(tr->getId());
+}
+
+/*
+ * Number of trackers that were picked up again after expiring.
+ */
+int ReIdentifier::GetRevived(void) {
+    return revived;
+}
+
+int ReIdentifier::GetSignaturesTaken(void) {
+    return signaturesTaken;
+}
+
+/*
+ * Whether the person could have walked from where the tracker was last
+ * seen to the box in the time since, in the direction they were going.
+ */
+bool ReIdentifier::IsPlausible(const ExpiredTracker& e, const InferenceBoundingBox& box) {
+    const InferenceBoundingBox& last = e.tr->getLastBox();
+
+    int lastX = (last.rect.topLeftXCoord + last.rect.bottomRightXCoord) / 2;
+    int lastY = (last.rect.topLeftYCoord + last.rect.bottomRightYCoord) / 2;
+    int x = (box.rect.topLeftXCoord + box.rect.bottomRightXCoord) / 2;
+    int y = (box.rect.topLeftYCoord + box.rect.bottomRightYCoord) / 2;
+
+    if (abs(x - lastX) > REID_MAX_DIST_X || abs(y - lastY) > REID_MAX_DIST_Y)
+        return false;
+
+    // People counted LEFT walk right to left
+    if (e.tr->getDir() == LEFT)
+        return x <= lastX + REID_EDGE_MARGIN;
+    else
+        return x >= lastX - REID_EDGE_MARGIN;
+}
+
+void ReIdentifier::RemoveExpired(int i) {
+    expired[i] = expired[--numExpired];
+}
+
+ReIdentifier::~ReIdentifier() {
+    for (int i = 0; i < numExpired; i++)
+        delete expired[i].tr;
+    delete signatures;
+}
@@ -0,0 +1,157 @@
+/*
+ *  TentativeTracks.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "TentativeTracks.h"
+#include <cstdlib>
+
+using namespace Spinnaker;
+
+static uint32_t WindowMask(const TrackerConfig& cfg) {
+    int frames = cfg.confirmFrames;
+    if (frames < 1)
+        frames = 1;
+    return (frames >= CONFIRM_FRAMES_MAX) ? 0xFFFFFFFF : ((1u << frames) - 1);
+}
+
+static int CountHits(uint32_t history) {
+    int hits = 0;
+    for (; history != 0; history &= history - 1)
+        hits++;
+    return hits;
+}
+
+TentativeTracks::TentativeTracks() : numActive(0), created(0), promoted(0), rejected(0) {
+    for (int i = 0; i < TENTATIVE_MAX; i++)
+        slots[i].active = false;
+}
+
+/*
+ * Must be called at the start of every frame. Moves the history of each
+ * track on by a frame and drops the tracks that weren't seen at all in
+ * the rest of the window.
+ */
+void TentativeTracks::BeginFrame(const TrackerConfig& cfg) {
+    uint32_t mask = WindowMask(cfg);
+
+    for (int i = 0; i < TENTATIVE_MAX && numActive > 0; i++) {
+        TentativeTrack& t = slots[i];
+        if (!t.active)
+            continue;
+
+        t.history <<= 1;
+        if ((t.history & mask) == 0) {
+            t.active = false;
+            numActive--;
+            rejected++;
+        }
+    }
+}
+
+/*
+ * Finds the nearest tentative track, not yet seen this frame, that the
+ * box could belong to and records the hit. Returns its slot, or -1.
+ */
+int TentativeTracks::Match(const InferenceBoundingBox& box) {
+    int best = -1;
+    int bestDist = 0;
+    int x = (box.rect.topLeftXCoord + box.rect.bottomRightXCoord) / 2;
+    int y = (box.rect.topLeftYCoord + box.rect.bottomRightYCoord) / 2;
+
+    for (int i = 0; i < TENTATIVE_MAX; i++) {
+        TentativeTrack& t = slots[i];
+        if (!t.active || (t.history & 1))
+            continue;
+
+        // Frames since the track was last seen
+        int frames = 1;
+        while (frames < 32 && !(t.history & (1u << frames)))
+            frames++;
+
+        int dx = abs(x - (t.lastBox.rect.topLeftXCoord + t.lastBox.rect.bottomRightXCoord) / 2);
+        int dy = abs(y - (t.lastBox.rect.topLeftYCoord + t.lastBox.rect.bottomRightYCoord) / 2);
+        if (dx > TENTATIVE_GATE_X * frames || dy > TENTATIVE_GATE_Y * frames)
+            continue;
+
+        if (best < 0 || dx + dy < bestDist) {
+            best = i;
+            bestDist = dx + dy;
+        }
+    }
+
+    if (best >= 0) {
+        slots[best].history |= 1;
+        slots[best].lastBox = box;
+    }
+
+    return best;
+}
+
+/*
+ * Starts a tentative track at the box. Returns its slot, or -1 if the
+ * buffer is full.
+ */
+int TentativeTracks::Add(const InferenceBoundingBox& box, int id) {
+    if (numActive == TENTATIVE_MAX)
+        return -1;
+
+    for (int i = 0; i < TENTATIVE_MAX; i++) {
+        TentativeTrack& t = slots[i];
+        if (t.active)
+            continue;
+
+        t.active = true;
+        t.history = 1;
+        t.lastBox = box;
+        t.id = id;
+        numActive++;
+        created++;
+        return i;
+    }
+
+    return -1;
+}
+
+/*
+ * True once the track has been seen in confirmHits of the last
+ * confirmFrames frames.
+ */
+bool TentativeTracks::IsConfirmed(int slot, const TrackerConfig& cfg) {
+    return CountHits(slots[slot].history & WindowMask(cfg)) >= cfg.confirmHits;
+}
+
+int TentativeTracks::GetId(int slot) {
+    return slots[slot].id;
+}
+
+/*
+ * Frees the slot of a track that has been given a real tracker.
+ */
+void TentativeTracks::Promote(int slot) {
+    slots[slot].active = false;
+    numActive--;
+    promoted++;
+}
+
+int TentativeTracks::GetActive(void) {
+    return numActive;
+}
+
+long long TentativeTracks::GetCreated(void) {
+    return created;
+}
+
+long long TentativeTracks::GetPromoted(void) {
+    return promoted;
+}
+
+/*
+ * Number of tentative tracks dropped without being promoted, which are
+ * mostly false detections.
+ */
+long long TentativeTracks::GetRejected(void) {
+    return rejected;
+}
@@ -0,0 +1,90 @@
+/*
+ *  TrackFit.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "TrackFit.h"
+#include "Tracker.h"
+#include <math.h>
+
+TrackFit::TrackFit() : t(0), points(0), sw(0), swt(0), swx(0), swtt(0), swtx(0), swxx(0) {
+}
+
+/*
+ * Adds the x position of the box matched in the current frame.
+ */
+void TrackFit::Add(int x, float confidence) {
+    // Confidence in percent, so the sums stay integers
+    int64_t w = (int64_t)(confidence * 100);
+    if (w < 1)
+        w = 1;
+
+    sw += w;
+    swt += w * t;
+    swx += w * x;
+    swtt += w * t * t;
+    swtx += w * t * x;
+    swxx += w * x * x;
+    points++;
+}
+
+/*
+ * Moves on to the next frame. Called once at the end of every frame,
+ * whether or not a box was added.
+ */
+void TrackFit::Tick(void) {
+    t++;
+}
+
+/*
+ * Direction of the fitted slope, RIGHT for x going up, or -1 if the fit
+ * isn't sure yet.
+ */
+int TrackFit::GetDir(void) const {
+    if (points < FIT_MIN_POINTS)
+        return -1;
+
+    double slope = GetSlope();
+    if (slope == 0 || GetSlopeT() < FIT_MIN_T)
+        return -1;
+
+    return (slope > 0) ? RIGHT : LEFT;
+}
+
+/*
+ * Speed in pixels per frame, 0 until there are two frames to fit.
+ */
+double TrackFit::GetSlope(void) const {
+    double det = (double)sw * swtt - (double)swt * swt;
+    if (det <= 0)
+        return 0;
+
+    return ((double)sw * swtx - (double)swt * swx) / det;
+}
+
+/*
+ * How many standard errors the slope is from zero. Points that lie
+ * exactly on a line give an infinite value.
+ */
+double TrackFit::GetSlopeT(void) const {
+    double det = (double)sw * swtt - (double)swt * swt;
+    if (points < 3 || det <= 0)
+        return 0;
+
+    double b = GetSlope();
+    double a = (swx - b * swt) / sw;
+
+    // Weighted sum of the squared residuals
+    double ssr = swxx - 2 * a * swx - 2 * b * swtx + a * a * sw + 2 * a * b * swt + b * b * swtt;
+    if (ssr <= 0)
+        return INFINITY;
+
+    double varSlope = ssr / (points - 2) * sw / det;
+    return fabs(b) / sqrt(varSlope);
+}
+
+int TrackFit::GetPoints(void) const {
+    return points;
+}
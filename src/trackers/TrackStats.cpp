@@ -0,0 +1,117 @@
+/*
+ *  TrackStats.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "TrackStats.h"
+#include <iostream>
+#include <math.h>
+
+using std::cout;
+
+TrackStats::TrackStats(int cameraId, long long bucketMs, int numBuckets) : cameraId(cameraId), bucketMs(bucketMs),
+                                                                           numBuckets(numBuckets) {
+    buckets = new StatsBucket[numBuckets];
+    for (int i = 0; i < numBuckets; i++) {
+        buckets[i].startMs = -1;
+        buckets[i].tracks = 0;
+    }
+
+    mutex = new std::mutex();
+}
+
+/*
+ * Adds a path that just ended to the bucket of the time it ended. The
+ * speed is from the first point to the last, rather than along the path,
+ * since a tracker that picks up boxes of two people side by side zigzags
+ * between them. Paths with a single point have no speed, only a time in
+ * view of 0.
+ */
+void TrackStats::OnPathEnd(const TrajRecord& rec) {
+    int n = rec.head.numPoints;
+    if (n == 0)
+        return;
+
+    const TrajPoint* p = rec.points;
+    double dx = p[n - 1].x - p[0].x;
+    double dy = p[n - 1].y - p[0].y;
+    double length = sqrt(dx * dx + dy * dy);
+    int durationMs = p[n - 1].tMs - p[0].tMs;
+
+    long long endMs = rec.head.startMs + p[n - 1].tMs;
+    long long startMs = endMs - endMs % bucketMs;
+    StatsBucket& b = buckets[(endMs / bucketMs) % numBuckets];
+
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (b.startMs != startMs) {
+        // Recycle the bucket from a ring ago
+        b.startMs = startMs;
+        b.tracks = 0;
+        b.speed.Clear();
+        b.inView.Clear();
+    }
+
+    b.tracks++;
+    b.inView.Add(durationMs / 1000.0f);
+    if (durationMs > 0)
+        b.speed.Add((float)(length * 1000 / durationMs));
+}
+
+/*
+ * Merges the buckets that start in [fromMs, toMs) into the given digests,
+ * which may already hold other buckets or other cameras. Returns the
+ * number of tracks added.
+ */
+long long TrackStats::Rollup(long long fromMs, long long toMs, TDigest* speed, TDigest* inView) {
+    long long tracks = 0;
+
+    std::lock_guard<std::mutex> lock(*mutex);
+    for (int i = 0; i < numBuckets; i++) {
+        StatsBucket& b = buckets[i];
+        if (b.startMs < 0 || b.startMs < fromMs || b.startMs >= toMs)
+            continue;
+
+        speed->Merge(b.speed);
+        inView->Merge(b.inView);
+        tracks += b.tracks;
+    }
+
+    return tracks;
+}
+
+int TrackStats::GetCameraId(void) {
+    return cameraId;
+}
+
+long long TrackStats::GetBucketMs(void) {
+    return bucketMs;
+}
+
+/*
+ * Bytes taken by the buckets, which never grows.
+ */
+size_t TrackStats::GetMemory(void) {
+    return numBuckets * sizeof(StatsBucket);
+}
+
+/*
+ * Prints the distributions over the last bucket that has finished.
+ */
+void TrackStats::PrintReport(long long nowMs) {
+    long long endMs = nowMs - nowMs % bucketMs;
+    TDigest speed;
+    TDigest inView;
+
+    long long tracks = Rollup(endMs - bucketMs, endMs, &speed, &inView);
+    cout << "Camera " << cameraId << ", " << tracks << " people in the last " << bucketMs / 60000 << " min: "
+         << "speed " << speed.Quantile(0.1) << "/" << speed.Quantile(0.5) << "/" << speed.Quantile(0.9)
+         << " px/s, in view " << inView.Quantile(0.1) << "/" << inView.Quantile(0.5) << "/"
+         << inView.Quantile(0.9) << " s (10th/50th/90th percentile)\n";
+}
+
+TrackStats::~TrackStats() {
+    delete[] buckets;
+    delete mutex;
+}
@@ -0,0 +1,293 @@
+/*
+ *  Trajectories.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Trajectories.h"
+#include <cstring>
+#include <iostream>
+
+using namespace Spinnaker;
+
+using std::cout;
+using std::vector;
+
+TrajectoryLog::TrajectoryLog(int depth) : file(NULL), writer(NULL), written(0) {
+    queue = new SpscQueue<TrajRecord>(depth);
+}
+
+/*
+ * Starts a new log file and the thread that writes to it.
+ */
+int TrajectoryLog::Open(const char* path) {
+    if (file != NULL)
+        return -1;
+
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    TrajLogHeader hdr;
+    hdr.magic = TRAJ_LOG_MAGIC;
+    hdr.version = TRAJ_LOG_VERSION;
+    hdr.maxPoints = TRAJ_POINTS;
+    hdr.reserved = 0;
+    fwrite(&hdr, sizeof(hdr), 1, file);
+
+    writer = new std::thread(&TrajectoryLog::RunWriter, this);
+    return 0;
+}
+
+/*
+ * Writes out the paths still queued and closes the file. Paths ended
+ * after this are dropped.
+ */
+void TrajectoryLog::Close(void) {
+    if (writer == NULL)
+        return;
+
+    queue->Close();
+    writer->join();
+    delete writer;
+    writer = NULL;
+
+    fclose(file);
+}
+
+/*
+ * Queues a path to be written. Never waits: the path is dropped if the
+ * writer has fallen too far behind. rec is swapped with a spent record.
+ */
+void TrajectoryLog::Write(TrajRecord& rec) {
+    if (writer != NULL)
+        queue->TryPush(rec);
+}
+
+long long TrajectoryLog::GetWritten(void) {
+    return written;
+}
+
+long long TrajectoryLog::GetDropped(void) {
+    return queue->GetDropped();
+}
+
+void TrajectoryLog::RunWriter(void) {
+    TrajRecord rec;
+
+    while (queue->Pop(rec)) {
+        fwrite(&rec.head, sizeof(rec.head), 1, file);
+        fwrite(rec.points, sizeof(TrajPoint), rec.head.numPoints, file);
+        written++;
+    }
+}
+
+TrajectoryLog::~TrajectoryLog() {
+    Close();
+    delete queue;
+}
+
+Trajectories::Trajectories(int maxTracks) : maxTracks(maxTracks), numFree(maxTracks), log(NULL), ended(0),
+                                            untracked(0), simplified(0) {
+    table = new TrajRecord[maxTracks];
+    freeSlots = new int[maxTracks];
+    listeners = new vector<PathListener*>();
+
+    // Lowest slots are handed out first
+    for (int i = 0; i < maxTracks; i++)
+        freeSlots[i] = maxTracks - 1 - i;
+}
+
+/*
+ * Gives a new track a slot. Returns -1 if the table is full, in which
+ * case the track has no path.
+ */
+int Trajectories::Start(int trackId, long long nowMs) {
+    if (numFree == 0) {
+        untracked++;
+        return -1;
+    }
+
+    int slot = freeSlots[--numFree];
+    TrajRecord& rec = table[slot];
+    rec.head.trackId = trackId;
+    rec.head.dir = -1;
+    rec.head.numPoints = 0;
+    rec.head.startMs = nowMs;
+    return slot;
+}
+
+/*
+ * Adds the footprint of a box the track was matched to.
+ */
+void Trajectories::Add(int slot, const InferenceBoundingBox& box, long long nowMs) {
+    if (slot < 0)
+        return;
+
+    TrajRecord& rec = table[slot];
+    if (rec.head.numPoints == TRAJ_POINTS)
+        Simplify(rec);
+
+    TrajPoint& p = rec.points[rec.head.numPoints++];
+    p.tMs = (int32_t)(nowMs - rec.head.startMs);
+    p.x = (int16_t)((box.rect.topLeftXCoord + box.rect.bottomRightXCoord) / 2);
+    p.y = (int16_t)box.rect.bottomRightYCoord;
+}
+
+/*
+ * The track was counted in the given direction. Its path goes to the
+ * listeners and the log, if there are any, and the slot is freed.
+ */
+void Trajectories::End(int slot, int dir) {
+    if (slot < 0)
+        return;
+
+    table[slot].head.dir = (int16_t)dir;
+    for (auto it = listeners->begin(); it != listeners->end(); ++it)
+        (*it)->OnPathEnd(table[slot]);
+    if (log != NULL)
+        log->Write(table[slot]);
+
+    freeSlots[numFree++] = slot;
+    ended++;
+}
+
+/*
+ * Path of a track that hasn't ended, or NULL if it has none.
+ */
+const TrajRecord* Trajectories::Get(int slot) {
+    return (slot >= 0) ? &table[slot] : NULL;
+}
+
+/*
+ * Writes every path that ends from now on to the given file.
+ */
+int Trajectories::OpenLog(const char* path) {
+    if (log == NULL)
+        log = new TrajectoryLog();
+
+    return log->Open(path);
+}
+
+TrajectoryLog* Trajectories::GetLog(void) {
+    return log;
+}
+
+/*
+ * Tells the listener about every path that ends from now on. The
+ * listener is not owned by the Trajectories.
+ */
+void Trajectories::AddListener(PathListener* listener) {
+    listeners->push_back(listener);
+}
+
+int Trajectories::GetActive(void) {
+    return maxTracks - numFree;
+}
+
+/*
+ * Bytes taken by the table, which never grows.
+ */
+size_t Trajectories::GetMemory(void) {
+    return maxTracks * (sizeof(TrajRecord) + sizeof(int));
+}
+
+long long Trajectories::GetEnded(void) {
+    return ended;
+}
+
+/*
+ * Tracks that got no path because the table was full.
+ */
+long long Trajectories::GetUntracked(void) {
+    return untracked;
+}
+
+/*
+ * Points dropped to make room for newer ones.
+ */
+long long Trajectories::GetSimplified(void) {
+    return simplified;
+}
+
+void Trajectories::PrintReport(void) {
+    cout << "Trajectories: " << ended << " ended, " << untracked << " without a path, " << simplified
+         << " points simplified away, " << GetMemory() / 1024 << " KB for " << maxTracks << " tracks\n";
+
+    if (log != NULL)
+        cout << "Trajectory log: " << log->GetWritten() << " written, " << log->GetDropped() << " dropped\n";
+}
+
+/*
+ * Drops the inner point that is closest to where the person would be if
+ * they had gone straight from the point before it to the point after it
+ * at a steady pace.
+ */
+void Trajectories::Simplify(TrajRecord& rec) {
+    int n = rec.head.numPoints;
+    int best = 1;
+    float bestErr = -1;
+
+    for (int i = 1; i < n - 1; i++) {
+        const TrajPoint& a = rec.points[i - 1];
+        const TrajPoint& p = rec.points[i];
+        const TrajPoint& b = rec.points[i + 1];
+
+        int span = b.tMs - a.tMs;
+        float frac = (span > 0) ? (float)(p.tMs - a.tMs) / span : 0;
+        float dx = p.x - (a.x + frac * (b.x - a.x));
+        float dy = p.y - (a.y + frac * (b.y - a.y));
+        float err = dx * dx + dy * dy;
+
+        if (bestErr < 0 || err < bestErr) {
+            best = i;
+            bestErr = err;
+        }
+    }
+
+    memmove(&rec.points[best], &rec.points[best + 1], (n - best - 1) * sizeof(TrajPoint));
+    rec.head.numPoints--;
+    simplified++;
+}
+
+Trajectories::~Trajectories() {
+    delete log;
+    delete listeners;
+    delete[] table;
+    delete[] freeSlots;
+}
+
+/*
+ * Reads every path in a log written by TrajectoryLog.
+ */
+int LoadTrajectories(const char* path, vector<TrajRecord>& records) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    TrajLogHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != TRAJ_LOG_MAGIC || hdr.version != TRAJ_LOG_VERSION ||
+        hdr.maxPoints > TRAJ_POINTS) {
+        cout << "Not a trajectory log, or an unsupported version.\n";
+        fclose(f);
+        return -1;
+    }
+
+    TrajRecord rec;
+    while (fread(&rec.head, sizeof(rec.head), 1, f) == 1) {
+        if (rec.head.numPoints < 0 || rec.head.numPoints > (int)hdr.maxPoints ||
+            fread(rec.points, sizeof(TrajPoint), rec.head.numPoints, f) != (size_t)rec.head.numPoints) {
+            cout << "Trajectory log " << path << " is cut short.\n";
+            break;
+        }
+        records.push_back(rec);
+    }
+
+    fclose(f);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ *  Arena.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Arena.h"
+#include <iostream>
+#include <new>
+
+using std::cout;
+
+ArenaPool::ArenaPool() : name(""), slotSize(0), slots(0), base(NULL), freeList(NULL), inUse(0),
+                         highWater(0), refused(0) {
+}
+
+/*
+ * Takes a free slot, or returns NULL if every slot is in use or the arena
+ * hasn't been committed. Take and Give must be called from one thread.
+ */
+void* ArenaPool::Take(void) {
+    if (freeList == NULL) {
+        refused++;
+        return NULL;
+    }
+
+    void* p = freeList;
+    freeList = *(void**)p;
+    NoteUsed(++inUse);
+    return p;
+}
+
+void ArenaPool::Give(void* p) {
+    *(void**)p = freeList;
+    freeList = p;
+    inUse--;
+}
+
+/*
+ * Slot i of the pool, for pools used as an array.
+ */
+void* ArenaPool::GetSlot(int i) {
+    if (base == NULL || i < 0 || i >= slots)
+        return NULL;
+    return base + i * slotSize;
+}
+
+/*
+ * Records how many slots of an array pool are in use. Returns false, and
+ * counts a refusal, if that is more than there are.
+ */
+bool ArenaPool::NoteUsed(int used) {
+    bool fits = (used <= slots);
+    if (!fits) {
+        refused++;
+        used = slots;
+    }
+
+    int high = highWater;
+    while (used > high && !highWater.compare_exchange_weak(high, used))
+        ;
+
+    return fits;
+}
+
+/*
+ * Counts a request the pool couldn't meet for another reason, such as
+ * being bigger than a slot.
+ */
+void ArenaPool::NoteRefused(void) {
+    refused++;
+}
+
+const char* ArenaPool::GetName(void) {
+    return name;
+}
+
+size_t ArenaPool::GetSlotSize(void) {
+    return slotSize;
+}
+
+int ArenaPool::GetSlots(void) {
+    return slots;
+}
+
+int ArenaPool::GetHighWater(void) {
+    return highWater;
+}
+
+/*
+ * Number of times a slot was wanted when there were none left.
+ */
+long long ArenaPool::GetRefused(void) {
+    return refused;
+}
+
+Arena::Arena() : numPools(0), block(NULL), size(0) {
+}
+
+/*
+ * Adds a pool of the given number of slots. Must be called before Commit;
+ * the pool's memory is only there once the arena has been committed.
+ * Returns NULL if there are too many pools.
+ */
+ArenaPool* Arena::AddPool(const char* name, size_t slotSize, int slots) {
+    if (block != NULL || numPools == ARENA_MAX_POOLS) {
+        cout << "Unable to add arena pool " << name << ".\n";
+        return NULL;
+    }
+
+    // Room for the free list link, and every slot aligned
+    if (slotSize > 0 && slotSize < sizeof(void*))
+        slotSize = sizeof(void*);
+    slotSize = (slotSize + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ArenaPool& pool = pools[numPools++];
+    pool.name = name;
+    pool.slotSize = slotSize;
+    pool.slots = slots;
+    return &pool;
+}
+
+/*
+ * Makes the single allocation and splits it between the pools.
+ */
+int Arena::Commit(void) {
+    if (block != NULL)
+        return 0;
+
+    size = 0;
+    for (int i = 0; i < numPools; i++)
+        size += pools[i].slotSize * pools[i].slots;
+
+    block = new (std::nothrow) uint8_t[size + ARENA_ALIGN];
+    if (block == NULL) {
+        cout << "Unable to allocate an arena of " << size << " bytes.\n";
+        return -1;
+    }
+
+    uint8_t* next = block + (ARENA_ALIGN - (uintptr_t)block % ARENA_ALIGN) % ARENA_ALIGN;
+    for (int i = 0; i < numPools; i++) {
+        ArenaPool& pool = pools[i];
+        if (pool.slotSize == 0)
+            continue;
+
+        pool.base = next;
+        next += pool.slotSize * pool.slots;
+
+        // Free list in slot order
+        for (int s = pool.slots - 1; s >= 0; s--)
+            pool.Give(pool.base + s * pool.slotSize);
+        pool.inUse = 0;
+    }
+
+    return 0;
+}
+
+bool Arena::IsCommitted(void) {
+    return block != NULL;
+}
+
+size_t Arena::GetSize(void) {
+    return size;
+}
+
+/*
+ * Prints the capacity, high water mark and refusals of every pool.
+ */
+void Arena::PrintReport(void) {
+    cout << "Arena: " << size / 1024 << " KiB in " << numPools << " pools\n";
+    for (int i = 0; i < numPools; i++) {
+        ArenaPool& pool = pools[i];
+        cout << "  " << pool.name << ": " << pool.GetHighWater() << " of " << pool.slots << " slots used at most, "
+             << pool.slotSize * pool.slots / 1024 << " KiB, full " << pool.GetRefused() << " times\n";
+    }
+}
+
+Arena::~Arena() {
+    delete[] block;
+}
@@ -0,0 +1,102 @@
+/*
+ *  Clock.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Clock.h"
+#include <chrono>
+#include <thread>
+
+using std::chrono::steady_clock;
+
+long long SteadyClock::NowUs(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SteadyClock::SleepUntilUs(long long wakeupUs) {
+    std::this_thread::sleep_until(steady_clock::time_point(std::chrono::microseconds(wakeupUs)));
+}
+
+SimClock::SimClock(long long startUs) : nowUs(startUs), firstStampUs(0), stamped(false) {
+}
+
+long long SimClock::NowUs(void) {
+    return nowUs;
+}
+
+/*
+ * Jumps straight to the wakeup time.
+ */
+void SimClock::SleepUntilUs(long long wakeupUs) {
+    AdvanceTo(wakeupUs);
+}
+
+/*
+ * Moves the clock on by however long the camera says it has been since
+ * its first frame.
+ */
+void SimClock::OnFrameStamp(long long stampUs) {
+    if (!stamped) {
+        firstStampUs = stampUs - nowUs;
+        stamped = true;
+    }
+
+    AdvanceTo(stampUs - firstStampUs);
+}
+
+void SimClock::AdvanceTo(long long us) {
+    if (us > nowUs)
+        nowUs.store(us);
+}
+
+/*
+ * Real clock shared by everything that isn't given one.
+ */
+Clock* GetSteadyClock(void) {
+    static SteadyClock clock;
+    return &clock;
+}
+
+PeriodicTimer::PeriodicTimer(Clock* clock, long long periodUs) : clock(clock), periodUs(periodUs), nextUs(0),
+                                                                 started(false), overruns(0) {
+}
+
+/*
+ * Takes effect from the next wakeup.
+ */
+void PeriodicTimer::SetPeriodUs(long long period) {
+    periodUs = period;
+}
+
+/*
+ * Sleeps until the next tick, the first one being a period from the
+ * first call. Returns how many microseconds late it woke up.
+ */
+long long PeriodicTimer::Wait(void) {
+    long long nowUs = clock->NowUs();
+    if (!started) {
+        nextUs = nowUs;
+        started = true;
+    }
+    nextUs += periodUs;
+
+    // Fell more than a whole period behind
+    if (nowUs > nextUs + periodUs) {
+        long long missed = (nowUs - nextUs) / periodUs;
+        overruns += missed;
+        nextUs += missed * periodUs;
+    }
+
+    clock->SleepUntilUs(nextUs);
+    return clock->NowUs() - nextUs;
+}
+
+/*
+ * Ticks skipped because the caller took longer than a period between
+ * waits.
+ */
+long long PeriodicTimer::GetOverruns(void) {
+    return overruns;
+}
@@ -0,0 +1,234 @@
+/*
+ *  ConfigStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ConfigStore.h"
+#include "GUI/RapidXML/rapidxml.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+using std::cout;
+using std::vector;
+using std::mutex;
+
+ConfigStore::ConfigStore() : current(new TrackerConfig()), inUse(NULL), fileTimeNs(0), fileSize(0) {
+    writerMutex = new mutex();
+    retired = new vector<const TrackerConfig*>();
+}
+
+/*
+ * Returns the latest config, which stays valid until Release is called.
+ * Called by the tracking thread at the start of every frame.
+ */
+const TrackerConfig* ConfigStore::Acquire(void) {
+    const TrackerConfig* cfg;
+
+    // Announce which version is in use, and make sure it was not replaced
+    // (and possibly freed) before the announcement became visible
+    do {
+        cfg = current.load();
+        inUse.store(cfg);
+    } while (cfg != current.load());
+
+    return cfg;
+}
+
+void ConfigStore::Release(void) {
+    inUse.store(NULL);
+}
+
+/*
+ * Copies out the latest config, for threads other than the reader. Takes
+ * the writer lock, so the version can't be freed while it is copied.
+ */
+void ConfigStore::Copy(TrackerConfig& cfg) {
+    std::lock_guard<mutex> lock(*writerMutex);
+    cfg = *current.load();
+}
+
+/*
+ * Makes a copy of cfg the current config. Versions that are no longer
+ * current are freed once the reader is not using them.
+ */
+void ConfigStore::Publish(const TrackerConfig& cfg) {
+    writerMutex->lock();
+
+    const TrackerConfig* old = current.exchange(new TrackerConfig(cfg));
+    retired->push_back(old);
+
+    const TrackerConfig* used = inUse.load();
+    for (auto it = retired->begin(); it != retired->end(); ) {
+        if (*it != used) {
+            delete *it;
+            it = retired->erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    writerMutex->unlock();
+}
+
+/*
+ * Loads a config from an XML file and publishes it. The file is
+ * remembered so that ReloadIfChanged can pick up later edits. If the
+ * file is invalid the current config is kept.
+ */
+int ConfigStore::LoadFile(const char* filePath) {
+    path = filePath;
+    StatFile(filePath, &fileTimeNs, &fileSize);
+
+    FILE* f = fopen(filePath, "rb");
+    if (f == NULL) {
+        cout << "Unable to open " << filePath << ".\n";
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    vector<char> xml(size + 1, '\0');
+    size_t read = fread(xml.data(), 1, size, f);
+    fclose(f);
+
+    if (read != (size_t)size) {
+        cout << "Unable to read " << filePath << ".\n";
+        return -1;
+    }
+
+    TrackerConfig cfg;
+    if (ParseConfig(xml.data(), cfg)) {
+        cout << "Invalid tracker config in " << filePath << ", keeping the current config.\n";
+        return -1;
+    }
+
+    Publish(cfg);
+    return 0;
+}
+
+/*
+ * Reloads the config file if its modification time or size has changed
+ * since it was last loaded. Returns 1 if a new config was published.
+ */
+int ConfigStore::ReloadIfChanged(void) {
+    if (path.empty())
+        return 0;
+
+    long long timeNs;
+    long long size;
+    if (StatFile(path.c_str(), &timeNs, &size) || (timeNs == fileTimeNs && size == fileSize))
+        return 0;
+
+    return (LoadFile(path.c_str()) == 0) ? 1 : -1;
+}
+
+ConfigStore::~ConfigStore() {
+    delete current.load();
+    for (auto it = retired->begin(); it != retired->end(); ++it)
+        delete *it;
+
+    delete retired;
+    delete writerMutex;
+}
+
+/************************** Private Functions **************************/
+
+int ConfigStore::ParseConfig(char* xml, TrackerConfig& cfg) {
+    rapidxml::xml_document<> doc;
+
+    try {
+        doc.parse<0>(xml);
+    }
+    catch (rapidxml::parse_error& e) {
+        cout << "XML parse error: " << e.what() << ".\n";
+        return -1;
+    }
+
+    rapidxml::xml_node<>* root = doc.first_node("TrackerConfig");
+    if (root == NULL) {
+        cout << "Missing TrackerConfig element.\n";
+        return -1;
+    }
+
+    for (rapidxml::xml_node<>* node = root->first_node(); node != NULL; node = node->next_sibling()) {
+        char* end;
+        double val = strtod(node->value(), &end);
+        if (end == node->value() || val < 0) {
+            cout << "Invalid value for " << node->name() << ".\n";
+            return -1;
+        }
+
+        const char* name = node->name();
+        if (strcmp(name, "MISSING_THRESH") == 0)
+            cfg.missingThresh = (int)val;
+        else if (strcmp(name, "CONFIDENCE_THRESH") == 0)
+            cfg.confidenceThresh = val;
+        else if (strcmp(name, "DIST_TOLERANCE") == 0)
+            cfg.distTolerance = val;
+        else if (strcmp(name, "DIST_THRESH") == 0)
+            cfg.distThresh = val;
+        else if (strcmp(name, "DIST_X_THRESH") == 0)
+            cfg.distXThresh = val;
+        else if (strcmp(name, "DIST_Y_THRESH") == 0)
+            cfg.distYThresh = val;
+        else if (strcmp(name, "VEL_X_THRESH") == 0)
+            cfg.velXThresh = val;
+        else if (strcmp(name, "BOX_SIZE_THRESH") == 0)
+            cfg.boxSizeThresh = val;
+        else if (strcmp(name, "IOU_THRESH") == 0)
+            cfg.iouThresh = val;
+        else if (strcmp(name, "CONFIRM_HITS") == 0)
+            cfg.confirmHits = (int)val;
+        else if (strcmp(name, "CONFIRM_FRAMES") == 0)
+            cfg.confirmFrames = (int)val;
+        else
+            cout << "Ignoring unknown threshold " << name << ".\n";
+    }
+
+    // A tracker would be dropped the frame it went missing
+    if (cfg.missingThresh == 0) {
+        cout << "MISSING_THRESH must be at least 1.\n";
+        return -1;
+    }
+
+    // No track could ever be confirmed
+    if (cfg.confirmHits > cfg.confirmFrames) {
+        cout << "CONFIRM_HITS can't be more than CONFIRM_FRAMES.\n";
+        return -1;
+    }
+
+    if (cfg.confirmFrames > CONFIRM_FRAMES_MAX) {
+        cout << "CONFIRM_FRAMES can't be more than " << CONFIRM_FRAMES_MAX << ".\n";
+        return -1;
+    }
+
+    return 0;
+}
+
+/*
+ * Modification time of a file, to the nanosecond where the platform
+ * keeps it, and its size. Returns -1 if the file can't be found.
+ */
+int ConfigStore::StatFile(const char* filePath, long long* timeNs, long long* size) {
+    struct stat st;
+    if (stat(filePath, &st) != 0)
+        return -1;
+
+#if defined(__APPLE__)
+    *timeNs = (long long)st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    *timeNs = (long long)st.st_mtime * 1000000000LL;
+#else
+    *timeNs = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    *size = (long long)st.st_size;
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+ *  Executor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Executor.h"
+#include <algorithm>
+#include <iostream>
+
+using std::vector;
+using std::deque;
+using std::mutex;
+using std::unique_lock;
+using std::thread;
+using std::condition_variable;
+using std::coroutine_handle;
+using std::chrono::steady_clock;
+
+// Earliest wakeup on top of the timer heap
+static bool LaterWakeup(const TimerEntry& a, const TimerEntry& b) {
+    return a.wakeup > b.wakeup;
+}
+
+void CoTask::promise_type::FinalAwaiter::await_suspend(coroutine_handle<promise_type> h) noexcept {
+    Executor* executor = h.promise().executor;
+    h.destroy();
+    executor->TaskDone();
+}
+
+void CoTask::promise_type::unhandled_exception(void) {
+    std::cout << "Unhandled exception in a coroutine.\n";
+}
+
+Executor::Executor(int threadCount) : numThreads(threadCount), running(false), endSignal(false),
+                                      liveTasks(0), resumes(0) {
+    threads = new vector<thread>();
+    readyMutex = new mutex();
+    readyCond = new condition_variable();
+    ready = new deque<coroutine_handle<>>();
+    timers = new vector<TimerEntry>();
+}
+
+void Executor::Start(void) {
+    if (running)
+        return;
+
+    endSignal = false;
+    for (int i = 0; i < numThreads; i++)
+        threads->push_back(thread(&Executor::RunThread, this));
+    running = true;
+}
+
+/*
+ * Waits for the threads to finish. Tasks should be told to return first;
+ * any that are still suspended are never resumed.
+ */
+void Executor::Stop(void) {
+    if (!running)
+        return;
+
+    readyMutex->lock();
+    endSignal = true;
+    readyMutex->unlock();
+    readyCond->notify_all();
+
+    for (auto it = threads->begin(); it != threads->end(); ++it)
+        it->join();
+    threads->clear();
+    running = false;
+}
+
+/*
+ * Starts a task on the executor. It runs until it returns, and frees
+ * itself.
+ */
+void Executor::Spawn(CoTask task) {
+    task.handle.promise().executor = this;
+    liveTasks++;
+    Schedule(task.handle);
+}
+
+/*
+ * Queues a suspended coroutine to be resumed. Can be called from any
+ * thread.
+ */
+void Executor::Schedule(coroutine_handle<> h) {
+    readyMutex->lock();
+    ready->push_back(h);
+    readyMutex->unlock();
+    readyCond->notify_one();
+}
+
+void Executor::ScheduleAt(coroutine_handle<> h, steady_clock::time_point wakeup) {
+    readyMutex->lock();
+    timers->push_back(TimerEntry{ wakeup, h });
+    std::push_heap(timers->begin(), timers->end(), LaterWakeup);
+    readyMutex->unlock();
+
+    // The new timer may be due before the one the threads wait for
+    readyCond->notify_one();
+}
+
+Executor::SleepAwaiter Executor::SleepFor(int ms) {
+    return SleepAwaiter{ this, steady_clock::now() + std::chrono::milliseconds(ms) };
+}
+
+Executor::SleepAwaiter Executor::SleepUntil(steady_clock::time_point wakeup) {
+    return SleepAwaiter{ this, wakeup };
+}
+
+int Executor::GetNumThreads(void) {
+    return numThreads;
+}
+
+/*
+ * Tasks spawned that haven't returned yet.
+ */
+int Executor::GetLiveTasks(void) {
+    return liveTasks;
+}
+
+/*
+ * Number of times a coroutine was resumed, i.e. switched to.
+ */
+long long Executor::GetResumes(void) {
+    return resumes;
+}
+
+void Executor::RunThread(void) {
+    unique_lock<mutex> lock(*readyMutex);
+
+    while (!endSignal) {
+        // Move the timers that are due onto the ready queue
+        steady_clock::time_point now = steady_clock::now();
+        while (!timers->empty() && timers->front().wakeup <= now) {
+            std::pop_heap(timers->begin(), timers->end(), LaterWakeup);
+            ready->push_back(timers->back().handle);
+            timers->pop_back();
+        }
+
+        if (ready->empty()) {
+            if (timers->empty())
+                readyCond->wait(lock);
+            else
+                readyCond->wait_until(lock, timers->front().wakeup);
+            continue;
+        }
+
+        coroutine_handle<> h = ready->front();
+        ready->pop_front();
+        lock.unlock();
+
+        resumes++;
+        h.resume();
+
+        lock.lock();
+    }
+}
+
+void Executor::TaskDone(void) {
+    liveTasks--;
+}
+
+Executor::~Executor() {
+    Stop();
+
+    delete threads;
+    delete readyMutex;
+    delete readyCond;
+    delete ready;
+    delete timers;
+}
+
+FrameSignal::FrameSignal(Executor* executor) : executor(executor), pending(false), closed(false), merged(0) {
+}
+
+/*
+ * Wakes up the waiting coroutine, or the next one to wait if there is
+ * none. Can be called from any thread.
+ */
+void FrameSignal::Notify(void) {
+    coroutine_handle<> wake;
+
+    lock.lock();
+    lastNotify = steady_clock::now();
+    if (waiter) {
+        std::swap(wake, waiter);
+    }
+    else {
+        if (pending)
+            merged++;
+        pending = true;
+    }
+    lock.unlock();
+
+    if (wake)
+        executor->Schedule(wake);
+}
+
+void FrameSignal::OnFrame(void) {
+    Notify();
+}
+
+/*
+ * Wakes up the waiting coroutine for good: every wait from now on
+ * resumes with false.
+ */
+void FrameSignal::Close(void) {
+    coroutine_handle<> wake;
+
+    lock.lock();
+    closed = true;
+    std::swap(wake, waiter);
+    lock.unlock();
+
+    if (wake)
+        executor->Schedule(wake);
+}
+
+/*
+ * Resumes with true once the signal has fired since the last wait, or
+ * false if it was closed.
+ */
+FrameSignal::Awaiter FrameSignal::Wait(void) {
+    return Awaiter{ this };
+}
+
+bool FrameSignal::Awaiter::await_ready(void) {
+    return false;
+}
+
+bool FrameSignal::Awaiter::await_suspend(coroutine_handle<> h) {
+    std::lock_guard<mutex> guard(signal->lock);
+    if (signal->pending || signal->closed) {
+        signal->pending = false;
+        return false;
+    }
+
+    signal->waiter = h;
+    return true;
+}
+
+bool FrameSignal::Awaiter::await_resume(void) {
+    std::lock_guard<mutex> guard(signal->lock);
+    return !signal->closed;
+}
+
+/*
+ * When the signal last fired, i.e. when the latest frame came in.
+ */
+steady_clock::time_point FrameSignal::GetLastNotify(void) {
+    std::lock_guard<mutex> guard(lock);
+    return lastNotify;
+}
+
+/*
+ * Number of times the signal fired again before the waiter caught up,
+ * i.e. frames that were skipped.
+ */
+long long FrameSignal::GetMerged(void) {
+    return merged;
+}
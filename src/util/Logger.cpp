@@ -0,0 +1,460 @@
+/*
+ *  Logger.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+
+using std::string;
+
+static const char* levelNames[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+Logger::Logger(int capacity) : tail(0), head(0), minLevel(LOG_LVL_DEBUG), rateBurst(LOG_RATE_BURST),
+                               rateWindowUs(LOG_RATE_WINDOW_MS * 1000LL), dropped(0), suppressed(0),
+                               written(0), rotations(0), writer(NULL), endSignal(false), file(NULL),
+                               fileBytes(0), echo(true), droppedReported(0) {
+    // Rounded up to a power of two so positions can be masked
+    size_t size = 1;
+    while (size < (size_t)capacity)
+        size <<= 1;
+
+    ring = new LogRecord[size];
+    mask = size - 1;
+    for (size_t i = 0; i < size; i++)
+        ring[i].seq.store(i);
+
+    rates = new LogRate[LOG_RATE_SLOTS];
+    reportedUs = new long long[LOG_RATE_SLOTS];
+    lastLines = new char[LOG_RATE_SLOTS * LOG_LAST_LINE_BYTES];
+    for (int i = 0; i < LOG_RATE_SLOTS; i++) {
+        rates[i].key.store(0);
+        rates[i].windowUs.store(0);
+        rates[i].count.store(0);
+        rates[i].suppressed.store(0);
+        rates[i].level.store(LOG_LVL_DEBUG);
+        reportedUs[i] = 0;
+        lastLines[i * LOG_LAST_LINE_BYTES] = '\0';
+    }
+
+    path = new string();
+    line = new string();
+}
+
+void Logger::Start(void) {
+    if (writer != NULL)
+        return;
+
+    endSignal.store(false);
+    writer = new std::thread(&Logger::RunWriter, this);
+}
+
+/*
+ * Stops the writer thread once it has written everything logged so far.
+ */
+void Logger::Stop(void) {
+    if (writer == NULL)
+        return;
+
+    endSignal.store(true);
+    writer->join();
+    delete writer;
+    writer = NULL;
+}
+
+/*
+ * Waits until everything logged before the call has been written. Without
+ * the writer running, writes it on the calling thread, so only one thread
+ * may call it then.
+ */
+void Logger::Flush(void) {
+    if (writer == NULL) {
+        Drain();
+        ReportDropped();
+        if (file != NULL)
+            fflush(file);
+        return;
+    }
+
+    size_t target = tail.load();
+    while (head.load() < target && writer != NULL)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+/*
+ * Appends to the file at path from now on, as well as printing. The
+ * writer is stopped while the file is switched, so messages logged in
+ * the meantime wait in the ring.
+ */
+int Logger::OpenFile(const char* p) {
+    bool running = (writer != NULL);
+    Stop();
+
+    if (file != NULL)
+        fclose(file);
+
+    int err = 0;
+    file = fopen(p, "ab");
+    if (file == NULL) {
+        std::cout << "Unable to open " << p << ".\n";
+        err = -1;
+    }
+    else {
+        *path = p;
+        fseek(file, 0, SEEK_END);
+        fileBytes = ftell(file);
+    }
+
+    if (running)
+        Start();
+    return err;
+}
+
+/*
+ * Whether to print messages as well as writing them to the file.
+ */
+void Logger::SetEcho(bool e) {
+    echo.store(e);
+}
+
+/*
+ * Drops messages below the given level.
+ */
+void Logger::SetLevel(int level) {
+    minLevel.store(level);
+}
+
+void Logger::SetRateLimit(int burst, long long windowMs) {
+    rateBurst.store(burst);
+    rateWindowUs.store(windowMs * 1000);
+}
+
+/*
+ * Messages put in the ring, which is every record ever claimed.
+ */
+long long Logger::GetLogged(void) {
+    return (long long)tail.load();
+}
+
+/*
+ * Messages lost because the ring was full.
+ */
+long long Logger::GetDropped(void) {
+    return dropped;
+}
+
+/*
+ * Messages left out by the rate limit.
+ */
+long long Logger::GetSuppressed(void) {
+    return suppressed;
+}
+
+/*
+ * Lines written out by the writer, including its own notes.
+ */
+long long Logger::GetWritten(void) {
+    return written;
+}
+
+long long Logger::GetRotations(void) {
+    return rotations;
+}
+
+Logger::~Logger() {
+    Stop();
+    Flush();
+    ReportSuppressed(true);
+
+    if (file != NULL)
+        fclose(file);
+
+    delete[] ring;
+    delete[] rates;
+    delete[] reportedUs;
+    delete path;
+    delete line;
+    delete[] lastLines;
+}
+
+/*
+ * Log shared by the whole program. Its writer runs from the first call
+ * until the program exits, and only prints until a file is opened.
+ */
+Logger* GetLogger(void) {
+    static Logger logger;
+    static std::once_flag started;
+
+    std::call_once(started, [] { logger.Start(); });
+    return &logger;
+}
+
+/************************** Private Functions **************************/
+
+long long Logger::NowUs(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Counts the message against its key's rate and returns whether to log
+ * it, along with the slot it was counted in. The counts are only
+ * approximate when several threads log the same message at once, which
+ * doesn't matter for a limit.
+ */
+bool Logger::Admit(uintptr_t key, int level, long long nowUs, int* slot) {
+    *slot = -1;
+    if (key == 0)
+        key = 1;
+
+    size_t hash = (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32);
+    for (int i = 0; i < LOG_RATE_PROBES; i++) {
+        int s = (int)((hash + i) & (LOG_RATE_SLOTS - 1));
+        LogRate& rate = rates[s];
+
+        uintptr_t slotKey = rate.key.load(std::memory_order_acquire);
+        if (slotKey == 0 && rate.key.compare_exchange_strong(slotKey, key)) {
+            rate.level.store(level, std::memory_order_relaxed);
+            slotKey = key;
+        }
+        if (slotKey != key)
+            continue;
+        *slot = s;
+
+        long long windowUs = rate.windowUs.load(std::memory_order_relaxed);
+        if (nowUs - windowUs >= rateWindowUs.load(std::memory_order_relaxed) &&
+            rate.windowUs.compare_exchange_strong(windowUs, nowUs))
+            rate.count.store(0, std::memory_order_relaxed);
+
+        if (rate.count.fetch_add(1, std::memory_order_relaxed) < rateBurst.load(std::memory_order_relaxed))
+            return true;
+
+        rate.suppressed.fetch_add(1, std::memory_order_relaxed);
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Claims the next record, or returns NULL if the ring is full.
+ */
+LogRecord* Logger::Claim(size_t* pos) {
+    size_t t = tail.load(std::memory_order_relaxed);
+
+    while (true) {
+        LogRecord* rec = &ring[t & mask];
+        size_t seq = rec->seq.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)t;
+
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+                *pos = t;
+                return rec;
+            }
+        }
+        else if (diff < 0) {
+            // Still holds the message from one lap ago
+            return NULL;
+        }
+        else {
+            // Another thread got there first
+            t = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::Publish(LogRecord* rec, size_t pos) {
+    rec->seq.store(pos + 1, std::memory_order_release);
+}
+
+/*
+ * Copies the string into the record's text, cut short if it doesn't fit.
+ */
+void Logger::PutText(LogRecord* rec, const char* text) {
+    int room = LOG_TEXT_BYTES - rec->textBytes - 1;
+    if (text == NULL || room < 0) {
+        rec->args[rec->numArgs - 1].text = LOG_TEXT_BYTES - 1;
+        rec->text[LOG_TEXT_BYTES - 1] = '\0';
+        return;
+    }
+
+    int len = (int)strnlen(text, room);
+    memcpy(rec->text + rec->textBytes, text, len);
+    rec->text[rec->textBytes + len] = '\0';
+    rec->textBytes += len + 1;
+}
+
+void Logger::RunWriter(void) {
+    while (!endSignal) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(LOG_FLUSH_MS));
+
+        int n = Drain();
+        ReportSuppressed(false);
+        ReportDropped();
+        if (n > 0 && file != NULL)
+            fflush(file);
+    }
+
+    // Whatever was logged before Stop
+    Drain();
+    ReportDropped();
+    if (file != NULL)
+        fflush(file);
+}
+
+/*
+ * Writes out the records that have been filled in, in the order they
+ * were claimed. Returns the number written.
+ */
+int Logger::Drain(void) {
+    int n = 0;
+
+    while (true) {
+        size_t h = head.load(std::memory_order_relaxed);
+        LogRecord& rec = ring[h & mask];
+        if (rec.seq.load(std::memory_order_acquire) != h + 1)
+            break;
+
+        Format(rec);
+        Write(rec.level, rec.timeUs, *line);
+
+        // Slots keep their key for good, so the line stays theirs
+        if (rec.rateSlot >= 0) {
+            char* last = lastLines + rec.rateSlot * LOG_LAST_LINE_BYTES;
+            size_t len = std::min(line->size(), (size_t)LOG_LAST_LINE_BYTES - 1);
+            memcpy(last, line->data(), len);
+            last[len] = '\0';
+        }
+
+        rec.seq.store(h + mask + 1, std::memory_order_release);
+        head.store(h + 1, std::memory_order_release);
+        n++;
+    }
+
+    return n;
+}
+
+/*
+ * Notes how many of each message the rate limit left out, at most once a
+ * window, or for every message if all is set.
+ */
+void Logger::ReportSuppressed(bool all) {
+    long long nowUs = NowUs();
+
+    for (int i = 0; i < LOG_RATE_SLOTS; i++) {
+        LogRate& rate = rates[i];
+        if (rate.suppressed.load(std::memory_order_relaxed) == 0)
+            continue;
+        if (!all && nowUs - reportedUs[i] < rateWindowUs.load(std::memory_order_relaxed))
+            continue;
+
+        long long n = rate.suppressed.exchange(0);
+        reportedUs[i] = nowUs;
+
+        const char* last = lastLines + i * LOG_LAST_LINE_BYTES;
+        string text = (last[0] != '\0') ? string(last) : string("A message");
+        Write(rate.level.load(), nowUs, text + " (and " + std::to_string(n) + " more like it)");
+    }
+}
+
+void Logger::ReportDropped(void) {
+    long long n = dropped.load();
+    if (n == droppedReported)
+        return;
+
+    Write(LOG_LVL_WARN, NowUs(), "Log full, " + std::to_string(n - droppedReported) + " messages dropped.");
+    droppedReported = n;
+}
+
+/*
+ * Fills in the record's format into line.
+ */
+void Logger::Format(const LogRecord& rec) {
+    line->clear();
+
+    int arg = 0;
+    for (const char* c = rec.format; *c != '\0'; c++) {
+        if (c[0] != '{' || c[1] != '}' || arg >= rec.numArgs) {
+            line->push_back(*c);
+            continue;
+        }
+
+        const LogArg& a = rec.args[arg++];
+        char buf[32];
+        if (a.type == LOG_ARG_INT) {
+            snprintf(buf, sizeof(buf), "%lld", a.i);
+            line->append(buf);
+        }
+        else if (a.type == LOG_ARG_DOUBLE) {
+            snprintf(buf, sizeof(buf), "%g", a.d);
+            line->append(buf);
+        }
+        else {
+            line->append(rec.text + a.text);
+        }
+        c++;
+    }
+}
+
+/*
+ * Prints the message and appends it to the file, stamped with the local
+ * time and level.
+ */
+void Logger::Write(int level, long long timeUs, const string& text) {
+    written++;
+
+    if (echo)
+        std::cout << text << "\n";
+
+    if (file == NULL)
+        return;
+
+    time_t secs = (time_t)(timeUs / 1000000);
+    struct tm local;
+#ifdef _WIN32
+    localtime_s(&local, &secs);
+#else
+    localtime_r(&secs, &local);
+#endif
+
+    char stamp[64];
+    size_t len = strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+    snprintf(stamp + len, sizeof(stamp) - len, ".%06lld %s ", timeUs % 1000000, levelNames[level & 3]);
+
+    fputs(stamp, file);
+    fputs(text.c_str(), file);
+    fputc('\n', file);
+    fileBytes += strlen(stamp) + text.size() + 1;
+
+    if (fileBytes >= LOG_ROTATE_BYTES)
+        Rotate();
+}
+
+/*
+ * Moves the file to <path>.1, the one before that to <path>.2 and so on,
+ * dropping the oldest, and starts a new one.
+ */
+void Logger::Rotate(void) {
+    fclose(file);
+
+    for (int i = LOG_KEEP_FILES - 1; i >= 0; i--) {
+        string from = (i == 0) ? *path : *path + "." + std::to_string(i);
+        string to = *path + "." + std::to_string(i + 1);
+
+        // Renaming over an existing file fails on Windows
+        remove(to.c_str());
+        rename(from.c_str(), to.c_str());
+    }
+
+    file = fopen(path->c_str(), "wb");
+    fileBytes = 0;
+    rotations++;
+}
@@ -0,0 +1,132 @@
+/*
+ *  MappedFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::cout;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : data(NULL), size(0), fileHandle(INVALID_HANDLE_VALUE), mapHandle(NULL) {
+}
+
+int MappedFile::Open(const char* path) {
+    Close();
+
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        cout << "Unable to get the size of " << path << ".\n";
+        Close();
+        return -1;
+    }
+    size = (size_t)fileSize.QuadPart;
+
+    mapHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapHandle == NULL) {
+        cout << "Unable to map " << path << ".\n";
+        Close();
+        return -1;
+    }
+
+    data = (const uint8_t*)MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        cout << "Unable to map " << path << ".\n";
+        Close();
+        return -1;
+    }
+
+    return 0;
+}
+
+void MappedFile::Close(void) {
+    if (data != NULL)
+        UnmapViewOfFile(data);
+    if (mapHandle != NULL)
+        CloseHandle(mapHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+
+    data = NULL;
+    size = 0;
+    mapHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile() : data(NULL), size(0), fd(-1) {
+}
+
+int MappedFile::Open(const char* path) {
+    Close();
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        cout << "Unable to open " << path << ".\n";
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        cout << "Unable to get the size of " << path << ".\n";
+        Close();
+        return -1;
+    }
+    size = (size_t)st.st_size;
+
+    void* map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        cout << "Unable to map " << path << ".\n";
+        Close();
+        return -1;
+    }
+    data = (const uint8_t*)map;
+
+    return 0;
+}
+
+void MappedFile::Close(void) {
+    if (data != NULL)
+        munmap((void*)data, size);
+    if (fd >= 0)
+        close(fd);
+
+    data = NULL;
+    size = 0;
+    fd = -1;
+}
+
+#endif
+
+const uint8_t* MappedFile::GetData(void) const {
+    return data;
+}
+
+size_t MappedFile::GetSize(void) const {
+    return size;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
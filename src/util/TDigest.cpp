@@ -0,0 +1,194 @@
+/*
+ *  TDigest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "TDigest.h"
+#include <algorithm>
+#include <math.h>
+
+#define PI 3.14159265358979323846
+
+// Scale used to size the centroids, a little under the compression so
+// that a merge can never make more centroids than there is room for
+#define TDIGEST_SCALE (TDIGEST_COMPRESSION - 2)
+
+/*
+ * Arcsine scale: one unit of k holds fewer values near q = 0 and 1.
+ */
+static double ScaleK(double q) {
+    return TDIGEST_SCALE / (2 * PI) * asin(2 * q - 1);
+}
+
+static double ScaleQ(double k) {
+    if (k >= TDIGEST_SCALE / 4.0)
+        return 1;
+
+    return (sin(k * 2 * PI / TDIGEST_SCALE) + 1) / 2;
+}
+
+TDigest::TDigest() {
+    Clear();
+}
+
+void TDigest::Add(float value) {
+    if (count == 0 || value < min)
+        min = value;
+    if (count == 0 || value > max)
+        max = value;
+    count++;
+
+    buffer[numBuffered++] = value;
+    if (numBuffered == TDIGEST_BUFFER)
+        Compress(NULL, 0);
+}
+
+/*
+ * Adds everything that went into another digest to this one.
+ */
+void TDigest::Merge(const TDigest& other) {
+    if (other.count == 0)
+        return;
+
+    TDigestCentroid extra[TDIGEST_COMPRESSION + TDIGEST_BUFFER];
+    int numExtra = 0;
+    for (int i = 0; i < other.numCentroids; i++)
+        extra[numExtra++] = other.centroids[i];
+    for (int i = 0; i < other.numBuffered; i++) {
+        extra[numExtra].mean = other.buffer[i];
+        extra[numExtra++].weight = 1;
+    }
+
+    if (count == 0 || other.min < min)
+        min = other.min;
+    if (count == 0 || other.max > max)
+        max = other.max;
+    count += other.count;
+
+    Compress(extra, numExtra);
+}
+
+void TDigest::Clear(void) {
+    numCentroids = 0;
+    numBuffered = 0;
+    count = 0;
+    min = 0;
+    max = 0;
+}
+
+/*
+ * Estimate of the value below which a fraction q of the values fall, or
+ * NAN if nothing was added. Merges in the buffered values first.
+ */
+float TDigest::Quantile(double q) {
+    if (count == 0)
+        return NAN;
+    if (numBuffered > 0)
+        Compress(NULL, 0);
+
+    if (q <= 0)
+        return min;
+    if (q >= 1)
+        return max;
+
+    // Each centroid's mean is taken to sit at the middle of its weight,
+    // and values in between are interpolated
+    double target = q * count;
+    const TDigestCentroid& first = centroids[0];
+    if (target < first.weight / 2) {
+        if (first.weight == 1)
+            return first.mean;
+        return (float)(min + (first.mean - min) * target / (first.weight / 2));
+    }
+
+    double cumulative = first.weight / 2;
+    for (int i = 0; i < numCentroids - 1; i++) {
+        const TDigestCentroid& a = centroids[i];
+        const TDigestCentroid& b = centroids[i + 1];
+        double gap = (a.weight + b.weight) / 2;
+
+        if (target < cumulative + gap)
+            return (float)(a.mean + (b.mean - a.mean) * (target - cumulative) / gap);
+        cumulative += gap;
+    }
+
+    const TDigestCentroid& last = centroids[numCentroids - 1];
+    if (last.weight == 1)
+        return last.mean;
+    return (float)(last.mean + (max - last.mean) * (target - cumulative) / (last.weight / 2));
+}
+
+long long TDigest::GetCount(void) const {
+    return count;
+}
+
+float TDigest::GetMin(void) const {
+    return min;
+}
+
+float TDigest::GetMax(void) const {
+    return max;
+}
+
+/*
+ * Centroids in use, after merging in the buffered values.
+ */
+int TDigest::GetCentroids(void) {
+    if (numBuffered > 0)
+        Compress(NULL, 0);
+
+    return numCentroids;
+}
+
+/*
+ * Merges the buffered values and the extra centroids into the current
+ * ones, in one pass over all of them sorted by mean. Neighbours are
+ * combined for as long as the result stays within one unit of the scale.
+ */
+void TDigest::Compress(const TDigestCentroid* extra, int numExtra) {
+    TDigestCentroid all[TDIGEST_COMPRESSION + TDIGEST_BUFFER + TDIGEST_COMPRESSION + TDIGEST_BUFFER];
+    int n = 0;
+    double total = 0;
+
+    for (int i = 0; i < numCentroids; i++) {
+        all[n++] = centroids[i];
+        total += centroids[i].weight;
+    }
+    for (int i = 0; i < numBuffered; i++) {
+        all[n].mean = buffer[i];
+        all[n++].weight = 1;
+        total += 1;
+    }
+    for (int i = 0; i < numExtra; i++) {
+        all[n++] = extra[i];
+        total += extra[i].weight;
+    }
+    numBuffered = 0;
+
+    std::sort(all, all + n, [](const TDigestCentroid& a, const TDigestCentroid& b) {
+        return a.mean < b.mean;
+    });
+
+    numCentroids = 0;
+    TDigestCentroid cur = all[0];
+    double weightSoFar = 0;
+    double limit = total * ScaleQ(ScaleK(0) + 1);
+
+    for (int i = 1; i < n; i++) {
+        // The last slot takes whatever is left, which the scale should
+        // never let happen
+        if (weightSoFar + cur.weight + all[i].weight <= limit || numCentroids == TDIGEST_COMPRESSION - 1) {
+            cur.weight += all[i].weight;
+            cur.mean += (all[i].mean - cur.mean) * all[i].weight / cur.weight;
+        }
+        else {
+            centroids[numCentroids++] = cur;
+            weightSoFar += cur.weight;
+            limit = total * ScaleQ(ScaleK(weightSoFar / total) + 1);
+            cur = all[i];
+        }
+    }
+    centroids[numCentroids++] = cur;
+}
@@ -0,0 +1,183 @@
+/*
+ *  ThreadControl.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ThreadControl.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+using std::cout;
+using std::chrono::steady_clock;
+
+#ifdef _WIN32
+
+static int Place(HANDLE handle, const ThreadPlacement& placement) {
+    int err = 0;
+
+    if (placement.cpu != THREAD_ANY_CPU) {
+        if (SetThreadAffinityMask(handle, (DWORD_PTR)1 << placement.cpu) == 0) {
+            cout << "Unable to pin thread to CPU " << placement.cpu << ".\n";
+            err = -1;
+        }
+    }
+
+    // Windows has no real-time policies for threads, only priorities
+    int priority = THREAD_PRIORITY_NORMAL;
+    if (placement.policy == THREAD_SCHED_FIFO)
+        priority = THREAD_PRIORITY_TIME_CRITICAL;
+    else if (placement.policy == THREAD_SCHED_RR)
+        priority = THREAD_PRIORITY_HIGHEST;
+
+    if (priority != THREAD_PRIORITY_NORMAL && !SetThreadPriority(handle, priority)) {
+        cout << "Unable to raise thread priority.\n";
+        err = -1;
+    }
+
+    return err;
+}
+
+int PlaceThread(std::thread& t, const ThreadPlacement& placement) {
+    return Place((HANDLE)t.native_handle(), placement);
+}
+
+int PlaceThisThread(const ThreadPlacement& placement) {
+    return Place(GetCurrentThread(), placement);
+}
+
+int GetNumCpus(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+#else
+
+static int Place(pthread_t handle, const ThreadPlacement& placement) {
+    int err = 0;
+
+    if (placement.cpu != THREAD_ANY_CPU) {
+#ifdef __linux__
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(placement.cpu, &cpus);
+        if (pthread_setaffinity_np(handle, sizeof(cpus), &cpus) != 0) {
+            cout << "Unable to pin thread to CPU " << placement.cpu << ".\n";
+            err = -1;
+        }
+#else
+        cout << "Pinning threads is not supported.\n";
+        err = -1;
+#endif
+    }
+
+    if (placement.policy != THREAD_SCHED_NORMAL) {
+        int policy = (placement.policy == THREAD_SCHED_FIFO) ? SCHED_FIFO : SCHED_RR;
+        sched_param param;
+        param.sched_priority = placement.priority;
+        if (pthread_setschedparam(handle, policy, &param) != 0) {
+            cout << "Unable to set real-time scheduling, this needs root or CAP_SYS_NICE.\n";
+            err = -1;
+        }
+    }
+
+    return err;
+}
+
+int PlaceThread(std::thread& t, const ThreadPlacement& placement) {
+    return Place(t.native_handle(), placement);
+}
+
+int PlaceThisThread(const ThreadPlacement& placement) {
+    return Place(pthread_self(), placement);
+}
+
+int GetNumCpus(void) {
+    return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+#endif
+
+WakeupJitter::WakeupJitter() : wakeups(0), totalUs(0), maxUs(0) {
+    for (int i = 0; i < JITTER_BUCKETS; i++)
+        buckets[i] = 0;
+}
+
+/*
+ * Sleeps for ms milliseconds and records how much longer it took.
+ */
+void WakeupJitter::SleepFor(int ms) {
+    steady_clock::time_point wakeup = steady_clock::now() + std::chrono::milliseconds(ms);
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    Record(std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - wakeup).count());
+}
+
+/*
+ * Sleeps until the given time and records how late the thread woke up.
+ */
+void WakeupJitter::SleepUntil(steady_clock::time_point wakeup) {
+    std::this_thread::sleep_until(wakeup);
+    Record(std::chrono::duration_cast<std::chrono::microseconds>(steady_clock::now() - wakeup).count());
+}
+
+/*
+ * Records a wakeup that was lateUs microseconds later than asked for.
+ * Only one thread may record, but any thread can read the stats.
+ */
+void WakeupJitter::Record(long long lateUs) {
+    if (lateUs < 0)
+        lateUs = 0;
+
+    int bucket = 0;
+    while (bucket < JITTER_BUCKETS - 1 && (1LL << bucket) <= lateUs)
+        bucket++;
+
+    buckets[bucket]++;
+    totalUs += lateUs;
+    if (lateUs > maxUs)
+        maxUs.store(lateUs);
+    wakeups++;
+}
+
+long long WakeupJitter::GetWakeups(void) {
+    return wakeups;
+}
+
+double WakeupJitter::GetAvgUs(void) {
+    return (wakeups > 0) ? (double)totalUs / wakeups : 0;
+}
+
+long long WakeupJitter::GetMaxUs(void) {
+    return maxUs;
+}
+
+/*
+ * Delay that a fraction q of the wakeups were within, rounded up to a
+ * power of two microseconds but no more than the worst one.
+ */
+long long WakeupJitter::GetPercentileUs(double q) {
+    long long total = wakeups;
+    long long seen = 0;
+
+    for (int i = 0; i < JITTER_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen > 0 && seen >= q * total)
+            return (i == 0) ? 0 : ((1LL << i) < maxUs) ? (1LL << i) : (long long)maxUs;
+    }
+
+    return maxUs;
+}
+
+void WakeupJitter::PrintReport(const char* name) {
+    cout << name << " wakeups: " << GetWakeups() << ", late by " << GetAvgUs() << " us on average, "
+         << GetPercentileUs(0.99) << " us p99, " << GetMaxUs() << " us max\n";
+}
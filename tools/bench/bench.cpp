@@ -0,0 +1,957 @@
+/*
+ *  bench.cpp
+ *
+ *  Microbenchmarks for the tracker hot paths. Each benchmark reports the
+ *  time, number of heap allocations and throughput of one operation, at
+ *  crowd sizes from 1 to 500 people for the per frame benchmarks.
+ *
+ *  Results are printed as a table and written as JSON lines to the file
+ *  given as the first argument (bench_results.json by default) so that
+ *  runs from different releases can be compared.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "Tracker.h"
+#include "Centroid.h"
+#include "Kalman.h"
+#include "StateCentroid.h"
+#include "IoU.h"
+#include "FixedStateCentroid.h"
+#include "ConfigStore.h"
+#include "Appearance.h"
+#include "ImagePipeline.h"
+#include "Heatmap.h"
+#include "TrackFit.h"
+#include "Trajectories.h"
+#include "TrackStats.h"
+#include "CountStore.h"
+#include "Logger.h"
+#include "../common/AllocCount.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Minimum time to run each benchmark for
+#define MIN_BENCH_MS 200
+
+// Number of distinct frames played back by the per frame benchmarks
+#define NUM_FRAMES 64
+
+using namespace Spinnaker;
+
+using std::vector;
+using std::string;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+/******************************* Harness *******************************/
+
+struct BenchResult {
+    string name;
+    string tracker;
+    int crowd;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double opsPerSec;
+};
+
+// Results are accumulated here so the optimizer can't remove the work
+static volatile double sink;
+
+static vector<BenchResult> results;
+
+static void AddResult(const char* name, const char* tracker, int crowd, long long iterations, double ns,
+                      long long allocs) {
+    BenchResult res;
+    res.name = name;
+    res.tracker = tracker;
+    res.crowd = crowd;
+    res.iterations = iterations;
+    res.nsPerOp = ns / iterations;
+    res.allocsPerOp = (double)allocs / iterations;
+    res.opsPerSec = 1e9 / res.nsPerOp;
+    results.push_back(res);
+
+    printf("%-24s %-14s %5d %14.1f %10.2f %14.0f\n", name, tracker, crowd,
+           res.nsPerOp, res.allocsPerOp, res.opsPerSec);
+}
+
+/*
+ * Runs fn(iterations), increasing the number of iterations until the run
+ * takes at least MIN_BENCH_MS, and records the cost of one iteration.
+ */
+template <class F>
+static void RunBench(const char* name, const char* tracker, int crowd, F fn) {
+    long long iterations = 1;
+
+    while (true) {
+        long long allocStart = allocCount;
+        steady_clock::time_point start = steady_clock::now();
+        fn(iterations);
+        double ns = duration<double, std::nano>(steady_clock::now() - start).count();
+        long long allocs = allocCount - allocStart;
+
+        if (ns >= MIN_BENCH_MS * 1e6) {
+            AddResult(name, tracker, crowd, iterations, ns, allocs);
+            return;
+        }
+
+        iterations *= (ns < MIN_BENCH_MS * 1e5) ? 10 : 2;
+    }
+}
+
+/*
+ * Runs fn(thread, batch) on each of the threads at once, over and over
+ * until each has spent at least MIN_BENCH_MS in it, and records the
+ * average cost of one iteration on a thread. before() and after() are
+ * called around each round and aren't timed.
+ */
+template <class F, class B, class A>
+static void RunThreadBench(const char* name, int threads, long long batch, F fn, B before, A after) {
+    long long iterations = 0;
+    double ns = 0;
+    long long allocs = 0;
+
+    while (ns < MIN_BENCH_MS * 1e6 * threads) {
+        std::atomic<int> ready(0);
+        std::atomic<long long> roundNs(0);
+        long long allocStart = 0;
+        vector<std::thread> pool;
+
+        before();
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&, t] {
+                // The last one in has seen all the threads made
+                if (++ready == threads)
+                    allocStart = allocCount;
+                while (ready < threads)
+                    ;
+
+                steady_clock::time_point start = steady_clock::now();
+                fn(t, batch);
+                roundNs += (long long)duration<double, std::nano>(steady_clock::now() - start).count();
+            });
+        }
+        for (auto& th : pool)
+            th.join();
+        after();
+
+        allocs += allocCount - allocStart;
+        ns += roundNs;
+        iterations += batch * threads;
+    }
+
+    AddResult(name, "-", threads, iterations, ns, allocs);
+}
+
+static void WriteResults(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("Unable to open %s.\n", path);
+        return;
+    }
+
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        fprintf(f, "{\"bench\":\"%s\",\"tracker\":\"%s\",\"crowd\":%d,\"iterations\":%lld,"
+                   "\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f,\"ops_per_sec\":%.1f}\n",
+                it->name.c_str(), it->tracker.c_str(), it->crowd, it->iterations,
+                it->nsPerOp, it->allocsPerOp, it->opsPerSec);
+    }
+
+    fclose(f);
+}
+
+/***************************** Test Data *****************************/
+
+static InferenceBoundingBox MakeBox(int x, int y, int width, int height) {
+    InferenceBoundingBox box;
+    memset(&box, 0, sizeof(box));
+    box.boxType = INFERENCE_BOX_TYPE_RECTANGLE;
+    box.classId = PERSON_ID;
+    box.confidence = 0.9f;
+    box.rect.topLeftXCoord = (int16_t)x;
+    box.rect.topLeftYCoord = (int16_t)y;
+    box.rect.bottomRightXCoord = (int16_t)(x + width);
+    box.rect.bottomRightYCoord = (int16_t)(y + height);
+    return box;
+}
+
+/*
+ * Makes NUM_FRAMES frames of a crowd of the given size, spread evenly
+ * over the frame and walking in both directions at walking speed.
+ */
+static vector<vector<InferenceBoundingBox>> MakeCrowd(int crowd) {
+    vector<vector<InferenceBoundingBox>> frames(NUM_FRAMES);
+    int width = 80;
+    int height = 240;
+
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        for (int i = 0; i < crowd; i++) {
+            double speed = (i % 2) ? 0.2 : -0.2;
+            int x0 = (int)((long long)i * (CAM_X - width) / crowd);
+            int x = (int)(x0 + speed * f * INFERENCE_TIME) % (CAM_X - width);
+            if (x < 0)
+                x += CAM_X - width;
+            int y = (i * 37) % (CAM_Y - height);
+
+            frames[f].push_back(MakeBox(x, y, width, height));
+        }
+    }
+
+    return frames;
+}
+
+/************************** Private Accessors **************************/
+
+class TrackerBench {
+    public:
+        static double MakeStateVector(StateCentroid* tr, InferenceBoundingBox box) {
+            double out[4];
+            tr->MakeStateVector(box, out);
+            return out[0];
+        }
+
+        static double MakeStateVector(FixedStateCentroid* tr, InferenceBoundingBox box) {
+            int32_t out[4];
+            tr->MakeStateVector(box, out);
+            return out[0];
+        }
+
+        static double MakeStateVector(Kalman* tr, InferenceBoundingBox box) {
+            double out[4];
+            tr->MakeStateVector(box, out);
+            return out[0];
+        }
+
+        static double Predict(Kalman* tr) {
+            double out[4];
+            tr->Predict(out);
+            return out[0];
+        }
+
+        static void Update(Kalman* tr, const double* obs) {
+            double obsCov[][4] = { {1, 0, 0, 0},
+                                   {0, 1, 0, 0},
+                                   {0, 0, 10, 0},
+                                   {0, 0, 0, 2} };
+            tr->Update(obs, obsCov);
+        }
+
+        static double MatInverse(Kalman* tr, double mat[4][4]) {
+            tr->matInverse(mat);
+            return mat[0][0];
+        }
+};
+
+/***************************** Benchmarks *****************************/
+
+template <class T>
+static void BenchIsBoxMatch(const char* tracker) {
+    InferenceBoundingBox start = MakeBox(600, 300, 80, 240);
+    InferenceBoundingBox next = MakeBox(630, 300, 80, 240);
+    T tr(start);
+    TrackerConfig cfg;
+
+    RunBench("isBoxMatch", tracker, 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + tr.isBoxMatch(next, cfg);
+    });
+}
+
+static void BenchStateVector(void) {
+    InferenceBoundingBox start = MakeBox(600, 300, 80, 240);
+    InferenceBoundingBox next = MakeBox(630, 300, 80, 240);
+    StateCentroid sc(start);
+    FixedStateCentroid fsc(start);
+    Kalman k(start);
+
+    RunBench("MakeStateVector", "StateCentroid", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + TrackerBench::MakeStateVector(&sc, next);
+    });
+
+    RunBench("MakeStateVector", "FixedState", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + TrackerBench::MakeStateVector(&fsc, next);
+    });
+
+    RunBench("MakeStateVector", "Kalman", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + TrackerBench::MakeStateVector(&k, next);
+    });
+}
+
+static void BenchKalman(void) {
+    InferenceBoundingBox start = MakeBox(600, 300, 80, 240);
+    InferenceBoundingBox next = MakeBox(630, 300, 80, 240);
+
+    RunBench("Kalman::Predict", "Kalman", 1, [&](long long n) {
+        Kalman k(start);
+        for (long long i = 0; i < n; i++)
+            sink = sink + TrackerBench::Predict(&k);
+    });
+
+    RunBench("Kalman::Update", "Kalman", 1, [&](long long n) {
+        Kalman k(start);
+        double obs[4] = { 615, 420, 0.2, 253 };
+        for (long long i = 0; i < n; i++)
+            TrackerBench::Update(&k, obs);
+        sink = sink + TrackerBench::MakeStateVector(&k, next);
+    });
+
+    RunBench("Kalman::matInverse", "Kalman", 1, [&](long long n) {
+        Kalman k(start);
+        double mat[4][4];
+        for (long long i = 0; i < n; i++) {
+            double src[4][4] = { {2, 0, 40, 0},
+                                 {0, 2, 0, 0},
+                                 {40, 0, 30, 0},
+                                 {0, 0, 0, 6} };
+            memcpy(mat, src, sizeof(mat));
+            sink = sink + TrackerBench::MatInverse(&k, mat);
+        }
+    });
+}
+
+/*
+ * Overhead of reading the thresholds from the current config snapshot
+ * instead of having them compiled in: the snapshot is acquired once per
+ * frame, then the StateCentroid match test is run on a frame's worth of
+ * state differences with constants and with the snapshot values.
+ */
+static void BenchConfig(void) {
+    ConfigStore store;
+    const int crowd = 50;
+    vector<double> diffs;
+    for (int i = 0; i < crowd * crowd; i++) {
+        diffs.push_back((i * 37) % 400);
+        diffs.push_back((i * 11) % 40);
+        diffs.push_back((i % 7) * 0.7);
+        diffs.push_back((i * 13) % 200);
+    }
+
+    RunBench("ConfigStore::Acquire", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            const TrackerConfig* cfg = store.Acquire();
+            sink = sink + cfg->missingThresh;
+            store.Release();
+        }
+    });
+
+    RunBench("thresholds/constant", "StateCentroid", crowd, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            int matches = 0;
+            for (size_t j = 0; j < diffs.size(); j += 4) {
+                matches += !(diffs[j] > DIST_X_THRESH && diffs[j + 1] > DIST_Y_THRESH &&
+                             diffs[j + 2] > VEL_X_THRESH && diffs[j + 3] > BOX_SIZE_THRESH);
+            }
+            sink = sink + matches;
+        }
+    });
+
+    RunBench("thresholds/config", "StateCentroid", crowd, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            const TrackerConfig& cfg = *store.Acquire();
+            int matches = 0;
+            for (size_t j = 0; j < diffs.size(); j += 4) {
+                matches += !(diffs[j] > cfg.distXThresh && diffs[j + 1] > cfg.distYThresh &&
+                             diffs[j + 2] > cfg.velXThresh && diffs[j + 3] > cfg.boxSizeThresh);
+            }
+            store.Release();
+            sink = sink + matches;
+        }
+    });
+}
+
+/*
+ * Cost of the appearance signatures used for re-identification, on a
+ * random Bayer frame the size of the camera's.
+ */
+static void BenchSignature(void) {
+    vector<uint8_t> pixels(CAM_X * CAM_Y);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (uint8_t)((i * 2654435761u) >> 24);
+
+    ImageView img;
+    img.data = &pixels[0];
+    img.width = CAM_X;
+    img.height = CAM_Y;
+    img.stride = CAM_X;
+    img.format = PixelFormat_BayerRG8;
+
+    InferenceBoundingBox box = MakeBox(CAM_X / 2, CAM_Y / 2, 120, 360);
+    Signature a;
+    Signature b;
+    ComputeSignature(img, box, a);
+    ComputeSignature(img, MakeBox(CAM_X / 3, CAM_Y / 2, 120, 360), b);
+
+    RunBench("ComputeSignature", "-", 1, [&](long long n) {
+        Signature sig;
+        for (long long i = 0; i < n; i++) {
+            ComputeSignature(img, box, sig);
+            sink = sink + sig.bins[i % SIG_BINS];
+        }
+    });
+
+    RunBench("SignatureDistance", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            a.bins[0] = (uint8_t)i;
+            sink = sink + SignatureDistance(a, b);
+        }
+    });
+}
+
+/*
+ * Image work that reads every pixel, standing in for a real consumer.
+ */
+class PixelSum : public ImageConsumer {
+    public:
+        void ProcessImage(const ImageView& img, uint64_t /* frameId */, int /* worker */) {
+            long long sum = 0;
+            for (int y = 0; y < img.height; y++) {
+                const uint8_t* row = img.data + (size_t)y * img.stride;
+                for (int x = 0; x < img.width; x++)
+                    sum += row[x];
+            }
+            sink = sink + sum;
+        }
+};
+
+/*
+ * Stands in for a camera buffer, which the frame in the benchmark never
+ * gives back.
+ */
+class StaticHold : public ImageHold {
+    public:
+        void Release(void) {}
+};
+
+/*
+ * Cost to the acquisition thread of one frame with and without the image
+ * pipeline: publishing the boxes, then handing the image over to workers
+ * that are kept busy by a full frame of work per image. Boxes are
+ * published first either way, so the pipeline only adds the handover,
+ * which copies the image unless it is handed over held.
+ */
+static void BenchImagePipeline(void) {
+    const int width = 1440;
+    const int height = 1080;
+    vector<uint8_t> pixels(width * height);
+    for (size_t i = 0; i < pixels.size(); i++)
+        pixels[i] = (uint8_t)i;
+
+    ImageView img;
+    img.data = &pixels[0];
+    img.width = width;
+    img.height = height;
+    img.stride = width;
+    img.format = PixelFormat_BayerRG8;
+
+    vector<InferenceBoundingBox> frame = MakeCrowd(5)[0];
+    vector<InferenceBoundingBox> published;
+    std::mutex bufferMutex;
+
+    RunBench("acquisition/boxes", "-", 5, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            bufferMutex.lock();
+            published = frame;
+            bufferMutex.unlock();
+        }
+        sink = sink + published.size();
+    });
+
+    PixelSum sum;
+    ImagePipeline pipeline;
+    pipeline.AddConsumer(&sum);
+    pipeline.Start();
+
+    RunBench("acquisition/boxes+image", "-", 5, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            bufferMutex.lock();
+            published = frame;
+            bufferMutex.unlock();
+            pipeline.Submit(img, i);
+        }
+        sink = sink + published.size();
+    });
+
+    pipeline.Stop();
+    printf("%-24s %lld of %lld images dropped, submit avg %.1f us, max %.1f us\n", "",
+           pipeline.GetDropped(), pipeline.GetSubmitted(), pipeline.GetAvgSubmitUs(), pipeline.GetMaxSubmitUs());
+
+    StaticHold hold;
+    ImagePipeline heldPipeline;
+    heldPipeline.AddConsumer(&sum);
+    heldPipeline.Start();
+
+    RunBench("acquisition/boxes+held", "-", 5, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            bufferMutex.lock();
+            published = frame;
+            bufferMutex.unlock();
+            heldPipeline.Submit(img, i, &hold);
+        }
+        sink = sink + published.size();
+    });
+
+    heldPipeline.Stop();
+    printf("%-24s %lld of %lld images dropped, submit avg %.1f us, max %.1f us\n", "",
+           heldPipeline.GetDropped(), heldPipeline.GetSubmitted(), heldPipeline.GetAvgSubmitUs(),
+           heldPipeline.GetMaxSubmitUs());
+}
+
+/*
+ * Cost of adding a frame's footprints to the heatmap, which should not
+ * depend on how long it has been running, and of taking a snapshot.
+ */
+static void BenchHeatmap(void) {
+    const int crowds[] = { 1, 10, 100, 500 };
+    Heatmap heatmap;
+    long long nowMs = 0;
+
+    for (int c : crowds) {
+        vector<vector<InferenceBoundingBox>> frames = MakeCrowd(c);
+        RunBench("Heatmap/frame", "-", c, [&](long long n) {
+            for (long long i = 0; i < n; i++) {
+                heatmap.BeginFrame(nowMs);
+                nowMs += INFERENCE_TIME;
+
+                vector<InferenceBoundingBox>& frame = frames[i % NUM_FRAMES];
+                for (auto box = frame.begin(); box != frame.end(); ++box)
+                    heatmap.AddBox(*box);
+            }
+        });
+    }
+
+    RunBench("Heatmap::TakeSnapshot", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            heatmap.TakeSnapshot();
+    });
+}
+
+/*
+ * Cost of keeping a track's trajectory fit up to date, once per frame it
+ * is matched, and of asking it for the direction.
+ */
+static void BenchTrackFit(void) {
+    TrackFit fit;
+    vector<vector<InferenceBoundingBox>> frames = MakeCrowd(1);
+
+    RunBench("TrackFit::Add", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            InferenceBoundingBox& box = frames[i % NUM_FRAMES][0];
+            fit.Add((box.rect.topLeftXCoord + box.rect.bottomRightXCoord) / 2, box.confidence);
+            fit.Tick();
+        }
+        sink = sink + fit.GetPoints();
+    });
+
+    RunBench("TrackFit::GetDir", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + fit.GetDir();
+    });
+}
+
+/*
+ * Cost of adding a point to a path with room in it, and to a full one,
+ * which has to be simplified first.
+ */
+static void BenchTrajectories(void) {
+    Trajectories paths(1);
+    vector<vector<InferenceBoundingBox>> frames = MakeCrowd(1);
+    long long nowMs = 0;
+    int slot = paths.Start(0, nowMs);
+
+    // A new path is started before the old one fills up
+    RunBench("Trajectories::Add", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            if (paths.Get(slot)->head.numPoints == TRAJ_POINTS) {
+                paths.End(slot, LEFT);
+                slot = paths.Start(0, nowMs);
+            }
+            paths.Add(slot, frames[i % NUM_FRAMES][0], nowMs);
+            nowMs += INFERENCE_TIME;
+        }
+    });
+
+    RunBench("Trajectories::Add/full", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            paths.Add(slot, frames[i % NUM_FRAMES][0], nowMs);
+            nowMs += INFERENCE_TIME;
+        }
+    });
+}
+
+/*
+ * Cost of adding a value to a digest, of rolling a day of hourly digests
+ * up into one and of reading a percentile, and the memory a camera's
+ * stats take per day.
+ */
+static void BenchTrackStats(void) {
+    TDigest digest;
+    unsigned seed = 1;
+
+    RunBench("TDigest::Add", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            seed = seed * 1103515245 + 12345;
+            digest.Add((float)(seed >> 16) / 65536 * 200);
+        }
+    });
+
+    vector<TDigest> hours(24);
+    for (size_t h = 0; h < hours.size(); h++) {
+        for (int i = 0; i < 1000; i++) {
+            seed = seed * 1103515245 + 12345;
+            hours[h].Add((float)(seed >> 16) / 65536 * 200);
+        }
+    }
+
+    RunBench("TDigest::Merge/day", "-", 24, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            TDigest day;
+            for (size_t h = 0; h < hours.size(); h++)
+                day.Merge(hours[h]);
+            sink = sink + day.GetCount();
+        }
+    });
+
+    RunBench("TDigest::Quantile", "-", 1, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            sink = sink + digest.Quantile((i % 99 + 1) / 100.0);
+    });
+
+    TrackStats stats;
+    printf("%-24s %zu bytes per bucket, %zu KB per camera per day of hourly buckets, %d centroids\n", "",
+           sizeof(StatsBucket), 24 * sizeof(StatsBucket) / 1024, digest.GetCentroids());
+}
+
+/*
+ * Writes five years of per minute counts to a store, busier by day than
+ * by night, and reports how fast they went in, the bytes per sample and
+ * the cost of totalling a day, a month, a year and the whole five years.
+ * The ranges start and end mid block, so every query decodes two blocks.
+ */
+static void BenchCountStore(void) {
+    const char* path = "bench_counts.hkcs";
+    const long long startMs = 1609459200000LL; // Jan 1, 2021
+    const long long minuteMs = 60 * 1000;
+    const long long dayMs = 24 * 60 * minuteMs;
+    const long long numSamples = 5 * 365 * 24 * 60;
+
+    remove(path);
+    CountStore store;
+    if (store.Open(path))
+        return;
+
+    unsigned seed = 1;
+    long long expectedIn = 0;
+    int count = 0;
+
+    steady_clock::time_point start = steady_clock::now();
+    for (long long i = 0; i < numSamples; i++) {
+        int hour = (int)(i / 60 % 24);
+        int busy = (hour >= 7 && hour < 19) ? 8 : 1;
+
+        CountSample sample;
+        sample.tMs = startMs + i * minuteMs;
+        seed = seed * 1103515245 + 12345;
+        sample.in = (seed >> 16) % busy;
+        seed = seed * 1103515245 + 12345;
+        sample.out = (seed >> 16) % busy;
+        count = std::max(0, count + sample.in - sample.out);
+        sample.count = count;
+        expectedIn += sample.in;
+
+        store.Append(sample);
+    }
+    store.Close();
+    double ingestS = duration<double>(steady_clock::now() - start).count();
+
+    start = steady_clock::now();
+    store.Open(path);
+    double openMs = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    CountTotals totals;
+    store.Query(startMs, startMs + numSamples * minuteMs, &totals);
+    printf("%-24s %lld samples in %.2f s (%.0f per s), %.2f bytes per sample, %d blocks, opened in %.1f ms, "
+           "%s\n", "", numSamples, ingestS, numSamples / ingestS, (double)store.GetBytes() / numSamples,
+           store.GetBlocks(), openMs, (totals.in == expectedIn) ? "totals match" : "TOTALS DIFFER");
+
+    const struct {
+        const char* name;
+        long long spanMs;
+    } ranges[] = {
+        { "CountStore::Query/day", dayMs },
+        { "CountStore::Query/month", 30 * dayMs },
+        { "CountStore::Query/year", 365 * dayMs },
+        { "CountStore::Query/5y", 5 * 365 * dayMs - 2 * dayMs },
+    };
+
+    for (auto& r : ranges) {
+        long long decodedStart = store.GetBlocksDecoded();
+        long long queries = 0;
+
+        RunBench(r.name, "-", 1, [&](long long n) {
+            for (long long i = 0; i < n; i++) {
+                long long fromMs = startMs + dayMs / 2 + (i * 7919 * minuteMs) % (5 * 365 * dayMs - r.spanMs - dayMs);
+                store.Query(fromMs, fromMs + r.spanMs, &totals);
+                sink = sink + totals.in;
+            }
+            queries += n;
+        });
+
+        printf("%-24s %.1f blocks decoded per query\n", "",
+               (double)(store.GetBlocksDecoded() - decodedStart) / queries);
+    }
+
+    store.Close();
+    remove(path);
+}
+
+/*
+ * Sends stdout, and so cout, to the null device, returning a handle to
+ * put it back with.
+ */
+static int HideStdout(void) {
+    fflush(stdout);
+#ifdef _WIN32
+    int saved = _dup(_fileno(stdout));
+    int null = _open(NULL_DEVICE, _O_WRONLY);
+    _dup2(null, _fileno(stdout));
+    _close(null);
+#else
+    int saved = dup(fileno(stdout));
+    int null = open(NULL_DEVICE, O_WRONLY);
+    dup2(null, fileno(stdout));
+    close(null);
+#endif
+    return saved;
+}
+
+static void RestoreStdout(int saved) {
+    std::cout.flush();
+    fflush(stdout);
+#ifdef _WIN32
+    _dup2(saved, _fileno(stdout));
+    _close(saved);
+#else
+    dup2(saved, fileno(stdout));
+    close(saved);
+#endif
+}
+
+/*
+ * Cost of a message from the acquisition thread when a camera only sends
+ * incomplete images, through the Logger and through cout, from one
+ * thread and from four at once. cout is sent to the null device, so only
+ * the stream is measured. The Logger's writer empties the ring between
+ * rounds, which isn't timed, so every message finds room; a repeated
+ * message past the rate limit is only counted.
+ */
+static void BenchLogger(void) {
+    Logger log;
+    log.SetEcho(false);
+    log.Start();
+
+    for (int threads = 1; threads <= 4; threads *= 4) {
+        log.SetRateLimit(INT_MAX, LOG_RATE_WINDOW_MS);
+        RunThreadBench("Logger::Log", threads, LOG_RING_RECORDS / 2 / threads, [&](int /* t */, long long n) {
+            for (long long i = 0; i < n; i++)
+                log.Warn("Image is incomplete: {}, frame {}.", "Missing packets", i);
+        }, [&]() {
+        }, [&]() {
+            log.Flush();
+        });
+
+        log.SetRateLimit(LOG_RATE_BURST, LOG_RATE_WINDOW_MS);
+        RunThreadBench("Logger::Log/limited", threads, 100000, [&](int /* t */, long long n) {
+            for (long long i = 0; i < n; i++)
+                log.Warn("Image is incomplete: {}, frame {}.", "Missing packets", i);
+        }, [&]() {
+        }, [&]() {
+            log.Flush();
+        });
+
+        int saved = -1;
+        RunThreadBench("cout", threads, 10000, [&](int /* t */, long long n) {
+            for (long long i = 0; i < n; i++)
+                std::cout << "Image is incomplete: " << "Missing packets" << ", frame " << i << ".\n";
+        }, [&]() {
+            saved = HideStdout();
+        }, [&]() {
+            RestoreStdout(saved);
+        });
+    }
+
+    log.Stop();
+    printf("%-24s %lld logged, %lld dropped, %lld left out by the rate limit\n", "", log.GetLogged(),
+           log.GetDropped(), log.GetSuppressed());
+}
+
+/*
+ * Cost of the IoU matrix between n boxes and n tracks, and of the whole
+ * frame association built on it. Every box overlaps only its neighbours,
+ * so most groups of tracks hit the early cutoff.
+ */
+static void BenchIoUMatrix(void) {
+    const int sizes[] = { 10, 20, 50, 100, 200 };
+
+    for (int n : sizes) {
+        vector<vector<InferenceBoundingBox>> frames = MakeCrowd(n);
+        vector<IoU*> trackers;
+        for (auto it = frames[0].begin(); it != frames[0].end(); ++it)
+            trackers.push_back(new IoU(*it));
+
+        int stride = IOU_PAD(n);
+        vector<int16_t> boxes(4 * n);
+        vector<int16_t> tracks(4 * stride, 0);
+        vector<int32_t> areas(stride, 0);
+        vector<float> iou((size_t)n * stride);
+        for (int i = 0; i < n; i++) {
+            const InferenceBoundingBox& b = frames[1][i];
+            boxes[4 * i] = b.rect.topLeftXCoord;
+            boxes[4 * i + 1] = b.rect.topLeftYCoord;
+            boxes[4 * i + 2] = b.rect.bottomRightXCoord;
+            boxes[4 * i + 3] = b.rect.bottomRightYCoord;
+
+            int16_t pred[4];
+            trackers[i]->getPredictedBox(pred);
+            for (int k = 0; k < 4; k++)
+                tracks[k * stride + i] = pred[k];
+            areas[i] = (pred[2] - pred[0]) * (pred[3] - pred[1]);
+        }
+
+        RunBench("IoUMatrix", "IoU", n, [&](long long iters) {
+            for (long long i = 0; i < iters; i++) {
+                IoUMatrix(&boxes[0], n, &tracks[0], &areas[0], stride, &iou[0]);
+                sink = sink + iou[i % iou.size()];
+            }
+        });
+
+        TrackerConfig cfg;
+        vector<int> matches;
+        RunBench("IoU::matchFrame", "IoU", n, [&](long long iters) {
+            for (long long i = 0; i < iters; i++) {
+                IoU::matchFrame(frames[1 + i % (NUM_FRAMES - 1)], trackers, cfg, matches);
+                sink = sink + matches[0];
+            }
+        });
+
+        for (auto it = trackers.begin(); it != trackers.end(); ++it)
+            delete *it;
+    }
+}
+
+/*
+ * Cost per frame of comparing every box in the frame against every
+ * tracker, which is the worst case of the association loop.
+ */
+template <class T>
+static void BenchMatchFrame(const char* tracker, int crowd) {
+    vector<vector<InferenceBoundingBox>> frames = MakeCrowd(crowd);
+    vector<T*> trackers;
+    TrackerConfig cfg;
+    for (auto it = frames[0].begin(); it != frames[0].end(); ++it)
+        trackers.push_back(new T(*it));
+
+    RunBench("isBoxMatch/frame", tracker, crowd, [&](long long n) {
+        for (long long i = 0; i < n; i++) {
+            vector<InferenceBoundingBox>& frame = frames[1 + i % (NUM_FRAMES - 1)];
+            int matches = 0;
+            for (auto box = frame.begin(); box != frame.end(); ++box) {
+                for (auto tr = trackers.begin(); tr != trackers.end(); ++tr)
+                    matches += (*tr)->isBoxMatch(*box, cfg);
+            }
+            sink = sink + matches;
+        }
+    });
+
+    for (auto it = trackers.begin(); it != trackers.end(); ++it)
+        delete *it;
+}
+
+/*
+ * Cost of one iteration of the StartPeopleCounter loop body.
+ */
+template <class T>
+static void BenchProcessFrame(const char* tracker, int crowd) {
+    vector<vector<InferenceBoundingBox>> frames = MakeCrowd(crowd);
+    PeopleCounter<T>* cntr = new PeopleCounter<T>((BoxSource*)NULL);
+
+    // Let the number of trackers settle before timing
+    for (int f = 0; f < NUM_FRAMES; f++)
+        cntr->ProcessFrame(frames[f]);
+
+    RunBench("ProcessFrame", tracker, crowd, [&](long long n) {
+        for (long long i = 0; i < n; i++)
+            cntr->ProcessFrame(frames[i % NUM_FRAMES]);
+        sink = sink + cntr->GetPeopleCount();
+    });
+
+    delete cntr;
+}
+
+template <class T>
+static void BenchCrowds(const char* tracker) {
+    const int crowds[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500 };
+
+    for (int c : crowds)
+        BenchMatchFrame<T>(tracker, c);
+    for (int c : crowds)
+        BenchProcessFrame<T>(tracker, c);
+}
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : "bench_results.json";
+
+    printf("%-24s %-14s %5s %14s %10s %14s\n", "benchmark", "tracker", "crowd",
+           "ns/op", "allocs/op", "ops/s");
+
+    BenchIsBoxMatch<Centroid>("Centroid");
+    BenchIsBoxMatch<StateCentroid>("StateCentroid");
+    BenchIsBoxMatch<FixedStateCentroid>("FixedState");
+    BenchIsBoxMatch<Kalman>("Kalman");
+    BenchIsBoxMatch<IoU>("IoU");
+    BenchStateVector();
+    BenchKalman();
+    BenchConfig();
+    BenchSignature();
+    BenchImagePipeline();
+    BenchHeatmap();
+    BenchTrackFit();
+    BenchTrajectories();
+    BenchTrackStats();
+    BenchCountStore();
+    BenchLogger();
+    BenchIoUMatrix();
+
+    BenchCrowds<Centroid>("Centroid");
+    BenchCrowds<StateCentroid>("StateCentroid");
+    BenchCrowds<FixedStateCentroid>("FixedState");
+    BenchCrowds<Kalman>("Kalman");
+    BenchCrowds<IoU>("IoU");
+
+    WriteResults(path);
+    return 0;
+}
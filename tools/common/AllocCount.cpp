@@ -0,0 +1,94 @@
+/*
+ *  AllocCount.cpp
+ *
+ *  Global new and delete that count allocations, shared by bench and eval.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "AllocCount.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+std::atomic<long long> allocCount(0);
+
+void* operator new(size_t size) {
+    allocCount++;
+    void* p = malloc(size ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+// GCC sees the free once a delete is inlined, and takes it for a mismatch
+// with the new, which it can't see into
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept {
+    free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// Types aligned past what malloc guarantees, like the queue counters kept
+// on their own cache lines
+void* operator new(size_t size, std::align_val_t align) {
+    allocCount++;
+    size_t alignment = (size_t)align;
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, alignment);
+#else
+    void* p = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void operator delete[](void* p, std::align_val_t align) noexcept {
+    operator delete(p, align);
+}
+
+void operator delete(void* p, size_t, std::align_val_t align) noexcept {
+    operator delete(p, align);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t align) noexcept {
+    operator delete(p, align);
+}
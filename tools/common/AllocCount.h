@@ -0,0 +1,16 @@
+#pragma once
+/*
+ *  AllocCount.h
+ *
+ *  Replaces the global new and delete for the tools that link in
+ *  AllocCount.cpp, counting every allocation so the hot paths can be
+ *  checked for heap use.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include <atomic>
+
+// Number of calls to any form of operator new since the program started
+extern std::atomic<long long> allocCount;
@@ -0,0 +1,786 @@
+/*
+ *  eval.cpp
+ *
+ *  Evaluation harness that replays box streams with ground truth through
+ *  PeopleCounter<T> for every tracker, and reports counting accuracy
+ *  (count error, ID switches, MOTA, IDF1) alongside the processing speed
+ *  (frames per second and 99th percentile latency per frame). Every
+ *  tracker is run with and without re-identification of people who were
+ *  hidden for a while, and with and without tentative tracks, reporting
+ *  the trackers made, heap allocations per frame and people counted by
+ *  trackers that never followed a real person. Each tracker is also run
+ *  with everything on and its memory taken from an arena. People counted
+ *  going the other way to the person their tracker followed most are
+ *  reported separately, since they cost twice what a missed crossing does.
+ *
+ *  The fixed point StateCentroid must count exactly the same as the
+ *  double precision one; eval fails if it doesn't on any stream.
+ *
+ *  Each synthetic scenario is also played twice through a SimCam on a
+ *  simulated clock, with every time dependent feature on, and eval fails
+ *  if the two runs count differently. The busy and noisy scenarios are
+ *  also seen by two cameras whose views overlap, with skewed clocks, and
+ *  eval fails if merging their crossings with CrossingFusion gets no
+ *  closer to the real count than adding the two cameras up. The busy one
+ *  is seen once more with the second camera going silent halfway, and
+ *  eval also fails if that leaves crossings the fusion never counts. The
+ *  busy scenario is replayed once more with the camera stalling and dropping
+ *  out, and eval fails if the watchdog doesn't bring it back every time.
+ *
+ *  Usage: eval [--json results.json] [--save dir] [stream.hkbx ...]
+ *
+ *  The built in synthetic scenarios are always run. Recorded streams
+ *  given on the command line are run after them, and --save writes the
+ *  synthetic scenarios out as streams so they can be replayed elsewhere.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "Tracker.h"
+#include "Centroid.h"
+#include "Kalman.h"
+#include "StateCentroid.h"
+#include "IoU.h"
+#include "FixedStateCentroid.h"
+#include "Scenario.h"
+#include "SimCam.h"
+#include "Clock.h"
+#include "BoxStream.h"
+#include "CrossingFusion.h"
+#include "../common/AllocCount.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Length of each synthetic scenario
+#define SCENARIO_MS (30 * 60 * 1000)
+
+// Width in pixels of the signpost in the occluded scenario
+#define OCCLUDER_WIDTH 200
+
+// Pixels of trail both cameras see in the dual camera scenarios, and how
+// far the second camera's clock is ahead of the first's
+#define FUSION_OVERLAP 480
+#define FUSION_SKEW_MS 5000
+
+// Faults injected into the busy scenario to test the camera watchdog, at
+// a minute and a time the camera stays unreachable after it
+static const SimFault outageFaults[] = {
+    { SIM_FAULT_STALL, 5 * 60 * 1000, 0 },
+    { SIM_FAULT_DROP, 12 * 60 * 1000, 20000 },
+    { SIM_FAULT_STALL, 20 * 60 * 1000, 5000 },
+};
+
+using namespace Spinnaker;
+
+using std::map;
+using std::set;
+using std::pair;
+using std::string;
+using std::vector;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+/*
+ * Remembers the ID and direction of every tracker that gets counted.
+ */
+class CountedIds : public CountListener {
+    public:
+        vector<int> ids;
+        vector<int> dirs;
+
+        void OnCrossing(int trackId, int dir) {
+            ids.push_back(trackId);
+            dirs.push_back(dir);
+        }
+};
+
+struct EvalResult {
+    string scenario;
+    string tracker;
+    int frames;
+
+    // Counting accuracy
+    int expectedCount;
+    int count;
+    int expectedIn;
+    int in;
+    int expectedOut;
+    int out;
+
+    // Tracking accuracy
+    long long gtDetections;
+    long long falsePositives;
+    long long falseNegatives;
+    long long idSwitches;
+    double mota;
+    double idf1;
+
+    // Churn
+    long long trackersCreated;
+    double allocsPerFrame;
+    int falseCounts;
+    int wrongDirs;
+
+    // Speed
+    double fps;
+    double p99Us;
+};
+
+static vector<EvalResult> results;
+
+struct ReplayResult {
+    string scenario;
+    double durationMs;
+    int expectedCount;
+    int count[2];
+    int in[2];
+    int out[2];
+    double seconds[2];
+};
+
+static vector<ReplayResult> replays;
+
+struct FusionResult {
+    string scenario;
+    int expectedIn;
+    int expectedOut;
+    int in[2];
+    int out[2];
+    int fusedIn;
+    int fusedOut;
+    long long merged;
+    long long unmatchable;
+    int pending;
+    int stale;
+};
+
+static vector<FusionResult> fusions;
+
+struct OutageResult {
+    string scenario;
+    int faults;
+    int cleanIn;
+    int cleanOut;
+    int in[2];
+    int out[2];
+    long long outages[2];
+    long long failedReconnects;
+    long long lastRecoveryMs;
+    long long maxRecoveryMs;
+    long long downMs;
+    bool stillDown;
+};
+
+static vector<OutageResult> outageRuns;
+
+/*
+ * Count a perfect tracker would end up with, applying the same rules as
+ * the PeopleCounter in the order people left the frame.
+ */
+static int ExpectedCount(const BoxStream& stream, int* in, int* out) {
+    vector<StreamCrossing> crossings;
+    for (int i = 0; i < stream.GetNumCrossings(); i++)
+        crossings.push_back(stream.GetCrossing(i));
+
+    std::sort(crossings.begin(), crossings.end(), [](const StreamCrossing& a, const StreamCrossing& b) {
+        return a.tMs < b.tMs;
+    });
+
+    int count = 0;
+    *in = 0;
+    *out = 0;
+    for (auto it = crossings.begin(); it != crossings.end(); ++it) {
+        if (it->dir == LEFT) {
+            (*in)++;
+            count++;
+        }
+        else {
+            (*out)++;
+            if (count != 0)
+                count--;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Global ID matching for IDF1. Pairs of ground truth and tracker IDs are
+ * matched greedily by the number of detections they share, which is the
+ * optimal assignment whenever each tracker mostly follows one person.
+ */
+static long long IdTruePositives(map<pair<int, int>, long long>& pairs) {
+    vector<pair<long long, pair<int, int>>> sorted;
+    for (auto it = pairs.begin(); it != pairs.end(); ++it)
+        sorted.push_back(std::make_pair(it->second, it->first));
+    std::sort(sorted.rbegin(), sorted.rend());
+
+    map<int, bool> gtUsed;
+    map<int, bool> trackUsed;
+    long long idtp = 0;
+    for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+        int gt = it->second.first;
+        int tr = it->second.second;
+        if (!gtUsed[gt] && !trackUsed[tr]) {
+            gtUsed[gt] = true;
+            trackUsed[tr] = true;
+            idtp += it->first;
+        }
+    }
+
+    return idtp;
+}
+
+/*
+ * Counted trackers whose direction isn't the way the person they shared
+ * the most detections with crossed.
+ */
+static int WrongDirections(const BoxStream& stream, const CountedIds& counted,
+                           map<pair<int, int>, long long>& pairs) {
+    map<int, int> gtDir;
+    for (int i = 0; i < stream.GetNumCrossings(); i++)
+        gtDir[stream.GetCrossing(i).gtId] = stream.GetCrossing(i).dir;
+
+    // Person each tracker followed most
+    map<int, pair<long long, int>> followed;
+    for (auto it = pairs.begin(); it != pairs.end(); ++it) {
+        pair<long long, int>& best = followed[it->first.second];
+        if (it->second > best.first)
+            best = std::make_pair(it->second, it->first.first);
+    }
+
+    int wrong = 0;
+    for (size_t i = 0; i < counted.ids.size(); i++) {
+        auto tr = followed.find(counted.ids[i]);
+        if (tr == followed.end())
+            continue;
+
+        auto dir = gtDir.find(tr->second.second);
+        if (dir != gtDir.end() && dir->second != counted.dirs[i])
+            wrong++;
+    }
+
+    return wrong;
+}
+
+template <class T>
+static void RunEval(const char* scenario, const char* trackerName, const BoxStream& stream, bool reIdentify,
+                    bool tentative, bool useArena = false) {
+    EvalResult res = EvalResult();
+    res.scenario = scenario;
+    res.tracker = string(trackerName) + (tentative ? "+tent" : "") + (reIdentify ? "+reid" : "") +
+                  (useArena ? "+arena" : "");
+
+    PeopleCounter<T>* cntr = new PeopleCounter<T>((BoxSource*)NULL);
+    if (reIdentify)
+        cntr->EnableReIdentification();
+    if (tentative)
+        cntr->EnableTentativeTracks();
+
+    Arena arena;
+    if (useArena) {
+        cntr->UseArena(&arena, ArenaCaps());
+        arena.Commit();
+    }
+
+    CountedIds counted;
+    cntr->AddCountListener(&counted);
+    set<int> realTracks;
+    long long allocs = 0;
+    vector<InferenceBoundingBox> boxes;
+    vector<int> gtIds;
+    vector<int> trackIds;
+    vector<double> latencyUs;
+    map<int, int> lastTrack;
+    map<pair<int, int>, long long> pairs;
+    long long trackedDetections = 0;
+    double totalUs = 0;
+
+    int numFrames = stream.GetNumFrames();
+    for (int f = 0; f < numFrames + MISSING_THRESH + REID_WINDOW + 2; f++) {
+        // Feed a few empty frames at the end so the last people get counted
+        if (f < numFrames) {
+            stream.GetFrame(f, boxes, &gtIds);
+        }
+        else {
+            boxes.clear();
+            gtIds.clear();
+        }
+
+        long long allocStart = allocCount;
+        steady_clock::time_point start = steady_clock::now();
+        cntr->ProcessFrame(boxes, &trackIds);
+        double us = duration<double, std::micro>(steady_clock::now() - start).count();
+        allocs += allocCount - allocStart;
+        latencyUs.push_back(us);
+        totalUs += us;
+
+        for (size_t i = 0; i < boxes.size(); i++) {
+            int gt = gtIds[i];
+            int tr = trackIds[i];
+
+            if (tr >= 0)
+                trackedDetections++;
+
+            if (gt == NO_GT_ID) {
+                if (tr >= 0)
+                    res.falsePositives++;
+                continue;
+            }
+
+            res.gtDetections++;
+            if (tr < 0) {
+                res.falseNegatives++;
+                continue;
+            }
+
+            realTracks.insert(tr);
+
+            auto last = lastTrack.find(gt);
+            if (last != lastTrack.end() && last->second != tr)
+                res.idSwitches++;
+            lastTrack[gt] = tr;
+            pairs[std::make_pair(gt, tr)]++;
+        }
+    }
+
+    res.frames = numFrames;
+    res.expectedCount = ExpectedCount(stream, &res.expectedIn, &res.expectedOut);
+    res.count = cntr->GetPeopleCount();
+    res.in = cntr->GetPeopleIn();
+    res.out = cntr->GetPeopleOut();
+
+    if (res.gtDetections > 0)
+        res.mota = 1.0 - (double)(res.falseNegatives + res.falsePositives + res.idSwitches) / res.gtDetections;
+    if (res.gtDetections + trackedDetections > 0)
+        res.idf1 = 2.0 * IdTruePositives(pairs) / (res.gtDetections + trackedDetections);
+
+    res.trackersCreated = cntr->GetTrackersCreated();
+    res.allocsPerFrame = (double)allocs / latencyUs.size();
+    for (auto it = counted.ids.begin(); it != counted.ids.end(); ++it) {
+        if (realTracks.count(*it) == 0)
+            res.falseCounts++;
+    }
+    res.wrongDirs = WrongDirections(stream, counted, pairs);
+
+    std::sort(latencyUs.begin(), latencyUs.end());
+    res.fps = latencyUs.size() / (totalUs / 1e6);
+    res.p99Us = latencyUs[(size_t)(0.99 * (latencyUs.size() - 1))];
+
+    printf("%-14s %-29s %6d %4d/%-4d %4d/%-4d %4d/%-4d %6lld %7.3f %7.3f %8lld %7.2f %6d %6d %10.0f %9.1f\n",
+           res.scenario.c_str(), res.tracker.c_str(), res.frames,
+           res.count, res.expectedCount, res.in, res.expectedIn, res.out, res.expectedOut,
+           res.idSwitches, res.mota, res.idf1, res.trackersCreated, res.allocsPerFrame, res.falseCounts,
+           res.wrongDirs, res.fps, res.p99Us);
+
+    results.push_back(res);
+    delete cntr;
+}
+
+static void RunAllTrackers(const char* scenario, const BoxStream& stream) {
+    for (int tent = 0; tent < 2; tent++) {
+        for (int reid = 0; reid < 2; reid++) {
+            RunEval<Centroid>(scenario, "Centroid", stream, reid != 0, tent != 0);
+            RunEval<StateCentroid>(scenario, "StateCentroid", stream, reid != 0, tent != 0);
+            RunEval<FixedStateCentroid>(scenario, "FixedState", stream, reid != 0, tent != 0);
+            RunEval<Kalman>(scenario, "Kalman", stream, reid != 0, tent != 0);
+            RunEval<IoU>(scenario, "IoU", stream, reid != 0, tent != 0);
+        }
+    }
+
+    RunEval<Centroid>(scenario, "Centroid", stream, true, true, true);
+    RunEval<StateCentroid>(scenario, "StateCentroid", stream, true, true, true);
+    RunEval<FixedStateCentroid>(scenario, "FixedState", stream, true, true, true);
+    RunEval<Kalman>(scenario, "Kalman", stream, true, true, true);
+    RunEval<IoU>(scenario, "IoU", stream, true, true, true);
+}
+
+/*
+ * Plays the scenario through a SimCam on a simulated clock, twice, with
+ * the adaptive frame rate, re-identification, tentative tracks and the
+ * heatmap on.
+ */
+static void RunReplay(const char* name, Scenario& scenario) {
+    ReplayResult r;
+    r.scenario = name;
+    r.durationMs = scenario.GetDuration();
+    r.expectedCount = scenario.GetExpectedCount(scenario.GetDuration());
+
+    for (int run = 0; run < 2; run++) {
+        SimClock clock;
+        PeopleCounter<StateCentroid>* cntr = new PeopleCounter<StateCentroid>(new SimCam(&scenario));
+        cntr->SetClock(&clock);
+        cntr->EnableActivityControl();
+        cntr->EnableReIdentification();
+        cntr->EnableTentativeTracks();
+        cntr->EnableHeatmap();
+
+        steady_clock::time_point start = steady_clock::now();
+        cntr->Replay();
+        r.seconds[run] = duration<double>(steady_clock::now() - start).count();
+
+        r.count[run] = cntr->GetPeopleCount();
+        r.in[run] = cntr->GetPeopleIn();
+        r.out[run] = cntr->GetPeopleOut();
+        delete cntr;
+    }
+
+    replays.push_back(r);
+}
+
+/*
+ * Passes on the paths of a camera until its clock reaches the cutoff, as
+ * if it went down then.
+ */
+class CutoffFeed : public PathListener {
+    public:
+        CutoffFeed(PathListener* feed, Clock* clock, long long cutoffMs)
+            : feed(feed), clock(clock), cutoffMs(cutoffMs) {}
+
+        void OnPathEnd(const TrajRecord& rec) {
+            if (clock->NowMs() < cutoffMs)
+                feed->OnPathEnd(rec);
+        }
+
+    private:
+        PathListener* feed;
+        Clock* clock;
+        long long cutoffMs;
+};
+
+/*
+ * Plays the same people past two cameras whose views overlap by
+ * FUSION_OVERLAP pixels, the second one further along the trail and with
+ * its clock FUSION_SKEW_MS ahead, and merges what they count. Both use
+ * IoU, which keeps hold of people all the way across the frame, so the
+ * merging is what is being measured rather than the tracker.
+ *
+ * If silentAfterMs is given, the second camera stops reporting that far
+ * in and is played first. The fusion is then timed on the first camera's
+ * clock, so the second one goes quiet as the first plays on.
+ */
+static void RunFusion(const char* name, double peoplePerHour, double drop, double jitter, double falsePositives,
+                      long long silentAfterMs = -1) {
+    FusionResult r;
+    r.scenario = name;
+    r.expectedIn = 0;
+    r.expectedOut = 0;
+
+    int trailLength = 2 * CAM_X - FUSION_OVERLAP;
+    CrossingFusion fusion(CAM_X - FUSION_OVERLAP / 2.0);
+    Scenario scenarios[2];
+    SimClock clocks[2] = { SimClock(0), SimClock(FUSION_SKEW_MS * 1000LL) };
+    if (silentAfterMs >= 0)
+        fusion.SetClock(&clocks[0]);
+
+    for (int cam = 0; cam < 2; cam++) {
+        scenarios[cam].GenerateSynthetic(SCENARIO_MS, peoplePerHour, 1);
+        scenarios[cam].SetNoise(drop, jitter, falsePositives);
+        scenarios[cam].SetView(cam * (CAM_X - FUSION_OVERLAP), trailLength);
+
+        FusionCamera geometry;
+        geometry.offsetMs = -cam * FUSION_SKEW_MS;
+        geometry.trailAtX0 = cam * (CAM_X - FUSION_OVERLAP);
+        fusion.AddCamera(geometry);
+    }
+
+    for (int i = 0; i < scenarios[0].GetNumPeople(); i++) {
+        if (scenarios[0].GetPerson(i).speed < 0)
+            r.expectedIn++;
+        else
+            r.expectedOut++;
+    }
+
+    // One camera after the other, since the fusion holds crossings until
+    // both have moved past them
+    for (int i = 0; i < 2; i++) {
+        int cam = (silentAfterMs >= 0) ? 1 - i : i;
+        bool silent = (silentAfterMs >= 0 && cam == 1);
+        CutoffFeed cutoff(fusion.GetFeed(cam), &clocks[cam], clocks[cam].NowMs() + silentAfterMs);
+
+        PeopleCounter<IoU>* cntr = new PeopleCounter<IoU>(new SimCam(&scenarios[cam]));
+        cntr->SetClock(&clocks[cam]);
+        cntr->EnableReIdentification();
+        cntr->EnableTentativeTracks();
+        cntr->EnableTrajectories();
+        cntr->GetTrajectories()->AddListener(silent ? (PathListener*)&cutoff : fusion.GetFeed(cam));
+
+        cntr->Replay();
+        r.in[cam] = cntr->GetPeopleIn();
+        r.out[cam] = cntr->GetPeopleOut();
+
+        // The camera goes quiet, so nothing it hasn't reported yet is
+        // coming. One that went down never says so.
+        if (!silent)
+            fusion.Advance(cam, clocks[cam].NowMs() + FUSION_WINDOW_MS + FUSION_HOLD_MS + 1);
+        delete cntr;
+    }
+
+    r.fusedIn = fusion.GetPeopleIn();
+    r.fusedOut = fusion.GetPeopleOut();
+    r.merged = fusion.GetMerged();
+    r.unmatchable = fusion.GetUnmatchable();
+    r.pending = fusion.GetPending();
+    r.stale = fusion.GetStaleCameras();
+    fusions.push_back(r);
+}
+
+/*
+ * Replays the scenario on a simulated clock with IoU, once as it is and
+ * twice with outageFaults injected into the camera and the watchdog on,
+ * so the time to recover from each kind of fault is known exactly and
+ * the people lost to the outages can be counted.
+ */
+static void RunOutages(const char* name, Scenario& scenario) {
+    OutageResult r;
+    r.scenario = name;
+    r.faults = sizeof(outageFaults) / sizeof(outageFaults[0]);
+
+    for (int run = -1; run < 2; run++) {
+        SimClock clock;
+        SimCam* cam = new SimCam(&scenario);
+        PeopleCounter<IoU>* cntr = new PeopleCounter<IoU>(cam);
+        cntr->SetClock(&clock);
+        cntr->EnableReIdentification();
+        cntr->EnableTentativeTracks();
+
+        if (run >= 0) {
+            for (int i = 0; i < r.faults; i++)
+                cam->AddFault(outageFaults[i]);
+            cntr->EnableWatchdog();
+        }
+
+        cntr->Replay();
+
+        if (run < 0) {
+            r.cleanIn = cntr->GetPeopleIn();
+            r.cleanOut = cntr->GetPeopleOut();
+            delete cntr;
+            continue;
+        }
+
+        CameraWatchdog* watchdog = cntr->GetWatchdog();
+        r.in[run] = cntr->GetPeopleIn();
+        r.out[run] = cntr->GetPeopleOut();
+        r.outages[run] = watchdog->GetOutages();
+        r.failedReconnects = watchdog->GetFailedReconnects();
+        r.lastRecoveryMs = watchdog->GetLastRecoveryMs();
+        r.maxRecoveryMs = watchdog->GetMaxRecoveryMs();
+        r.downMs = watchdog->GetDownMs();
+        r.stillDown = watchdog->IsDown();
+        delete cntr;
+    }
+
+    outageRuns.push_back(r);
+}
+
+/*
+ * Renders a synthetic scenario to a stream file and runs it.
+ */
+static void RunSynthetic(const char* name, double peoplePerHour, double drop, double jitter,
+                         double falsePositives, int occluderWidth, const char* saveDir) {
+    Scenario scenario;
+    scenario.GenerateSynthetic(SCENARIO_MS, peoplePerHour, 1);
+    scenario.SetNoise(drop, jitter, falsePositives);
+    scenario.SetOccluder((CAM_X - occluderWidth) / 2, (CAM_X + occluderWidth) / 2);
+
+    BoxStreamWriter writer;
+    string path = string(saveDir ? saveDir : ".") + "/" + name + ".hkbx";
+    if (scenario.Record(writer, INFERENCE_TIME) || writer.Save(path.c_str()))
+        return;
+
+    BoxStream stream;
+    if (stream.Load(path.c_str()) == 0)
+        RunAllTrackers(name, stream);
+
+    if (saveDir == NULL)
+        remove(path.c_str());
+
+    RunReplay(name, scenario);
+    if (strcmp(name, "busy") == 0)
+        RunOutages(name, scenario);
+}
+
+/*
+ * Compares every FixedState run with the StateCentroid run on the same
+ * stream and options. Returns the number of runs that differ.
+ */
+static int CheckFixedParity(void) {
+    int checked = 0;
+    int mismatches = 0;
+
+    for (auto fixed = results.begin(); fixed != results.end(); ++fixed) {
+        if (fixed->tracker.compare(0, 10, "FixedState") != 0)
+            continue;
+
+        string ref = "StateCentroid" + fixed->tracker.substr(10);
+        for (auto it = results.begin(); it != results.end(); ++it) {
+            if (it->scenario != fixed->scenario || it->tracker != ref)
+                continue;
+
+            checked++;
+            if (it->count != fixed->count || it->in != fixed->in || it->out != fixed->out ||
+                it->idSwitches != fixed->idSwitches) {
+                printf("Fixed point mismatch on %s %s: count %d/%d, in %d/%d, out %d/%d, idsw %lld/%lld\n",
+                       fixed->scenario.c_str(), fixed->tracker.c_str(), fixed->count, it->count,
+                       fixed->in, it->in, fixed->out, it->out, fixed->idSwitches, it->idSwitches);
+                mismatches++;
+            }
+        }
+    }
+
+    printf("\nFixed point parity: %d of %d runs match.\n", checked - mismatches, checked);
+    return mismatches;
+}
+
+/*
+ * Prints the replays and returns the number that counted differently the
+ * second time.
+ */
+static int CheckReplays(void) {
+    int mismatches = 0;
+
+    printf("\nReplays on a simulated clock:\n");
+    for (auto it = replays.begin(); it != replays.end(); ++it) {
+        bool same = (it->count[0] == it->count[1] && it->in[0] == it->in[1] && it->out[0] == it->out[1]);
+        printf("%-14s count %d/%d, in %d, out %d, %.0f min in %.3f s and %.3f s%s\n", it->scenario.c_str(),
+               it->count[0], it->expectedCount, it->in[0], it->out[0], it->durationMs / 60000, it->seconds[0],
+               it->seconds[1], same ? "" : "  (second run differs)");
+        if (!same)
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+/*
+ * Prints the dual camera runs and returns the number where merging didn't
+ * get closer to the real count than adding the two cameras up, or left
+ * crossings uncounted.
+ */
+static int CheckFusions(void) {
+    int failures = 0;
+
+    printf("\nTwo cameras, overlapping by %d px:\n", FUSION_OVERLAP);
+    for (auto it = fusions.begin(); it != fusions.end(); ++it) {
+        int summedIn = it->in[0] + it->in[1];
+        int summedOut = it->out[0] + it->out[1];
+        int summedErr = abs(summedIn - it->expectedIn) + abs(summedOut - it->expectedOut);
+        int fusedErr = abs(it->fusedIn - it->expectedIn) + abs(it->fusedOut - it->expectedOut);
+
+        bool worse = (fusedErr >= summedErr);
+        bool stuck = (it->pending > 0);
+        printf("%-14s in/out %d/%d, cameras %d/%d and %d/%d, summed %d/%d, fused %d/%d, %lld merged, "
+               "%lld unmatchable, %d pending, %d cameras quiet%s%s\n", it->scenario.c_str(), it->expectedIn,
+               it->expectedOut, it->in[0], it->out[0], it->in[1], it->out[1], summedIn, summedOut,
+               it->fusedIn, it->fusedOut, it->merged, it->unmatchable, it->pending, it->stale,
+               worse ? "  (no better than summed)" : "", stuck ? "  (crossings never counted)" : "");
+        if (worse || stuck)
+            failures++;
+    }
+
+    return failures;
+}
+
+/*
+ * Prints the runs with camera faults and returns the number where the
+ * watchdog missed a fault, didn't recover from one or counted differently
+ * the second time.
+ */
+static int CheckOutages(void) {
+    int failures = 0;
+
+    printf("\nCamera faults on a simulated clock:\n");
+    for (auto it = outageRuns.begin(); it != outageRuns.end(); ++it) {
+        bool failed = (it->outages[0] != it->faults || it->stillDown || it->in[0] != it->in[1] ||
+                       it->out[0] != it->out[1] || it->outages[0] != it->outages[1]);
+        printf("%-14s %lld of %d faults recovered from, %lld failed reconnects, last %lld ms, worst %lld ms, "
+               "%.1f s down, in/out %d/%d against %d/%d without faults%s\n", it->scenario.c_str(),
+               it->outages[0], it->faults, it->failedReconnects, it->lastRecoveryMs, it->maxRecoveryMs,
+               it->downMs / 1000.0, it->in[0], it->out[0], it->cleanIn, it->cleanOut,
+               failed ? "  (failed)" : "");
+        if (failed)
+            failures++;
+    }
+
+    return failures;
+}
+
+static void WriteResults(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) {
+        printf("Unable to open %s.\n", path);
+        return;
+    }
+
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        fprintf(f, "{\"scenario\":\"%s\",\"tracker\":\"%s\",\"frames\":%d,"
+                   "\"count\":%d,\"expected_count\":%d,\"count_error\":%d,"
+                   "\"in\":%d,\"expected_in\":%d,\"out\":%d,\"expected_out\":%d,"
+                   "\"gt_detections\":%lld,\"false_positives\":%lld,\"false_negatives\":%lld,"
+                   "\"id_switches\":%lld,\"mota\":%.4f,\"idf1\":%.4f,\"trackers_created\":%lld,"
+                   "\"allocs_per_frame\":%.3f,\"false_counts\":%d,\"wrong_dirs\":%d,\"fps\":%.1f,\"p99_us\":%.2f}\n",
+                it->scenario.c_str(), it->tracker.c_str(), it->frames,
+                it->count, it->expectedCount, abs(it->count - it->expectedCount),
+                it->in, it->expectedIn, it->out, it->expectedOut,
+                it->gtDetections, it->falsePositives, it->falseNegatives,
+                it->idSwitches, it->mota, it->idf1, it->trackersCreated, it->allocsPerFrame, it->falseCounts,
+                it->wrongDirs, it->fps, it->p99Us);
+    }
+
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    const char* jsonPath = "eval_results.json";
+    const char* saveDir = NULL;
+    vector<const char*> recorded;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+            saveDir = argv[++i];
+        else
+            recorded.push_back(argv[i]);
+    }
+
+    printf("%-14s %-29s %6s %9s %9s %9s %6s %7s %7s %8s %7s %6s %6s %10s %9s\n", "scenario", "tracker", "frames",
+           "count/gt", "in/gt", "out/gt", "idsw", "MOTA", "IDF1", "created", "alloc/f", "false",
+           "wrong", "fps", "p99 us");
+
+    // One person at a time, many people, crowds, an imperfect detector,
+    // and a signpost in the middle of the frame
+    RunSynthetic("single", 30, 0, 0, 0, 0, saveDir);
+    RunSynthetic("busy", 600, 0, 0, 0, 0, saveDir);
+    RunSynthetic("crowd", 3000, 0, 0, 0, 0, saveDir);
+    RunSynthetic("noisy", 600, 0.10, 15, 0.02, 0, saveDir);
+    RunSynthetic("occluded", 600, 0, 0, 0, OCCLUDER_WIDTH, saveDir);
+
+    RunFusion("busy", 600, 0, 0, 0);
+    RunFusion("noisy", 600, 0.10, 15, 0.02);
+    RunFusion("busy, 1 silent", 600, 0, 0, 0, SCENARIO_MS / 2);
+
+    for (auto it = recorded.begin(); it != recorded.end(); ++it) {
+        BoxStream stream;
+        if (stream.Load(*it) == 0)
+            RunAllTrackers(*it, stream);
+    }
+
+    WriteResults(jsonPath);
+    int failures = CheckFixedParity();
+    failures += CheckReplays();
+    failures += CheckFusions();
+    failures += CheckOutages();
+    return (failures == 0) ? 0 : -1;
+}
@@ -0,0 +1,125 @@
+/*
+ *  jitter.cpp
+ *
+ *  Measures how late a thread that wakes up once per inference, like the
+ *  tracking thread, gets to run. Runs with default scheduling and then
+ *  pinned to a CPU under a real-time policy, first on an idle host and
+ *  then with every core loaded by busy threads, so the effect of the
+ *  thread placement settings in main.cpp can be seen on the target.
+ *
+ *  Usage: jitter [--seconds N] [--cpu C] [--policy fifo|rr] [--period MS]
+ *
+ *  Real-time policies usually need root or CAP_SYS_NICE outside Windows;
+ *  runs whose placement failed are marked.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "ThreadControl.h"
+#include "Tracker.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Memory each stress thread keeps writing through, to load the caches
+#define STRESS_BYTES (1 << 20)
+
+using std::vector;
+using std::thread;
+using std::chrono::steady_clock;
+
+static std::atomic<bool> stressing(false);
+static std::atomic<long long> sink(0);
+
+/*
+ * Keeps a core busy with arithmetic and memory traffic until told to stop.
+ */
+static void Stress(void) {
+    vector<uint8_t> buf(STRESS_BYTES);
+    long long sum = 0;
+
+    while (stressing) {
+        for (size_t i = 0; i < buf.size(); i += 64) {
+            buf[i] = (uint8_t)(buf[i] + i);
+            sum += buf[i];
+        }
+    }
+
+    sink += sum;
+}
+
+/*
+ * Wakes up every periodMs for the given time, on a thread with the given
+ * placement, and prints how late the wakeups were.
+ */
+static void RunJitter(const char* name, const char* load, const ThreadPlacement& placement, int periodMs,
+                      int seconds) {
+    WakeupJitter jitter;
+    bool placed = true;
+
+    thread t([&] {
+        placed = (PlaceThisThread(placement) == 0);
+
+        steady_clock::time_point wakeup = steady_clock::now();
+        steady_clock::time_point end = wakeup + std::chrono::seconds(seconds);
+        while (wakeup < end) {
+            wakeup += std::chrono::milliseconds(periodMs);
+            jitter.SleepUntil(wakeup);
+        }
+    });
+    t.join();
+
+    printf("%-16s %-8s %8lld %10.1f %10lld %10lld%s\n", name, load, jitter.GetWakeups(), jitter.GetAvgUs(),
+           jitter.GetPercentileUs(0.99), jitter.GetMaxUs(), placed ? "" : "  (placement failed)");
+}
+
+static void RunAll(const char* load, const ThreadPlacement& placed, int periodMs, int seconds) {
+    RunJitter("default", load, ThreadPlacement(), periodMs, seconds);
+    RunJitter((placed.policy == THREAD_SCHED_RR) ? "pinned+rr" : "pinned+fifo", load, placed, periodMs, seconds);
+}
+
+int main(int argc, char** argv) {
+    int seconds = 5;
+    int periodMs = INFERENCE_TIME;
+    ThreadPlacement placed(0, THREAD_SCHED_FIFO);
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc)
+            placed.cpu = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+            placed.policy = (strcmp(argv[++i], "rr") == 0) ? THREAD_SCHED_RR : THREAD_SCHED_FIFO;
+        else if (strcmp(argv[i], "--period") == 0 && i + 1 < argc)
+            periodMs = atoi(argv[++i]);
+        else {
+            printf("Unknown argument %s.\n", argv[i]);
+            return -1;
+        }
+    }
+
+    int numCpus = GetNumCpus();
+    printf("%d CPUs, waking up every %d ms for %d s\n", numCpus, periodMs, seconds);
+    printf("%-16s %-8s %8s %10s %10s %10s\n", "placement", "load", "wakeups", "avg us", "p99 us", "max us");
+
+    RunAll("idle", placed, periodMs, seconds);
+
+    // One busy thread per core, so the measured thread has to compete
+    stressing = true;
+    vector<thread> stress;
+    for (int i = 0; i < numCpus; i++)
+        stress.push_back(thread(Stress));
+
+    RunAll("stress", placed, periodMs, seconds);
+
+    stressing = false;
+    for (auto it = stress.begin(); it != stress.end(); ++it)
+        it->join();
+
+    return 0;
+}
@@ -0,0 +1,430 @@
+/*
+ *  pipeline.cpp
+ *
+ *  Compares the two ways of driving tracking from several simulated
+ *  cameras at once:
+ *
+ *      threads     the current design, a tracking thread per camera that
+ *                  wakes up once per frame period and polls the camera
+ *      coroutines  the CoPipeline stages of every camera on one Executor
+ *                  thread, woken up by the camera for each frame
+ *      staged      a StagedPipeline per camera, a thread per stage joined
+ *                  by lock-free queues
+ *
+ *  Each camera still has its acquisition thread in all of them. Reports the
+ *  frames tracked, the frames lost, the time from a frame being published
+ *  to being tracked, the CPU used and the context switches, and the queues of
+ *  the first camera's staged pipeline. Then measures the cost of one
+ *  hand-off between two coroutines on an Executor against one between two
+ *  threads on a condition variable and on a pair of SpscQueues.
+ *
+ *  Usage: pipeline [--cameras K] [--fps F] [--seconds N] [--handoffs N]
+ *
+ *  Context switches are only counted outside Windows.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "CoPipeline.h"
+#include "StagedPipeline.h"
+#include "Executor.h"
+#include "Channel.h"
+#include "SimCam.h"
+#include "Scenario.h"
+#include "StateCentroid.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#define PEOPLE_PER_HOUR 600
+
+using std::vector;
+using std::thread;
+using std::chrono::steady_clock;
+
+struct Usage {
+    double cpuMs;
+    long long switches;     // -1 if unknown
+};
+
+static Usage GetUsage(void) {
+    Usage usage;
+#ifdef _WIN32
+    FILETIME create, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &create, &exit, &kernel, &user);
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    usage.cpuMs = (k.QuadPart + u.QuadPart) / 10000.0;
+    usage.switches = -1;
+#else
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    usage.cpuMs = (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000.0 +
+                  (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000.0;
+    usage.switches = ru.ru_nvcsw + ru.ru_nivcsw;
+#endif
+    return usage;
+}
+
+struct RunStats {
+    long long published;
+    long long frames;
+    double avgLatencyUs;
+    double maxLatencyUs;
+};
+
+static void PrintRow(const char* design, int cameras, int threads, const RunStats& stats, const Usage& before,
+                     const Usage& after) {
+    long long switches = (after.switches < 0) ? -1 : after.switches - before.switches;
+    printf("%-11s %7d %7d %9lld %7lld %10.1f %10.1f %9.1f %9lld\n", design, cameras, threads, stats.frames,
+           stats.published - stats.frames, stats.avgLatencyUs, stats.maxLatencyUs, after.cpuMs - before.cpuMs,
+           switches);
+}
+
+/*
+ * Mirrors PeopleCounter::StartPeopleCounter, but only tracks a frame
+ * once, and times it from when the camera published it.
+ */
+static void PollCamera(PeopleCounter<StateCentroid>* cntr, FrameSignal* signal, int periodMs,
+                       std::atomic<bool>* endSignal, RunStats* stats) {
+    vector<InferenceBoundingBox> boxes;
+    steady_clock::time_point last;
+    long long totalNs = 0;
+    long long maxNs = 0;
+
+    while (!*endSignal) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(periodMs));
+
+        steady_clock::time_point published = signal->GetLastNotify();
+        if (published == last)
+            continue;
+        last = published;
+
+        cntr->GetBoxSource()->GetBoundingBoxData(boxes);
+        cntr->ProcessFrame(boxes);
+        cntr->AdjustFrameRate();
+
+        long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - published).count();
+        totalNs += ns;
+        if (ns > maxNs)
+            maxNs = ns;
+        stats->frames++;
+    }
+
+    stats->avgLatencyUs = (stats->frames > 0) ? totalNs / 1000.0 / stats->frames : 0;
+    stats->maxLatencyUs = maxNs / 1000.0;
+}
+
+static vector<PeopleCounter<StateCentroid>*> MakeCounters(vector<Scenario*>& scenarios, int cameras, double fps,
+                                                          int seconds) {
+    vector<PeopleCounter<StateCentroid>*> cntrs;
+
+    for (int i = 0; i < cameras; i++) {
+        Scenario* scenario = new Scenario();
+        scenario->GenerateSynthetic(seconds * 1000, PEOPLE_PER_HOUR, i + 1);
+        scenarios.push_back(scenario);
+
+        SimCam* cam = new SimCam(scenario);
+        cam->SetFrameRate(fps);
+        cntrs.push_back(new PeopleCounter<StateCentroid>(cam));
+    }
+
+    return cntrs;
+}
+
+static void RunThreads(int cameras, double fps, int seconds) {
+    vector<Scenario*> scenarios;
+    vector<PeopleCounter<StateCentroid>*> cntrs = MakeCounters(scenarios, cameras, fps, seconds);
+    vector<RunStats> stats(cameras, RunStats{ 0, 0, 0, 0 });
+    std::atomic<bool> endSignal(false);
+
+    // Only used for its publish time, nothing ever waits on it
+    Executor executor(1);
+    vector<FrameSignal*> signals;
+    for (int i = 0; i < cameras; i++) {
+        signals.push_back(new FrameSignal(&executor));
+        cntrs[i]->GetBoxSource()->SetFrameListener(signals[i]);
+    }
+
+    Usage before = GetUsage();
+
+    vector<thread> threads;
+    for (int i = 0; i < cameras; i++) {
+        threads.push_back(thread(&BoxSource::StartAcquisition, cntrs[i]->GetBoxSource()));
+        threads.push_back(thread(PollCamera, cntrs[i], signals[i], (int)(1000.0 / fps), &endSignal, &stats[i]));
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    endSignal = true;
+    for (int i = 0; i < cameras; i++)
+        cntrs[i]->GetBoxSource()->EndAcquisition();
+    for (auto it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+
+    Usage after = GetUsage();
+
+    RunStats total = { 0, 0, 0, 0 };
+    for (int i = 0; i < cameras; i++) {
+        total.published += ((SimCam*)cntrs[i]->GetBoxSource())->GetFramesDelivered();
+        total.frames += stats[i].frames;
+        total.avgLatencyUs += stats[i].avgLatencyUs * stats[i].frames;
+        if (stats[i].maxLatencyUs > total.maxLatencyUs)
+            total.maxLatencyUs = stats[i].maxLatencyUs;
+    }
+    if (total.frames > 0)
+        total.avgLatencyUs /= total.frames;
+
+    PrintRow("threads", cameras, 2 * cameras, total, before, after);
+
+    for (int i = 0; i < cameras; i++) {
+        cntrs[i]->GetBoxSource()->SetFrameListener(NULL);
+        delete signals[i];
+        delete cntrs[i];
+        delete scenarios[i];
+    }
+}
+
+static void RunCoroutines(int cameras, double fps, int seconds) {
+    vector<Scenario*> scenarios;
+    vector<PeopleCounter<StateCentroid>*> cntrs = MakeCounters(scenarios, cameras, fps, seconds);
+    Executor executor(1);
+    vector<CoPipeline<StateCentroid>*> stages;
+
+    for (int i = 0; i < cameras; i++)
+        stages.push_back(new CoPipeline<StateCentroid>(&executor, cntrs[i]));
+
+    Usage before = GetUsage();
+
+    executor.Start();
+    for (auto it = stages.begin(); it != stages.end(); ++it)
+        (*it)->Start();
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    for (auto it = stages.begin(); it != stages.end(); ++it)
+        (*it)->Stop();
+    executor.Stop();
+
+    Usage after = GetUsage();
+
+    RunStats total = { 0, 0, 0, 0 };
+    for (int i = 0; i < cameras; i++) {
+        total.published += ((SimCam*)cntrs[i]->GetBoxSource())->GetFramesDelivered();
+        total.frames += stages[i]->GetFrames();
+        total.avgLatencyUs += stages[i]->GetAvgLatencyUs() * stages[i]->GetFrames();
+        if (stages[i]->GetMaxLatencyUs() > total.maxLatencyUs)
+            total.maxLatencyUs = stages[i]->GetMaxLatencyUs();
+    }
+    if (total.frames > 0)
+        total.avgLatencyUs /= total.frames;
+
+    PrintRow("coroutines", cameras, cameras + executor.GetNumThreads(), total, before, after);
+
+    for (int i = 0; i < cameras; i++) {
+        delete stages[i];
+        delete cntrs[i];
+        delete scenarios[i];
+    }
+}
+
+static void RunStaged(int cameras, double fps, int seconds) {
+    vector<Scenario*> scenarios;
+    vector<PeopleCounter<StateCentroid>*> cntrs = MakeCounters(scenarios, cameras, fps, seconds);
+    vector<StagedPipeline<StateCentroid>*> stages;
+
+    for (int i = 0; i < cameras; i++)
+        stages.push_back(new StagedPipeline<StateCentroid>(cntrs[i]));
+
+    Usage before = GetUsage();
+
+    for (auto it = stages.begin(); it != stages.end(); ++it)
+        (*it)->Start();
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    for (auto it = stages.begin(); it != stages.end(); ++it)
+        (*it)->Stop();
+
+    Usage after = GetUsage();
+
+    RunStats total = { 0, 0, 0, 0 };
+    for (int i = 0; i < cameras; i++) {
+        total.published += ((SimCam*)cntrs[i]->GetBoxSource())->GetFramesDelivered();
+        total.frames += stages[i]->GetFrames();
+        total.avgLatencyUs += stages[i]->GetAvgLatencyUs() * stages[i]->GetFrames();
+        if (stages[i]->GetMaxLatencyUs() > total.maxLatencyUs)
+            total.maxLatencyUs = stages[i]->GetMaxLatencyUs();
+    }
+    if (total.frames > 0)
+        total.avgLatencyUs /= total.frames;
+
+    PrintRow("staged", cameras, 4 * cameras, total, before, after);
+
+    printf("\nQueues of the first camera's staged pipeline:\n");
+    stages[0]->GetFilterQueue()->PrintReport("Filter");
+    stages[0]->GetTrackQueue()->PrintReport("Track");
+    stages[0]->GetExportQueue()->PrintReport("Export");
+
+    for (int i = 0; i < cameras; i++) {
+        delete stages[i];
+        delete cntrs[i];
+        delete scenarios[i];
+    }
+}
+
+static CoTask Ping(Channel<int>* out, Channel<int>* in, int handoffs) {
+    int ball = 0;
+    for (int i = 0; i < handoffs; i++) {
+        co_await out->Push(ball);
+        co_await in->Pop(ball);
+    }
+    out->Close();
+}
+
+static CoTask Pong(Channel<int>* in, Channel<int>* out) {
+    int ball = 0;
+    while (co_await in->Pop(ball)) {
+        ball++;
+        co_await out->Push(ball);
+    }
+}
+
+/*
+ * Passes a value back and forth between two coroutines on one Executor
+ * thread, and prints the cost of each hand-off.
+ */
+static void HandoffCoroutines(int handoffs) {
+    Executor executor(1);
+    Channel<int> there(&executor, 1);
+    Channel<int> back(&executor, 1);
+
+    Usage before = GetUsage();
+    steady_clock::time_point start = steady_clock::now();
+
+    executor.Spawn(Ping(&there, &back, handoffs));
+    executor.Spawn(Pong(&there, &back));
+    executor.Start();
+    while (executor.GetLiveTasks() > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - start).count();
+    executor.Stop();
+
+    Usage after = GetUsage();
+    long long switches = (after.switches < 0) ? -1 : after.switches - before.switches;
+    printf("%-11s %10d %12.0f %10lld %9lld\n", "coroutines", 2 * handoffs, ns / (2 * handoffs),
+           executor.GetResumes(), switches);
+}
+
+/*
+ * Same, between two threads taking turns on a condition variable.
+ */
+static void HandoffThreads(int handoffs) {
+    std::mutex lock;
+    std::condition_variable cond;
+    int turn = 0;
+
+    Usage before = GetUsage();
+    steady_clock::time_point start = steady_clock::now();
+
+    auto player = [&](int me) {
+        for (int i = 0; i < handoffs; i++) {
+            std::unique_lock<std::mutex> guard(lock);
+            cond.wait(guard, [&] { return turn == me; });
+            turn = 1 - me;
+            cond.notify_one();
+        }
+    };
+
+    thread a(player, 0);
+    thread b(player, 1);
+    a.join();
+    b.join();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - start).count();
+
+    Usage after = GetUsage();
+    long long switches = (after.switches < 0) ? -1 : after.switches - before.switches;
+    printf("%-11s %10d %12.0f %10s %9lld\n", "threads", 2 * handoffs, ns / (2 * handoffs), "-", switches);
+}
+
+/*
+ * Same, between two threads on a pair of lock-free queues.
+ */
+static void HandoffQueues(int handoffs) {
+    SpscQueue<int> there(1);
+    SpscQueue<int> back(1);
+
+    Usage before = GetUsage();
+    steady_clock::time_point start = steady_clock::now();
+
+    thread pong([&] {
+        int ball = 0;
+        while (there.Pop(ball)) {
+            ball++;
+            back.Push(ball);
+        }
+    });
+
+    int ball = 0;
+    for (int i = 0; i < handoffs; i++) {
+        there.Push(ball);
+        back.Pop(ball);
+    }
+    there.Close();
+    pong.join();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - start).count();
+
+    Usage after = GetUsage();
+    long long switches = (after.switches < 0) ? -1 : after.switches - before.switches;
+    printf("%-11s %10d %12.0f %10s %9lld\n", "queues", 2 * handoffs, ns / (2 * handoffs), "-", switches);
+}
+
+int main(int argc, char** argv) {
+    int cameras = 4;
+    double fps = 1000.0 / INFERENCE_TIME;
+    int seconds = 10;
+    int handoffs = 100000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cameras") == 0 && i + 1 < argc)
+            cameras = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            fps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--handoffs") == 0 && i + 1 < argc)
+            handoffs = atoi(argv[++i]);
+        else {
+            printf("Unknown argument %s.\n", argv[i]);
+            return -1;
+        }
+    }
+
+    printf("%d cameras at %.1f fps for %d s\n", cameras, fps, seconds);
+    printf("%-11s %7s %7s %9s %7s %10s %10s %9s %9s\n", "design", "cameras", "threads", "frames", "lost",
+           "avg lat us", "max lat us", "cpu ms", "switches");
+    RunThreads(cameras, fps, seconds);
+    RunCoroutines(cameras, fps, seconds);
+    RunStaged(cameras, fps, seconds);
+
+    printf("\n%-11s %10s %12s %10s %9s\n", "handoff", "handoffs", "ns/handoff", "resumes", "switches");
+    HandoffCoroutines(handoffs);
+    HandoffThreads(handoffs);
+    HandoffQueues(handoffs);
+
+    return 0;
+}
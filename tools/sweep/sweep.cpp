@@ -0,0 +1,340 @@
+/*
+ *  sweep.cpp
+ *
+ *  Runs many tracker configurations over the same recorded box stream
+ *  in parallel and ranks them by counting error and processing cost.
+ *  The stream is memory mapped once and shared by all worker threads.
+ *
+ *  Usage: sweep stream.hkbx [--tracker centroid|state|fixed|kalman|iou]
+ *               [--param NAME=v1,v2,...] [--threads N] [--top N]
+ *               [--csv results.csv]
+ *
+ *  Each --param replaces the default list of values tried for that
+ *  threshold, and every combination of the values is run. Parameter
+ *  names are the defines in TrackerConfig.h.
+ *
+ *  Created on: Oct 19, 2026
+ *  Author: Andrada Zoltan
+ */
+
+#include "PeopleCounter.h"
+#include "Tracker.h"
+#include "TrackerConfig.h"
+#include "Centroid.h"
+#include "Kalman.h"
+#include "StateCentroid.h"
+#include "IoU.h"
+#include "FixedStateCentroid.h"
+#include "BoxStream.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Spinnaker;
+
+using std::string;
+using std::vector;
+using std::thread;
+using std::atomic;
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+struct SweepParam {
+    const char* name;
+    void (*set)(TrackerConfig& cfg, double val);
+    vector<double> values;
+};
+
+// A configuration to run, and the value of each parameter it was made from
+struct SweepConfig {
+    TrackerConfig cfg;
+    vector<double> values;
+};
+
+struct SweepResult {
+    vector<double> values;
+    int countError;
+    int inError;
+    int outError;
+    double nsPerFrame;
+};
+
+static vector<SweepParam> DefaultParams(const string& tracker) {
+    vector<SweepParam> params;
+
+    params.push_back({ "MISSING_THRESH", [](TrackerConfig& c, double v) { c.missingThresh = (int)v; }, { 2, 3, 5, 8 } });
+    params.push_back({ "CONFIDENCE_THRESH", [](TrackerConfig& c, double v) { c.confidenceThresh = v; }, { 0.6, 0.7, 0.8 } });
+
+    if (tracker == "centroid") {
+        params.push_back({ "DIST_TOLERANCE", [](TrackerConfig& c, double v) { c.distTolerance = v; }, { 100, 200, 300, 400 } });
+    }
+    else if (tracker == "kalman") {
+        params.push_back({ "DIST_THRESH", [](TrackerConfig& c, double v) { c.distThresh = v; }, { 100, 200, 300, 400 } });
+    }
+    else if (tracker == "iou") {
+        params.push_back({ "IOU_THRESH", [](TrackerConfig& c, double v) { c.iouThresh = v; }, { 0.1, 0.2, 0.3, 0.4, 0.5 } });
+    }
+    else {
+        params.push_back({ "DIST_X_THRESH", [](TrackerConfig& c, double v) { c.distXThresh = v; }, { 100, 200, 300 } });
+        params.push_back({ "DIST_Y_THRESH", [](TrackerConfig& c, double v) { c.distYThresh = v; }, { 10, 20, 40 } });
+        params.push_back({ "VEL_X_THRESH", [](TrackerConfig& c, double v) { c.velXThresh = v; }, { 1, 2, 4 } });
+        params.push_back({ "BOX_SIZE_THRESH", [](TrackerConfig& c, double v) { c.boxSizeThresh = v; }, { 50, 100, 200 } });
+    }
+
+    return params;
+}
+
+/*
+ * Replaces the values of a parameter from a NAME=v1,v2,... argument.
+ */
+static int ParseParam(vector<SweepParam>& params, const char* arg) {
+    const char* eq = strchr(arg, '=');
+    if (eq == NULL)
+        return -1;
+
+    string name(arg, eq - arg);
+    for (auto it = params.begin(); it != params.end(); ++it) {
+        if (name == it->name) {
+            it->values.clear();
+            // Every value must be a number, so empty ones are rejected too
+            for (const char* p = eq + 1; ; ) {
+                char* end;
+                double v = strtod(p, &end);
+                if (end == p || (*end != ',' && *end != '\0'))
+                    return -1;
+                it->values.push_back(v);
+                if (*end == '\0')
+                    return 0;
+                p = end + 1;
+            }
+        }
+    }
+
+    printf("Unknown parameter %s for this tracker.\n", name.c_str());
+    return -1;
+}
+
+/*
+ * Every combination of the parameter values.
+ */
+static vector<SweepConfig> MakeConfigs(const vector<SweepParam>& params) {
+    vector<SweepConfig> configs(1);
+
+    for (auto p = params.begin(); p != params.end(); ++p) {
+        vector<SweepConfig> next;
+        for (auto cfg = configs.begin(); cfg != configs.end(); ++cfg) {
+            for (auto v = p->values.begin(); v != p->values.end(); ++v) {
+                SweepConfig c = *cfg;
+                p->set(c.cfg, *v);
+                c.values.push_back(*v);
+                next.push_back(c);
+            }
+        }
+        configs.swap(next);
+    }
+
+    return configs;
+}
+
+template <class T>
+static SweepResult RunConfig(const BoxStream& stream, const SweepConfig& config,
+                             int expectedCount, int expectedIn, int expectedOut) {
+    const TrackerConfig& cfg = config.cfg;
+    PeopleCounter<T>* cntr = new PeopleCounter<T>((BoxSource*)NULL);
+    cntr->SetTrackerConfig(cfg);
+
+    vector<InferenceBoundingBox> boxes;
+    int numFrames = stream.GetNumFrames();
+
+    steady_clock::time_point start = steady_clock::now();
+    for (int f = 0; f < numFrames; f++) {
+        stream.GetFrame(f, boxes, NULL);
+        cntr->ProcessFrame(boxes);
+    }
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count();
+
+    // Let the last people leave
+    boxes.clear();
+    for (int f = 0; f <= cfg.missingThresh; f++)
+        cntr->ProcessFrame(boxes);
+
+    SweepResult res;
+    res.values = config.values;
+    res.countError = abs(cntr->GetPeopleCount() - expectedCount);
+    res.inError = abs(cntr->GetPeopleIn() - expectedIn);
+    res.outError = abs(cntr->GetPeopleOut() - expectedOut);
+    res.nsPerFrame = ns / ((numFrames > 0) ? numFrames : 1);
+
+    delete cntr;
+    return res;
+}
+
+template <class T>
+static void RunSweep(const uint8_t* data, size_t size, const vector<SweepConfig>& configs,
+                     vector<SweepResult>& results, int numThreads) {
+    BoxStream stream;
+    if (stream.Attach(data, size))
+        return;
+
+    // Ground truth, counted the same way as the PeopleCounter does
+    vector<StreamCrossing> crossings;
+    for (int i = 0; i < stream.GetNumCrossings(); i++)
+        crossings.push_back(stream.GetCrossing(i));
+    std::sort(crossings.begin(), crossings.end(), [](const StreamCrossing& a, const StreamCrossing& b) {
+        return a.tMs < b.tMs;
+    });
+
+    int expectedCount = 0;
+    int expectedIn = 0;
+    int expectedOut = 0;
+    for (auto it = crossings.begin(); it != crossings.end(); ++it) {
+        if (it->dir == LEFT) {
+            expectedIn++;
+            expectedCount++;
+        }
+        else {
+            expectedOut++;
+            if (expectedCount != 0)
+                expectedCount--;
+        }
+    }
+
+    results.resize(configs.size());
+    atomic<size_t> next(0);
+    vector<thread> workers;
+
+    for (int i = 0; i < numThreads; i++) {
+        workers.push_back(thread([&]() {
+            // Each worker has its own view of the shared mapping
+            BoxStream view;
+            view.Attach(data, size);
+
+            for (size_t c = next++; c < configs.size(); c = next++)
+                results[c] = RunConfig<T>(view, configs[c], expectedCount, expectedIn, expectedOut);
+        }));
+    }
+
+    for (auto it = workers.begin(); it != workers.end(); ++it)
+        it->join();
+}
+
+static void PrintConfig(FILE* f, const vector<double>& values, const char* sep) {
+    for (auto v = values.begin(); v != values.end(); ++v)
+        fprintf(f, "%s%g", sep, *v);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("Usage: sweep stream.hkbx [--tracker centroid|state|fixed|kalman|iou] [--param NAME=v1,v2,...]\n"
+               "             [--threads N] [--top N] [--csv results.csv]\n");
+        return -1;
+    }
+
+    const char* path = argv[1];
+    string tracker = "state";
+    const char* csvPath = "sweep_results.csv";
+    int numThreads = (int)thread::hardware_concurrency();
+    int top = 20;
+    vector<const char*> paramArgs;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--tracker") == 0 && i + 1 < argc)
+            tracker = argv[++i];
+        else if (strcmp(argv[i], "--param") == 0 && i + 1 < argc)
+            paramArgs.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            numThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc)
+            top = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csvPath = argv[++i];
+        else {
+            printf("Unknown argument %s.\n", argv[i]);
+            return -1;
+        }
+    }
+
+    vector<SweepParam> params = DefaultParams(tracker);
+    for (auto it = paramArgs.begin(); it != paramArgs.end(); ++it) {
+        if (ParseParam(params, *it)) {
+            printf("Invalid parameter %s.\n", *it);
+            return -1;
+        }
+    }
+
+    if (numThreads < 1)
+        numThreads = 1;
+
+    MappedFile file;
+    if (file.Open(path))
+        return -1;
+
+    vector<SweepConfig> configs = MakeConfigs(params);
+    vector<SweepResult> results;
+    printf("Running %d configurations of %s on %d threads.\n", (int)configs.size(), tracker.c_str(), numThreads);
+
+    steady_clock::time_point start = steady_clock::now();
+    if (tracker == "centroid")
+        RunSweep<Centroid>(file.GetData(), file.GetSize(), configs, results, numThreads);
+    else if (tracker == "kalman")
+        RunSweep<Kalman>(file.GetData(), file.GetSize(), configs, results, numThreads);
+    else if (tracker == "iou")
+        RunSweep<IoU>(file.GetData(), file.GetSize(), configs, results, numThreads);
+    else if (tracker == "fixed")
+        RunSweep<FixedStateCentroid>(file.GetData(), file.GetSize(), configs, results, numThreads);
+    else
+        RunSweep<StateCentroid>(file.GetData(), file.GetSize(), configs, results, numThreads);
+    double secs = duration<double>(steady_clock::now() - start).count();
+
+    if (results.empty())
+        return -1;
+
+    // Rank by in + out error, then by net count error, then by cost
+    std::sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        int errA = a.inError + a.outError;
+        int errB = b.inError + b.outError;
+        if (errA != errB)
+            return errA < errB;
+        if (a.countError != b.countError)
+            return a.countError < b.countError;
+        return a.nsPerFrame < b.nsPerFrame;
+    });
+
+    printf("Finished in %.1f s.\n\n", secs);
+    printf("%4s %6s %6s %6s %10s  ", "rank", "in", "out", "count", "ns/frame");
+    for (auto p = params.begin(); p != params.end(); ++p)
+        printf(" %s", p->name);
+    printf("\n");
+
+    for (int i = 0; i < (int)results.size() && i < top; i++) {
+        printf("%4d %6d %6d %6d %10.0f  ", i + 1, results[i].inError, results[i].outError,
+               results[i].countError, results[i].nsPerFrame);
+        PrintConfig(stdout, results[i].values, " ");
+        printf("\n");
+    }
+
+    FILE* csv = fopen(csvPath, "w");
+    if (csv != NULL) {
+        fprintf(csv, "rank,in_error,out_error,count_error,ns_per_frame");
+        for (auto p = params.begin(); p != params.end(); ++p)
+            fprintf(csv, ",%s", p->name);
+        fprintf(csv, "\n");
+
+        for (size_t i = 0; i < results.size(); i++) {
+            fprintf(csv, "%d,%d,%d,%d,%.1f", (int)i + 1, results[i].inError, results[i].outError,
+                    results[i].countError, results[i].nsPerFrame);
+            PrintConfig(csv, results[i].values, ",");
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    }
+
+    return 0;
+}